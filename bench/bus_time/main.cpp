@@ -0,0 +1,254 @@
+/// @file main.cpp
+/// @brief Native bus-time benchmark: every public Driver API against the
+///        simulated device on a virtual microsecond clock.
+///
+/// Build and run with `pio run -e native_bench -t exec`. Prints one row per
+/// operation and speed mode and exits non-zero when an operation fails, the
+/// host violates bit timing, or a bus-time budget is exceeded.
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+
+#include "AT21CS/AT21CS.h"
+#include "AT21CS/Batch.h"
+#include "At21Sim.h"
+
+using AT21CS::Config;
+using AT21CS::CriticalSection;
+using AT21CS::Driver;
+using AT21CS::SpeedMode;
+using AT21CS::Status;
+
+namespace {
+
+struct Mode {
+  const char* name;
+  SpeedMode speed;
+  bool session;
+  CriticalSection critical;
+};
+
+/// Bus-time budgets in microseconds for High-Speed, per-byte masking, no session.
+/// Write budgets include the simulated 3 ms t_WR.
+struct Budget {
+  const char* op;
+  uint32_t maxUs;
+};
+
+static constexpr Budget HIGH_SPEED_BUDGETS[] = {
+    {"resetAndDiscover", 330},
+    {"readCurrentAddress", 880},
+    {"readEeprom(1)", 1260},
+    {"readEeprom(8)", 2050},
+    {"readEeprom(32)", 4780},
+    {"readEeprom(128)", 15700},
+    {"writeEepromPage(8)", 5420},
+    {"writeEeprom(32)", 26200},
+    {"readSecurity(32)", 4780},
+    {"readManufacturerId", 1100},
+    {"waitReady", 430},
+    {"boot(runBatch)", 21800},
+};
+
+using OpFn = Status (*)(Driver& dev);
+
+struct Op {
+  const char* name;
+  OpFn run;
+};
+
+uint8_t gBuf[128];
+
+Status opProbe(Driver& dev) { return dev.probe(); }
+Status opReset(Driver& dev) { return dev.resetAndDiscover(); }
+Status opIsPresent(Driver& dev) {
+  bool present = false;
+  return dev.isPresent(present);
+}
+Status opReadCurrent(Driver& dev) {
+  uint8_t value = 0;
+  return dev.readCurrentAddress(value);
+}
+Status opRead1(Driver& dev) { return dev.readEeprom(0x00, gBuf, 1); }
+Status opRead8(Driver& dev) { return dev.readEeprom(0x00, gBuf, 8); }
+Status opRead32(Driver& dev) { return dev.readEeprom(0x00, gBuf, 32); }
+Status opRead128(Driver& dev) { return dev.readEeprom(0x00, gBuf, 128); }
+void sinkByte(uint8_t value, size_t index, void* user) {
+  static_cast<uint8_t*>(user)[index] = value;
+}
+Status opReadStream32(Driver& dev) { return dev.readEepromStream(0x00, 32, sinkByte, gBuf); }
+Status opWriteByte(Driver& dev) { return dev.writeEepromByte(0x7F, 0x5A); }
+Status opWritePage(Driver& dev) { return dev.writeEepromPage(0x40, gBuf, 8); }
+Status opWrite32(Driver& dev) { return dev.writeEeprom(0x44, gBuf, 32); }
+Status opWrite8Verified(Driver& dev) { return dev.writeEepromVerified(0x40, gBuf, 8); }
+Status opReadSecurity(Driver& dev) { return dev.readSecurity(0x00, gBuf, 32); }
+Status opWriteSecurity(Driver& dev) { return dev.writeSecurityUserPage(0x10, gBuf, 8); }
+Status opSerial(Driver& dev) {
+  AT21CS::SerialNumberInfo serial;
+  return dev.readSerialNumber(serial);
+}
+Status opMfgId(Driver& dev) {
+  uint32_t id = 0;
+  return dev.readManufacturerId(id);
+}
+Status opDetect(Driver& dev) {
+  AT21CS::PartType part = AT21CS::PartType::UNKNOWN;
+  return dev.detectPart(part);
+}
+Status opZone(Driver& dev) {
+  bool rom = false;
+  return dev.isZoneRom(0, rom);
+}
+Status opLocked(Driver& dev) {
+  bool locked = false;
+  return dev.isSecurityLocked(locked);
+}
+Status opFrozen(Driver& dev) {
+  bool frozen = false;
+  return dev.areRomZonesFrozen(frozen);
+}
+Status opIsHigh(Driver& dev) {
+  bool enabled = false;
+  return dev.isHighSpeed(enabled);
+}
+Status opWaitReady(Driver& dev) { return dev.waitReady(10); }
+
+// Load-cell boot sequence: IDs, identity, calibration master/mirror, runtime, counters.
+Status opBootSeparate(Driver& dev) {
+  uint32_t id = 0;
+  AT21CS::SerialNumberInfo serial;
+  Status st = dev.readManufacturerId(id);
+  if (st.ok()) st = dev.readSerialNumber(serial);
+  if (st.ok()) st = dev.readSecurity(0x10, gBuf, 16);
+  for (uint8_t zone = 0; zone < 4 && st.ok(); ++zone) {
+    st = dev.readEeprom(static_cast<uint8_t>(zone * 32U), gBuf, 32);
+  }
+  return st;
+}
+Status opBootBatch(Driver& dev) {
+  uint32_t id = 0;
+  AT21CS::SerialNumberInfo serial;
+  AT21CS::Batch batch;
+  (void)batch.readManufacturerId(id);
+  (void)batch.readSerialNumber(serial);
+  (void)batch.readSecurity(0x10, gBuf, 16);
+  for (uint8_t zone = 0; zone < 4; ++zone) {
+    (void)batch.readEeprom(static_cast<uint8_t>(zone * 32U), gBuf + zone * 32U, 32);
+  }
+  return dev.runBatch(batch);
+}
+
+static constexpr Op OPS[] = {
+    {"probe", opProbe},
+    {"resetAndDiscover", opReset},
+    {"isPresent", opIsPresent},
+    {"readCurrentAddress", opReadCurrent},
+    {"readEeprom(1)", opRead1},
+    {"readEeprom(8)", opRead8},
+    {"readEeprom(32)", opRead32},
+    {"readEeprom(128)", opRead128},
+    {"readEepromStream(32)", opReadStream32},
+    {"writeEepromByte", opWriteByte},
+    {"writeEepromPage(8)", opWritePage},
+    {"writeEeprom(32)", opWrite32},
+    {"writeEepromVerified(8)", opWrite8Verified},
+    {"readSecurity(32)", opReadSecurity},
+    {"writeSecurityUserPage(8)", opWriteSecurity},
+    {"readSerialNumber", opSerial},
+    {"readManufacturerId", opMfgId},
+    {"detectPart", opDetect},
+    {"isZoneRom", opZone},
+    {"isSecurityLocked", opLocked},
+    {"areRomZonesFrozen", opFrozen},
+    {"isHighSpeed", opIsHigh},
+    {"waitReady", opWaitReady},
+    {"boot(7 calls)", opBootSeparate},
+    {"boot(runBatch)", opBootBatch},
+};
+
+static constexpr Mode MODES[] = {
+    {"HS", SpeedMode::HIGH_SPEED, false, CriticalSection::PER_BYTE},
+    {"STD", SpeedMode::STANDARD_SPEED, false, CriticalSection::PER_BYTE},
+    {"HS+session", SpeedMode::HIGH_SPEED, true, CriticalSection::PER_BYTE},
+    {"HS/bit", SpeedMode::HIGH_SPEED, false, CriticalSection::PER_BIT},
+    {"HS/txn", SpeedMode::HIGH_SPEED, false, CriticalSection::PER_TRANSACTION},
+};
+
+uint32_t budgetFor(const Mode& mode, const char* op) {
+  if (mode.speed != SpeedMode::HIGH_SPEED || mode.session ||
+      mode.critical != CriticalSection::PER_BYTE) {
+    return 0;
+  }
+  for (const Budget& budget : HIGH_SPEED_BUDGETS) {
+    if (std::strcmp(budget.op, op) == 0) {
+      return budget.maxUs;
+    }
+  }
+  return 0;
+}
+
+int runMode(const Mode& mode) {
+  at21sim::Device sim;
+  Config cfg;
+  cfg.startupSpeed = mode.speed;
+  cfg.persistentSession = mode.session;
+  cfg.sessionIdleTimeoutMs = 0;
+  cfg.criticalSection = mode.critical;
+  sim.attach(cfg);
+
+  Driver dev;
+  Status st = dev.begin(cfg);
+  if (!st.ok()) {
+    std::printf("%-10s begin failed: %s\n", mode.name, st.msg);
+    return 1;
+  }
+
+  int failures = 0;
+  for (const Op& op : OPS) {
+    const uint64_t startUs = sim.nowUs();
+    const at21sim::Stats before = sim.stats;
+    dev.resetMaskingStats();
+    st = op.run(dev);
+    const AT21CS::MaskingStats masking = dev.getSettings().masking;
+    const uint32_t busUs = static_cast<uint32_t>(sim.nowUs() - startUs);
+    const at21sim::Stats& after = sim.stats;
+
+    const uint32_t budget = budgetFor(mode, op.name);
+    const bool overBudget = budget != 0U && busUs > budget;
+    const char* verdict = !st.ok() ? "FAIL" : (overBudget ? "OVER" : "ok");
+    if (!st.ok() || overBudget) {
+      ++failures;
+    }
+
+    std::printf("%-10s %-26s %8" PRIu32 " %6" PRIu32 " %6" PRIu32 " %6" PRIu32 " %6" PRIu32
+                " %6" PRIu32 " %8" PRIu32 " %8" PRIu32 " %8" PRIu32 "  %s\n",
+                mode.name, op.name, busUs, after.frames - before.frames,
+                after.resets - before.resets, after.bytesIn - before.bytesIn,
+                after.bytesOut - before.bytesOut, after.writeCycles - before.writeCycles,
+                masking.totalUs, masking.peakWindowUs, budget, verdict);
+  }
+
+  if (sim.stats.timingViolations != 0U) {
+    std::printf("%-10s host timing violations: %" PRIu32 "\n", mode.name,
+                sim.stats.timingViolations);
+    ++failures;
+  }
+  return failures;
+}
+
+}  // namespace
+
+int main() {
+  std::printf("%-10s %-26s %8s %6s %6s %6s %6s %6s %8s %8s %8s  %s\n", "mode", "operation",
+              "bus_us", "frames", "resets", "b_in", "b_out", "t_wr", "mask_us", "mask_max",
+              "budget", "result");
+
+  int failures = 0;
+  for (const Mode& mode : MODES) {
+    failures += runMode(mode);
+  }
+
+  std::printf("bus_time: %d failure(s)\n", failures);
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,147 @@
+/// @file main.cpp
+/// @brief Native CRC micro-benchmark: bit-serial vs table-driven engines.
+///
+/// Build and run with `pio run -e native_bench_crc -t exec`. Prints host
+/// throughput per engine and buffer size, and exits non-zero when any engine
+/// disagrees with the bit-serial reference or a known check value.
+
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+
+#include "AT21CS/Crc.h"
+
+namespace crc = AT21CS::crc;
+
+namespace {
+
+// Bytes hashed per engine and buffer size; large enough to swamp timer noise.
+static constexpr size_t BYTES_PER_ROW = 1U << 21U;
+static constexpr size_t BUFFER_SIZES[] = {8, 32, 128, 4096};
+
+uint8_t gData[4096];
+volatile uint32_t gSink = 0;
+
+uint8_t crc8_31Bitwise(uint8_t crc, const uint8_t* data, size_t len) {
+  for (size_t i = 0; i < len; ++i) {
+    crc ^= data[i];
+    for (uint8_t bit = 0; bit < 8U; ++bit) {
+      crc = ((crc & 0x01U) != 0U) ? static_cast<uint8_t>((crc >> 1U) ^ 0x8CU)
+                                  : static_cast<uint8_t>(crc >> 1U);
+    }
+  }
+  return crc;
+}
+
+uint16_t crc16CcittBitwise(uint16_t crc, const uint8_t* data, size_t len) {
+  for (size_t i = 0; i < len; ++i) {
+    crc ^= static_cast<uint16_t>(data[i] << 8U);
+    for (uint8_t bit = 0; bit < 8U; ++bit) {
+      crc = ((crc & 0x8000U) != 0U) ? static_cast<uint16_t>((crc << 1U) ^ 0x1021U)
+                                    : static_cast<uint16_t>(crc << 1U);
+    }
+  }
+  return crc;
+}
+
+uint32_t crc8Bitwise(const uint8_t* d, size_t n) { return crc8_31Bitwise(0, d, n); }
+uint32_t crc8Table(const uint8_t* d, size_t n) { return crc::crc8_31(d, n); }
+uint32_t crc16Bitwise(const uint8_t* d, size_t n) { return crc16CcittBitwise(0xFFFF, d, n); }
+uint32_t crc16Table(const uint8_t* d, size_t n) { return crc::crc16Ccitt(d, n); }
+uint32_t crc32Bitwise(const uint8_t* d, size_t n) {
+  return crc::crc32Final(crc::crc32UpdateBitwise(crc::CRC32_INIT, d, n));
+}
+uint32_t crc32Bytewise(const uint8_t* d, size_t n) {
+  return crc::crc32Final(crc::crc32UpdateBytewise(crc::CRC32_INIT, d, n));
+}
+uint32_t crc32Slice4(const uint8_t* d, size_t n) {
+  return crc::crc32Final(crc::crc32UpdateSlice4(crc::CRC32_INIT, d, n));
+}
+
+using CrcFn = uint32_t (*)(const uint8_t* data, size_t len);
+
+struct Engine {
+  const char* name;
+  CrcFn run;
+  CrcFn reference;
+};
+
+static constexpr Engine ENGINES[] = {
+    {"crc8_31/bitwise", crc8Bitwise, crc8Bitwise},
+    {"crc8_31/table", crc8Table, crc8Bitwise},
+    {"crc16/bitwise", crc16Bitwise, crc16Bitwise},
+    {"crc16/table", crc16Table, crc16Bitwise},
+    {"crc32/bitwise", crc32Bitwise, crc32Bitwise},
+    {"crc32/bytewise", crc32Bytewise, crc32Bitwise},
+    {"crc32/slice4", crc32Slice4, crc32Bitwise},
+};
+
+int checkKnownVectors() {
+  static const uint8_t check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+  int failures = 0;
+  if (crc::crc32(check, sizeof(check)) != 0xCBF43926u) {
+    std::printf("FAIL crc32 check value\n");
+    ++failures;
+  }
+  if (crc::crc16Ccitt(check, sizeof(check)) != 0x29B1U) {
+    std::printf("FAIL crc16 check value\n");
+    ++failures;
+  }
+  if (crc::crc8_31(check, sizeof(check)) != 0xA1U) {
+    std::printf("FAIL crc8_31 check value\n");
+    ++failures;
+  }
+
+  // Split updates must match a single pass at every split point.
+  for (size_t split = 0; split <= sizeof(gData); split += 509U) {
+    uint32_t state = crc::crc32Update(crc::CRC32_INIT, gData, split);
+    state = crc::crc32Update(state, gData + split, sizeof(gData) - split);
+    if (crc::crc32Final(state) != crc32Bitwise(gData, sizeof(gData))) {
+      std::printf("FAIL crc32 incremental split=%zu\n", split);
+      ++failures;
+    }
+  }
+  return failures;
+}
+
+}  // namespace
+
+int main() {
+  uint32_t seed = 0x12345678u;
+  for (uint8_t& b : gData) {
+    seed = seed * 1664525u + 1013904223u;
+    b = static_cast<uint8_t>(seed >> 24U);
+  }
+
+  int failures = checkKnownVectors();
+
+  std::printf("%-16s %6s %10s %10s\n", "engine", "len", "ns/byte", "MB/s");
+  for (const Engine& engine : ENGINES) {
+    for (const size_t len : BUFFER_SIZES) {
+      // Unaligned start exercises the byte-composed slice loads.
+      const uint8_t* data = gData + ((len < sizeof(gData)) ? 1U : 0U);
+      if (engine.run(data, len) != engine.reference(data, len)) {
+        std::printf("FAIL %s len=%zu mismatch\n", engine.name, len);
+        ++failures;
+        continue;
+      }
+
+      const size_t iterations = BYTES_PER_ROW / len;
+      uint32_t acc = 0;
+      const auto start = std::chrono::steady_clock::now();
+      for (size_t i = 0; i < iterations; ++i) {
+        acc ^= engine.run(data, len);
+      }
+      const auto stop = std::chrono::steady_clock::now();
+      gSink = gSink ^ acc;
+
+      const double ns = std::chrono::duration<double, std::nano>(stop - start).count();
+      const double bytes = static_cast<double>(iterations * len);
+      std::printf("%-16s %6zu %10.2f %10.1f\n", engine.name, len, ns / bytes,
+                  bytes * 1000.0 / ns);
+    }
+  }
+
+  std::printf("%s: %d failure(s)\n", failures == 0 ? "PASS" : "FAIL", failures);
+  return failures == 0 ? 0 : 1;
+}
@@ -10,6 +10,7 @@
 #endif
 
 #include "AT21CS/AT21CS.h"
+#include "AT21CS/Crc.h"
 #include "../common/At21Example.h"
 #include "../common/BusDiag.h"
 #include "../common/BoardConfig.h"
@@ -95,23 +96,6 @@ void printEscapedByte(uint8_t value) {
   }
 }
 
-// ---------------------------------------------------------------------------
-// CRC-32 (IEEE 802.3) over a memory region
-// ---------------------------------------------------------------------------
-uint32_t crc32Update(uint32_t crc, const uint8_t* data, size_t len) {
-  for (size_t i = 0; i < len; ++i) {
-    crc ^= static_cast<uint32_t>(data[i]);
-    for (uint8_t bit = 0; bit < 8U; ++bit) {
-      if ((crc & 1U) != 0U) {
-        crc = (crc >> 1) ^ 0xEDB88320UL;
-      } else {
-        crc >>= 1;
-      }
-    }
-  }
-  return crc;
-}
-
 // ---------------------------------------------------------------------------
 // Stress stats (MB85RC-style summary block)
 // ---------------------------------------------------------------------------
@@ -170,7 +154,7 @@ void finishStressStats() {
 }
 
 // ---------------------------------------------------------------------------
-// Write-verify stress (write byte -> waitReady -> read back -> compare)
+// Write-verify stress (writeEepromVerified: write -> t_WR poll -> read back -> compare)
 // ---------------------------------------------------------------------------
 void runWriteVerifyStress(int count) {
   resetStressStats(count);
@@ -182,42 +166,14 @@ void runWriteVerifyStress(int count) {
     const uint8_t addr = static_cast<uint8_t>(i % AT21CS::cmd::EEPROM_SIZE);
     const uint8_t pattern = static_cast<uint8_t>(i & 0xFF);
 
-    AT21CS::Status st = gDevice.writeEepromByte(addr, pattern);
+    // Write, t_WR poll, and read-back compare under one activation.
+    const AT21CS::Status st = gDevice.writeEepromVerified(addr, &pattern, 1);
     if (!st.ok()) {
       gStressStats.errors++;
       gStressStats.lastError = st;
       if (gVerbose) {
-        Serial.printf("  [%d] write 0x%02X@0x%02X failed: %s\n", i, pattern, addr, ex::errToStr(st.code));
-      }
-      continue;
-    }
-
-    st = gDevice.waitReady(10);
-    if (!st.ok()) {
-      gStressStats.errors++;
-      gStressStats.lastError = st;
-      if (gVerbose) {
-        Serial.printf("  [%d] waitReady failed: %s\n", i, ex::errToStr(st.code));
-      }
-      continue;
-    }
-
-    uint8_t readBack = 0;
-    st = gDevice.readEeprom(addr, &readBack, 1);
-    if (!st.ok()) {
-      gStressStats.errors++;
-      gStressStats.lastError = st;
-      if (gVerbose) {
-        Serial.printf("  [%d] read 0x%02X failed: %s\n", i, addr, ex::errToStr(st.code));
-      }
-      continue;
-    }
-
-    if (readBack != pattern) {
-      gStressStats.errors++;
-      gStressStats.lastError = AT21CS::Status::Error(AT21CS::Err::IO_ERROR, "data mismatch");
-      if (gVerbose) {
-        Serial.printf("  [%d] mismatch @ 0x%02X: wrote 0x%02X read 0x%02X\n", i, addr, pattern, readBack);
+        Serial.printf("  [%d] write-verify 0x%02X@0x%02X failed: %s\n", i, pattern, addr,
+                      ex::errToStr(st.code));
       }
       continue;
     }
@@ -352,6 +308,43 @@ void runSpeedTest(int iterations) {
   }
 }
 
+// ---------------------------------------------------------------------------
+// Timing scan - per-board pass windows and a suggested profile
+// ---------------------------------------------------------------------------
+void printWindow(const char* name, const AT21CS::TimingWindow& window, uint32_t chosenNs) {
+  Serial.printf("  %-11s pass %6lu..%6lu ns  chosen %6lu ns\n", name,
+                static_cast<unsigned long>(window.minNs), static_cast<unsigned long>(window.maxNs),
+                static_cast<unsigned long>(chosenNs));
+}
+
+void runTimingScan(const AT21CS::TimingScanConfig& scan) {
+  Serial.printf("=== Timing Scan (step=%lu ns, margin=%lu ns, speed=%s) ===\n",
+                static_cast<unsigned long>(scan.stepNs), static_cast<unsigned long>(scan.marginNs),
+                ex::speedToStr(gDevice.speedMode()));
+  AT21CS::TimingScanResult result;
+  const uint32_t startMs = millis();
+  const AT21CS::Status st = gDevice.characterizeTiming(result, scan);
+  Serial.printf("candidates=%lu elapsed=%lu ms\n", static_cast<unsigned long>(result.candidates),
+                static_cast<unsigned long>(millis() - startMs));
+  printWindow("t_BIT", result.bit, result.profile.bitNs);
+  printWindow("t_LOW0", result.low0, result.profile.low0Ns);
+  printWindow("t_LOW1", result.low1, result.profile.low1Ns);
+  printWindow("t_RD", result.readLow, result.profile.readLowNs);
+  printWindow("sample", result.readSample, result.profile.readSampleNs);
+  ex::printStatus(st);
+  if (!st.ok()) {
+    return;
+  }
+  Serial.println("Suggested profile (BoardConfig.h):");
+  Serial.printf("  {%lu, %lu, %lu, %lu, %lu, %lu}\n",
+                static_cast<unsigned long>(result.profile.bitNs),
+                static_cast<unsigned long>(result.profile.low0Ns),
+                static_cast<unsigned long>(result.profile.low1Ns),
+                static_cast<unsigned long>(result.profile.readLowNs),
+                static_cast<unsigned long>(result.profile.readSampleNs),
+                static_cast<unsigned long>(result.profile.htssNs));
+}
+
 const char* sourceToStr(lcmap::CalibrationSource source) {
   switch (source) {
     case lcmap::CalibrationSource::MASTER:
@@ -371,17 +364,19 @@ void printLoadCellLayout() {
                 static_cast<unsigned>(sizeof(lcmap::CalibrationBlockV1)));
   Serial.printf("  Calibration mirror: addr=0x%02X size=%u\n", lcmap::CALIBRATION_MIRROR_ADDR,
                 static_cast<unsigned>(sizeof(lcmap::CalibrationBlockV1)));
-  Serial.printf("  Runtime block:      addr=0x%02X size=%u\n", lcmap::RUNTIME_ADDR,
-                static_cast<unsigned>(sizeof(lcmap::RuntimeBlockV1)));
-  Serial.printf("  Counter block:      addr=0x%02X size=%u\n", lcmap::COUNTERS_ADDR,
-                static_cast<unsigned>(sizeof(lcmap::CounterBlockV1)));
+  Serial.printf("  Runtime A/B slots:  addr=0x%02X size=%u (%u x %u-byte slots)\n",
+                lcmap::RUNTIME_SLOTS_ADDR, static_cast<unsigned>(lcmap::ZONE_SIZE),
+                static_cast<unsigned>(lcmap::SLOT_COUNT),
+                static_cast<unsigned>(lcmap::SLOT_SIZE));
+  Serial.printf("  Counter log:        addr=0x%02X size=%u (%u x %u-byte entries)\n",
+                lcmap::COUNTER_LOG_ADDR, static_cast<unsigned>(lcmap::ZONE_SIZE),
+                static_cast<unsigned>(lcmap::COUNTER_LOG_SLOTS),
+                static_cast<unsigned>(lcmap::COUNTER_LOG_ENTRY_SIZE));
 
   Serial.println("Key field addresses:");
   Serial.printf("  capacityGrams      @ 0x%02X\n", lcmap::field::CAPACITY_GRAMS);
   Serial.printf("  zeroBalanceRaw     @ 0x%02X\n", lcmap::field::ZERO_BALANCE_RAW);
   Serial.printf("  spanRawAtCapacity  @ 0x%02X\n", lcmap::field::SPAN_RAW_AT_CAPACITY);
-  Serial.printf("  installTareRaw     @ 0x%02X\n", lcmap::field::INSTALL_TARE_RAW);
-  Serial.printf("  overloadCount      @ 0x%02X\n", lcmap::field::OVERLOAD_COUNT);
 }
 
 void printLoadCellRecords() {
@@ -459,7 +454,8 @@ void writeLoadCellDemoData() {
   runtime.userSpanTrimPpm = 0;
   runtime.filterProfile = 2;
   runtime.diagnosticsMode = 0;
-  ex::printStatus(lcmap::writeRuntime(gDevice, runtime));
+  lcmap::RuntimeSlotState runtimeSlots;
+  ex::printStatus(lcmap::writeRuntimeSlot(gDevice, runtime, runtimeSlots));
 
   lcmap::CounterBlockV1 counters = {};
   counters.flags = 0x0001;
@@ -468,7 +464,8 @@ void writeLoadCellDemoData() {
   counters.overTempCount = 0;
   counters.powerCycleCount = 1;
   counters.saturationCount = 0;
-  ex::printStatus(lcmap::writeCounters(gDevice, counters));
+  lcmap::CounterLogState counterLog;
+  ex::printStatus(lcmap::appendCounters(gDevice, counters, counterLog));
 }
 
 void runStressMix(int count) {
@@ -808,6 +805,7 @@ void printHelp() {
   helpItem("e_text <addr> <len>", "EEPROM escaped text view");
   helpItem("e_write <addr> <value>", "EEPROM byte write");
   helpItem("e_page <addr> <v0> [..v7]", "EEPROM page write (up to 8 bytes)");
+  helpItem("e_async <addr> <v0> [..v15]", "Non-blocking write driven by tick()");
   helpItem("e_fill <addr> <value> <len>", "Fill EEPROM region with a byte");
   helpItem("e_verify <addr> <v0> [..vN]", "Verify EEPROM matches expected bytes");
   helpItem("e_crc <addr> <len>", "CRC-32 over EEPROM region");
@@ -831,6 +829,7 @@ void printHelp() {
   helpItem("stress_mix [N]", "Mixed safe operations (read-only)");
   helpItem("stress_rw [N]", "Write-verify stress (write+read+compare)");
   helpItem("speed [N]", "Per-operation speed test (min/max/avg µs)");
+  helpItem("timing_scan [step_ns] [margin_ns]", "Sweep bit timing, suggest a board profile");
 
   helpSection("Load Cell Map");
   helpItem("lc_layout", "Print full load-cell map layout");
@@ -863,6 +862,7 @@ void setup() {
   cfg.sioPin = board::SIO_PRIMARY;
   cfg.presencePin = board::PRESENCE_PRIMARY;
   cfg.addressBits = board::ADDRESS_BITS_PRIMARY;
+  cfg.highSpeedTiming = board::HIGH_SPEED_TIMING_PRIMARY;
 
   const AT21CS::Status st = gDevice.begin(cfg);
   ex::printStatus(st);
@@ -895,6 +895,7 @@ void loop() {
     cfg.sioPin = board::SIO_PRIMARY;
     cfg.presencePin = board::PRESENCE_PRIMARY;
     cfg.addressBits = board::ADDRESS_BITS_PRIMARY;
+    cfg.highSpeedTiming = board::HIGH_SPEED_TIMING_PRIMARY;
     if (argc >= 2) {
       cfg.addressBits = static_cast<uint8_t>(tokens[1].toInt() & 0x07);
     }
@@ -946,6 +947,26 @@ void loop() {
                   ex::partToStr(snap.detectedPart),
                   ex::speedToStr(snap.speedMode),
                   onOffColor(gVerbose), gVerbose ? "true" : "false", LOG_COLOR_RESET);
+    Serial.printf("persistentSession=%s sessionActive=%s sessionIdleTimeoutMs=%lu\n",
+                  snap.config.persistentSession ? "true" : "false",
+                  snap.sessionActive ? "true" : "false",
+                  static_cast<unsigned long>(snap.config.sessionIdleTimeoutMs));
+    Serial.printf("adaptiveWritePolling=%s tWR samples=%lu last=%lu min=%lu max=%lu p90=%lu us\n",
+                  snap.config.adaptiveWritePolling ? "true" : "false",
+                  static_cast<unsigned long>(snap.writeCycle.samples),
+                  static_cast<unsigned long>(snap.writeCycle.lastUs),
+                  static_cast<unsigned long>(snap.writeCycle.minUs),
+                  static_cast<unsigned long>(snap.writeCycle.maxUs),
+                  static_cast<unsigned long>(snap.writeCycle.p90Us));
+    Serial.printf("criticalSection=%s masked txns=%lu lastTotal=%lu lastMax=%lu peakTotal=%lu "
+                  "peakWindow=%lu total=%lu us\n",
+                  ex::criticalToStr(snap.config.criticalSection),
+                  static_cast<unsigned long>(snap.masking.transactions),
+                  static_cast<unsigned long>(snap.masking.lastTotalUs),
+                  static_cast<unsigned long>(snap.masking.lastMaxUs),
+                  static_cast<unsigned long>(snap.masking.peakTotalUs),
+                  static_cast<unsigned long>(snap.masking.peakWindowUs),
+                  static_cast<unsigned long>(snap.masking.totalUs));
   } else if (tokens[0] == "verbose") {
     if (argc >= 2) {
       gVerbose = (tokens[1].toInt() != 0);
@@ -1177,6 +1198,15 @@ void loop() {
       if (iterations <= 0) iterations = 10;
     }
     runSpeedTest(iterations);
+  } else if (tokens[0] == "timing_scan") {
+    AT21CS::TimingScanConfig scan;
+    if (argc >= 2 && tokens[1].toInt() > 0) {
+      scan.stepNs = static_cast<uint32_t>(tokens[1].toInt());
+    }
+    if (argc >= 3 && tokens[2].toInt() >= 0) {
+      scan.marginNs = static_cast<uint32_t>(tokens[2].toInt());
+    }
+    runTimingScan(scan);
   } else if (tokens[0] == "present") {
     bool present = false;
     ex::printStatus(gDevice.isPresent(present));
@@ -1316,6 +1346,37 @@ void loop() {
         ex::printStatus(gDevice.writeEepromPage(addr, data, len));
       }
     }
+  } else if (tokens[0] == "e_async" && argc >= 3) {
+    uint8_t addr = 0;
+    if (!ex::parseU8(tokens[1], addr)) {
+      Serial.println("Invalid address");
+    } else {
+      uint8_t data[16] = {0};
+      size_t len = 0;
+      for (int i = 2; i < argc && len < sizeof(data); ++i) {
+        uint8_t value = 0;
+        if (!ex::parseU8(tokens[i], value)) {
+          len = 0;
+          break;
+        }
+        data[len++] = value;
+      }
+      if (len == 0) {
+        Serial.println("Usage: e_async <addr> <v0> [..v15]");
+      } else {
+        const uint32_t startUs = micros();
+        AT21CS::Status st = gDevice.startWriteEeprom(addr, data, len);
+        uint32_t ticks = 0;
+        while (st.inProgress()) {
+          gDevice.tick(millis());
+          st = gDevice.writeStatus();
+          ++ticks;
+        }
+        ex::printStatus(st);
+        Serial.printf("ticks=%lu elapsed=%lu us\n", static_cast<unsigned long>(ticks),
+                      static_cast<unsigned long>(micros() - startUs));
+      }
+    }
   } else if (tokens[0] == "e_fill" && argc >= 4) {
     uint8_t addr = 0;
     uint8_t value = 0;
@@ -1382,8 +1443,7 @@ void loop() {
       const AT21CS::Status st = gDevice.readEeprom(addr, data, len);
       ex::printStatus(st);
       if (st.ok()) {
-        uint32_t crc = crc32Update(0xFFFFFFFFUL, data, len);
-        crc ^= 0xFFFFFFFFUL;
+        const uint32_t crc = AT21CS::crc::crc32(data, len);
         Serial.printf("  CRC32[0x%02X + %u] = 0x%08lX\n", addr,
                       static_cast<unsigned>(len), static_cast<unsigned long>(crc));
       }
@@ -1551,8 +1611,9 @@ void loop() {
       Serial.println("Usage: lc_set_tare <signed_raw>");
     } else {
       lcmap::RuntimeBlockV1 runtime = {};
+      lcmap::RuntimeSlotState runtimeSlots;
       bool valid = false;
-      const AT21CS::Status readSt = lcmap::readRuntime(gDevice, runtime, valid);
+      const AT21CS::Status readSt = lcmap::readRuntime(gDevice, runtime, runtimeSlots, valid);
       ex::printStatus(readSt);
       if (readSt.ok()) {
         if (!valid) {
@@ -1560,9 +1621,10 @@ void loop() {
           runtime.flags = 0x0001;
           runtime.filterProfile = 2;
         }
-        runtime.seq += 1;
         runtime.installTareRaw = tareRaw;
-        ex::printStatus(lcmap::writeRuntime(gDevice, runtime));
+        ex::printStatus(lcmap::writeRuntimeSlot(gDevice, runtime, runtimeSlots));
+        Serial.printf("runtimeSlot=%c seq=%u\n", runtimeSlots.newestSlot == 0U ? 'A' : 'B',
+                      static_cast<unsigned>(runtimeSlots.seq));
       }
     }
   } else if (tokens[0] == "lc_inc_overload") {
@@ -1571,17 +1633,18 @@ void loop() {
       Serial.println("Usage: lc_inc_overload [count]");
     } else {
       lcmap::CounterBlockV1 counters = {};
+      lcmap::CounterLogState counterLog;
       bool valid = false;
-      const AT21CS::Status readSt = lcmap::readCounters(gDevice, counters, valid);
+      const AT21CS::Status readSt = lcmap::readCounters(gDevice, counters, counterLog, valid);
       ex::printStatus(readSt);
       if (readSt.ok()) {
         if (!valid) {
           counters = {};
-          counters.flags = 0x0001;
         }
-        counters.seq += 1;
         counters.overloadCount += increment;
-        ex::printStatus(lcmap::writeCounters(gDevice, counters));
+        ex::printStatus(lcmap::appendCounters(gDevice, counters, counterLog));
+        Serial.printf("logSlot=%u seq=%u\n", static_cast<unsigned>(counterLog.newestSlot),
+                      static_cast<unsigned>(counterLog.seq));
       }
     }
   } else if (tokens[0] == "lc_fwrite" && argc >= 3) {
@@ -46,6 +46,12 @@ inline const char* errToStr(AT21CS::Err err) {
       return "PART_MISMATCH";
     case Err::IO_ERROR:
       return "IO_ERROR";
+    case Err::IN_PROGRESS:
+      return "IN_PROGRESS";
+    case Err::VERIFY_FAILED:
+      return "VERIFY_FAILED";
+    case Err::WRITE_PROTECTED:
+      return "WRITE_PROTECTED";
     default:
       return "UNKNOWN";
   }
@@ -95,6 +101,15 @@ inline const char* speedToStr(AT21CS::SpeedMode speed) {
   return speed == AT21CS::SpeedMode::STANDARD_SPEED ? "STANDARD" : "HIGH";
 }
 
+inline const char* criticalToStr(AT21CS::CriticalSection scope) {
+  switch (scope) {
+    case AT21CS::CriticalSection::PER_BIT: return "PER_BIT";
+    case AT21CS::CriticalSection::PER_BYTE: return "PER_BYTE";
+    case AT21CS::CriticalSection::PER_TRANSACTION: return "PER_TRANSACTION";
+  }
+  return "UNKNOWN";
+}
+
 inline void printStatus(const AT21CS::Status& st) {
   Serial.printf("  Status: %s%s%s (code=%u, detail=%ld)\n",
                 LOG_COLOR_RESULT(st.ok()),
@@ -7,6 +7,8 @@
 
 #include <Arduino.h>
 
+#include "AT21CS/Config.h"
+
 namespace board {
 
 static constexpr uint32_t SERIAL_BAUD = 115200;
@@ -15,6 +17,9 @@ static constexpr uint32_t SERIAL_BAUD = 115200;
 static constexpr int SIO_PRIMARY = 6;
 static constexpr int PRESENCE_PRIMARY = -1;
 static constexpr uint8_t ADDRESS_BITS_PRIMARY = 0;
+// High-Speed bit timing for this board; paste the profile printed by the
+// bring-up CLI `timing_scan` command here.
+static constexpr AT21CS::TimingProfile HIGH_SPEED_TIMING_PRIMARY = AT21CS::HIGH_SPEED_TIMING;
 
 // Secondary/tertiary pins used by multi_device_demo.
 static constexpr int SIO_SECONDARY = 10;
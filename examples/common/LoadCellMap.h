@@ -14,6 +14,9 @@
 #include <type_traits>
 
 #include "AT21CS/AT21CS.h"
+#include "AT21CS/Batch.h"
+#include "AT21CS/Crc.h"
+#include "AT21CS/WriteBackCache.h"
 
 namespace lcmap {
 
@@ -129,40 +132,12 @@ static constexpr uint8_t ZERO_BALANCE_RAW =
 static constexpr uint8_t SPAN_RAW_AT_CAPACITY = CALIBRATION_MASTER_ADDR +
                                                 static_cast<uint8_t>(
                                                     offsetof(CalibrationBlockV1, spanRawAtCapacity));
-static constexpr uint8_t INSTALL_TARE_RAW =
-    RUNTIME_ADDR + static_cast<uint8_t>(offsetof(RuntimeBlockV1, installTareRaw));
-static constexpr uint8_t OVERLOAD_COUNT =
-    COUNTERS_ADDR + static_cast<uint8_t>(offsetof(CounterBlockV1, overloadCount));
 }  // namespace field
 
-inline uint32_t crc32(const uint8_t* data, size_t len) {
-  uint32_t crc = 0xFFFFFFFFu;
-  for (size_t i = 0; i < len; ++i) {
-    crc ^= static_cast<uint32_t>(data[i]);
-    for (uint8_t bit = 0; bit < 8; ++bit) {
-      if ((crc & 1u) != 0u) {
-        crc = (crc >> 1u) ^ 0xEDB88320u;
-      } else {
-        crc >>= 1u;
-      }
-    }
-  }
-  return ~crc;
-}
+inline uint32_t crc32(const uint8_t* data, size_t len) { return AT21CS::crc::crc32(data, len); }
 
 inline uint16_t crc16Ccitt(const uint8_t* data, size_t len) {
-  uint16_t crc = 0xFFFFu;
-  for (size_t i = 0; i < len; ++i) {
-    crc ^= static_cast<uint16_t>(data[i]) << 8u;
-    for (uint8_t bit = 0; bit < 8; ++bit) {
-      if ((crc & 0x8000u) != 0u) {
-        crc = static_cast<uint16_t>((crc << 1u) ^ 0x1021u);
-      } else {
-        crc = static_cast<uint16_t>(crc << 1u);
-      }
-    }
-  }
-  return crc;
+  return AT21CS::crc::crc16Ccitt(data, len);
 }
 
 template <typename T>
@@ -171,6 +146,35 @@ inline uint32_t recordCrc32(const T& record) {
   return crc32(reinterpret_cast<const uint8_t*>(&record), sizeof(T) - sizeof(uint32_t));
 }
 
+// Copies streamed bytes into a record and hashes everything before the CRC
+// footer on the fly, so the CRC is final when the read returns.
+struct Crc32StreamSink {
+  uint8_t* out;
+  size_t crcLen;
+  uint32_t state;
+};
+
+inline void crc32StreamByte(uint8_t value, size_t index, void* user) {
+  Crc32StreamSink& sink = *static_cast<Crc32StreamSink*>(user);
+  sink.out[index] = value;
+  if (index < sink.crcLen) {
+    sink.state = AT21CS::crc::crc32UpdateByte(sink.state, value);
+  }
+}
+
+// Read a record with a trailing crc32 footer; crc receives the CRC of its body.
+template <typename T>
+inline AT21CS::Status readRecordCrc32(AT21CS::Driver& driver, uint8_t address, T& record,
+                                      uint32_t& crc) {
+  static_assert(std::is_trivially_copyable<T>::value, "Record must be trivially copyable");
+  static_assert(sizeof(T) >= sizeof(uint32_t), "Record too small for crc32 footer");
+  Crc32StreamSink sink{reinterpret_cast<uint8_t*>(&record), sizeof(T) - sizeof(uint32_t),
+                       AT21CS::crc::CRC32_INIT};
+  const AT21CS::Status st = driver.readEepromStream(address, sizeof(T), crc32StreamByte, &sink);
+  crc = AT21CS::crc::crc32Final(sink.state);
+  return st;
+}
+
 inline AT21CS::Status writeEepromBytesPaged(AT21CS::Driver& driver, uint8_t address,
                                             const uint8_t* data, size_t len) {
   if (data == nullptr || len == 0 || len > AT21CS::cmd::EEPROM_SIZE) {
@@ -202,6 +206,21 @@ inline AT21CS::Status writeEepromBytesPaged(AT21CS::Driver& driver, uint8_t addr
   return AT21CS::Status::Ok();
 }
 
+// Like writeEepromBytesPaged(), but only pages whose content differs are written.
+inline AT21CS::Status writeEepromBytesIfChanged(AT21CS::Driver& driver, uint8_t address,
+                                                const uint8_t* data, size_t len,
+                                                uint8_t& pagesSkipped) {
+  pagesSkipped = 0;
+  if (data == nullptr || len == 0 || len > AT21CS::cmd::EEPROM_SIZE) {
+    return AT21CS::Status::Error(AT21CS::Err::INVALID_PARAM, "Invalid EEPROM write buffer/length");
+  }
+  const uint16_t end = static_cast<uint16_t>(address) + static_cast<uint16_t>(len);
+  if (end > AT21CS::cmd::EEPROM_SIZE) {
+    return AT21CS::Status::Error(AT21CS::Err::INVALID_PARAM, "EEPROM write range out of bounds");
+  }
+  return driver.writeEepromIfChanged(address, data, len, pagesSkipped);
+}
+
 inline AT21CS::Status writeSecurityUserBytesPaged(AT21CS::Driver& driver, uint8_t address,
                                                   const uint8_t* data, size_t len) {
   if (data == nullptr || len == 0 || len > AT21CS::cmd::SECURITY_SIZE) {
@@ -252,6 +271,22 @@ inline AT21CS::Status writePodEeprom(AT21CS::Driver& driver, uint8_t address, co
   return writeEepromBytesPaged(driver, address, reinterpret_cast<const uint8_t*>(&value), sizeof(T));
 }
 
+// Write-back variants: field updates are merged in RAM and flushed by the cache.
+template <typename T>
+inline AT21CS::Status readPodEeprom(AT21CS::WriteBackCache& cache, uint8_t address, T& value) {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "readPodEeprom requires trivially copyable type");
+  return cache.readEeprom(address, reinterpret_cast<uint8_t*>(&value), sizeof(T));
+}
+
+template <typename T>
+inline AT21CS::Status writePodEeprom(AT21CS::WriteBackCache& cache, uint8_t address,
+                                     const T& value) {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "writePodEeprom requires trivially copyable type");
+  return cache.writeEeprom(address, reinterpret_cast<const uint8_t*>(&value), sizeof(T));
+}
+
 inline AT21CS::Status readFloat32(AT21CS::Driver& driver, uint8_t address, float& value) {
   static_assert(sizeof(float) == 4, "This helper assumes IEEE-754 32-bit float");
   return readPodEeprom(driver, address, value);
@@ -284,11 +319,12 @@ inline void seal(CalibrationBlockV1& record) {
   record.crc32 = recordCrc32(record);
 }
 
+inline bool hasHeader(const CalibrationBlockV1& record) {
+  return record.magic == CALIBRATION_MAGIC && record.version == CALIBRATION_VERSION;
+}
+
 inline bool isValid(const CalibrationBlockV1& record) {
-  if (record.magic != CALIBRATION_MAGIC || record.version != CALIBRATION_VERSION) {
-    return false;
-  }
-  return recordCrc32(record) == record.crc32;
+  return hasHeader(record) && recordCrc32(record) == record.crc32;
 }
 
 inline void seal(RuntimeBlockV1& record) {
@@ -363,24 +399,24 @@ inline AT21CS::Status writeCalibrationBoth(AT21CS::Driver& driver, CalibrationBl
 inline AT21CS::Status readCalibrationMaster(AT21CS::Driver& driver, CalibrationBlockV1& record,
                                             bool& valid) {
   valid = false;
-  const AT21CS::Status st =
-      driver.readEeprom(CALIBRATION_MASTER_ADDR, reinterpret_cast<uint8_t*>(&record), sizeof(record));
+  uint32_t crc = 0;
+  const AT21CS::Status st = readRecordCrc32(driver, CALIBRATION_MASTER_ADDR, record, crc);
   if (!st.ok()) {
     return st;
   }
-  valid = isValid(record);
+  valid = hasHeader(record) && crc == record.crc32;
   return st;
 }
 
 inline AT21CS::Status readCalibrationMirror(AT21CS::Driver& driver, CalibrationBlockV1& record,
                                             bool& valid) {
   valid = false;
-  const AT21CS::Status st =
-      driver.readEeprom(CALIBRATION_MIRROR_ADDR, reinterpret_cast<uint8_t*>(&record), sizeof(record));
+  uint32_t crc = 0;
+  const AT21CS::Status st = readRecordCrc32(driver, CALIBRATION_MIRROR_ADDR, record, crc);
   if (!st.ok()) {
     return st;
   }
-  valid = isValid(record);
+  valid = hasHeader(record) && crc == record.crc32;
   return st;
 }
 
@@ -419,37 +455,356 @@ inline AT21CS::Status readCalibrationBest(AT21CS::Driver& driver, CalibrationBlo
                                "Calibration CRC invalid in master and mirror");
 }
 
-inline AT21CS::Status writeRuntime(AT21CS::Driver& driver, RuntimeBlockV1 record) {
+inline void putLe(uint8_t* out, uint32_t value, uint8_t bytes) {
+  for (uint8_t i = 0; i < bytes; ++i) {
+    out[i] = static_cast<uint8_t>(value >> (8U * i));
+  }
+}
+
+inline uint32_t getLe(const uint8_t* in, uint8_t bytes) {
+  uint32_t value = 0;
+  for (uint8_t i = 0; i < bytes; ++i) {
+    value |= static_cast<uint32_t>(in[i]) << (8U * i);
+  }
+  return value;
+}
+
+// Two-slot record store: a 32-byte zone holds slots A and B of 16 bytes, each
+// on its own two pages. A write goes to the slot not holding the newest entry,
+// so a brown-out mid-write leaves the previous entry intact. Slot layout:
+//   [0..12]  record-specific payload
+//   [13]     seq (wrapping, newest wins in serial-number order)
+//   [14..15] crc16Ccitt(bytes 0..13) ^ 0xA55A, little-endian (rejects erased
+//            and zeroed slots)
+// seq and check sit in the slot's second page, which is written last: a torn
+// write never shows a new seq, and a mix of old and new payload fails the CRC.
+static constexpr uint8_t SLOT_SIZE = 16;
+static constexpr uint8_t SLOT_COUNT = ZONE_SIZE / SLOT_SIZE;
+static constexpr uint8_t SLOT_PAYLOAD_SIZE = SLOT_SIZE - 3U;
+static constexpr uint8_t SLOT_SEQ_OFFSET = SLOT_PAYLOAD_SIZE;
+static constexpr uint8_t SLOT_CHECK_OFFSET = SLOT_SEQ_OFFSET + 1U;
+static constexpr uint16_t SLOT_CHECK_XOR = 0xA55A;
+
+static_assert(SLOT_SIZE % AT21CS::cmd::PAGE_SIZE == 0, "Slots must be page aligned");
+static_assert(SLOT_SEQ_OFFSET / AT21CS::cmd::PAGE_SIZE == (SLOT_SIZE - 1U) / AT21CS::cmd::PAGE_SIZE,
+              "seq and check must share the last page of a slot");
+
+// Position of the newest slot, carried between writes.
+struct SlotPairState {
+  bool loaded = false;    // Zone has been read since the last failure.
+  bool hasEntry = false;  // A valid slot exists (false: empty zone or legacy block).
+  uint8_t newestSlot = 0;
+  uint8_t seq = 0;
+};
+
+inline uint16_t slotCheck(const uint8_t* slot) {
+  return static_cast<uint16_t>(crc16Ccitt(slot, SLOT_CHECK_OFFSET) ^ SLOT_CHECK_XOR);
+}
+
+// Select the newest valid slot in one pass over the zone image.
+inline bool findNewestSlot(const uint8_t* zone, SlotPairState& state) {
+  state = SlotPairState{};
+  state.loaded = true;
+  for (uint8_t slot = 0; slot < SLOT_COUNT; ++slot) {
+    const uint8_t* entry = &zone[slot * SLOT_SIZE];
+    if (getLe(&entry[SLOT_CHECK_OFFSET], 2) != slotCheck(entry)) {
+      continue;
+    }
+    const uint8_t seq = entry[SLOT_SEQ_OFFSET];
+    if (!state.hasEntry || static_cast<int8_t>(seq - state.seq) > 0) {
+      state.hasEntry = true;
+      state.newestSlot = slot;
+      state.seq = seq;
+    }
+  }
+  return state.hasEntry;
+}
+
+// Write payload as the next slot (two pages, ascending, so seq and check go
+// last). Over an empty zone or a legacy block slot A is written first and
+// copied to the other slots only once it has committed, so stale bytes there
+// can never pass as a newer entry.
+inline AT21CS::Status writeNextSlot(AT21CS::Driver& driver, uint8_t zoneAddress,
+                                    const uint8_t* payload, SlotPairState& state) {
+  const uint8_t seq = static_cast<uint8_t>(state.hasEntry ? state.seq + 1U : 1U);
+  const uint8_t slot =
+      static_cast<uint8_t>(state.hasEntry ? (state.newestSlot + 1U) % SLOT_COUNT : 0U);
+  uint8_t entry[SLOT_SIZE];
+  std::memcpy(entry, payload, SLOT_PAYLOAD_SIZE);
+  entry[SLOT_SEQ_OFFSET] = seq;
+  putLe(&entry[SLOT_CHECK_OFFSET], slotCheck(entry), 2);
+
+  AT21CS::Status st = writeEepromBytesPaged(
+      driver, static_cast<uint8_t>(zoneAddress + slot * SLOT_SIZE), entry, SLOT_SIZE);
+  for (uint8_t i = 1; st.ok() && !state.hasEntry && i < SLOT_COUNT; ++i) {
+    st = writeEepromBytesPaged(driver, static_cast<uint8_t>(zoneAddress + i * SLOT_SIZE), entry,
+                               SLOT_SIZE);
+  }
+  if (!st.ok()) {
+    // A partial write leaves the zone unknown; re-read before the next write.
+    state.loaded = false;
+    return st;
+  }
+
+  state.hasEntry = true;
+  state.newestSlot = slot;
+  state.seq = seq;
+  return st;
+}
+
+// Wear-leveled counter log in zone 3. Each update writes one slot, so each page
+// takes half the writes of an in-place CounterBlockV1 update. Payload:
+//   overload, overTemp, powerCycle, saturation as 26-bit counters packed
+//   little-endian (saturating at COUNTER_LOG_MAX). flags are not stored.
+// A legacy CounterBlockV1 is still read and is migrated by the first append;
+// there is no in-place CounterBlockV1 writer.
+static constexpr uint8_t COUNTER_LOG_ADDR = COUNTERS_ADDR;
+static constexpr uint8_t COUNTER_LOG_ENTRY_SIZE = SLOT_SIZE;
+static constexpr uint8_t COUNTER_LOG_SLOTS = SLOT_COUNT;
+static constexpr uint8_t COUNTER_LOG_BITS = 26;
+static constexpr uint32_t COUNTER_LOG_MAX = (1u << COUNTER_LOG_BITS) - 1u;
+
+static_assert(4U * COUNTER_LOG_BITS <= 8U * SLOT_PAYLOAD_SIZE, "Counters must fit a slot");
+
+using CounterLogState = SlotPairState;
+
+inline void encodeCounterLogPayload(const CounterBlockV1& record, uint8_t* payload) {
+  const uint32_t values[4] = {record.overloadCount, record.overTempCount, record.powerCycleCount,
+                              record.saturationCount};
+  std::memset(payload, 0, SLOT_PAYLOAD_SIZE);
+  uint64_t bits = 0;
+  uint8_t count = 0;
+  uint8_t out = 0;
+  for (uint8_t i = 0; i < 4; ++i) {
+    bits |= static_cast<uint64_t>(values[i] > COUNTER_LOG_MAX ? COUNTER_LOG_MAX : values[i])
+            << count;
+    count = static_cast<uint8_t>(count + COUNTER_LOG_BITS);
+    while (count >= 8U) {
+      payload[out++] = static_cast<uint8_t>(bits);
+      bits >>= 8U;
+      count = static_cast<uint8_t>(count - 8U);
+    }
+  }
+  if (count != 0U) {
+    payload[out] = static_cast<uint8_t>(bits);
+  }
+}
+
+inline void decodeCounterLogEntry(const uint8_t* entry, CounterBlockV1& record) {
+  uint32_t values[4] = {};
+  uint64_t bits = 0;
+  uint8_t count = 0;
+  uint8_t in = 0;
+  for (uint8_t i = 0; i < 4; ++i) {
+    while (count < COUNTER_LOG_BITS) {
+      bits |= static_cast<uint64_t>(entry[in++]) << count;
+      count = static_cast<uint8_t>(count + 8U);
+    }
+    values[i] = static_cast<uint32_t>(bits & COUNTER_LOG_MAX);
+    bits >>= COUNTER_LOG_BITS;
+    count = static_cast<uint8_t>(count - COUNTER_LOG_BITS);
+  }
+  record = CounterBlockV1{};
+  record.seq = entry[SLOT_SEQ_OFFSET];
+  record.overloadCount = values[0];
+  record.overTempCount = values[1];
+  record.powerCycleCount = values[2];
+  record.saturationCount = values[3];
   seal(record);
-  return writeEepromBytesPaged(driver, RUNTIME_ADDR, reinterpret_cast<const uint8_t*>(&record),
-                               sizeof(record));
 }
 
-inline AT21CS::Status readRuntime(AT21CS::Driver& driver, RuntimeBlockV1& record, bool& valid) {
+// Decode the 32-byte zone: the newest valid log entry, otherwise a valid
+// legacy CounterBlockV1. record.seq is then the 8-bit wrapping slot seq.
+inline bool decodeCounters(const uint8_t* zone, CounterBlockV1& record, CounterLogState& state) {
+  if (findNewestSlot(zone, state)) {
+    decodeCounterLogEntry(&zone[state.newestSlot * SLOT_SIZE], record);
+    return true;
+  }
+  std::memcpy(&record, zone, sizeof(record));
+  return isValid(record);
+}
+
+inline AT21CS::Status readCounters(AT21CS::Driver& driver, CounterBlockV1& record,
+                                   CounterLogState& state, bool& valid) {
   valid = false;
-  const AT21CS::Status st = driver.readEeprom(RUNTIME_ADDR, reinterpret_cast<uint8_t*>(&record),
-                                               sizeof(record));
+  state = CounterLogState{};
+  uint8_t zone[ZONE_SIZE];
+  const AT21CS::Status st = driver.readEeprom(COUNTER_LOG_ADDR, zone, sizeof(zone));
   if (!st.ok()) {
     return st;
   }
-  valid = isValid(record);
+  valid = decodeCounters(zone, record, state);
   return st;
 }
 
-inline AT21CS::Status writeCounters(AT21CS::Driver& driver, CounterBlockV1 record) {
+inline AT21CS::Status readCounters(AT21CS::Driver& driver, CounterBlockV1& record, bool& valid) {
+  CounterLogState state;
+  return readCounters(driver, record, state, valid);
+}
+
+inline AT21CS::Status appendCounters(AT21CS::Driver& driver, const CounterBlockV1& record,
+                                     CounterLogState& state) {
+  if (!state.loaded) {
+    CounterBlockV1 current{};
+    bool valid = false;
+    const AT21CS::Status st = readCounters(driver, current, state, valid);
+    if (!st.ok()) {
+      return st;
+    }
+  }
+  uint8_t payload[SLOT_PAYLOAD_SIZE];
+  encodeCounterLogPayload(record, payload);
+  return writeNextSlot(driver, COUNTER_LOG_ADDR, payload, state);
+}
+
+// Power-fail-safe A/B runtime store in zone 2. Payload:
+//   [0..3] installTareRaw, [4..7] userZeroTrimRaw, [8..10] userSpanTrimPpm
+//   (int24, saturating at +/-RUNTIME_SPAN_TRIM_LIMIT), [11] filterProfile in
+//   bits 0..3 and diagnosticsMode in bits 4..7 (each saturating at
+//   RUNTIME_MODE_MAX), [12] flags bits 0..7.
+// A legacy RuntimeBlockV1 is still read and is migrated by the first write;
+// there is no in-place RuntimeBlockV1 writer.
+static constexpr uint8_t RUNTIME_SLOTS_ADDR = RUNTIME_ADDR;
+static constexpr int32_t RUNTIME_SPAN_TRIM_LIMIT = 0x7FFFFF;
+static constexpr uint8_t RUNTIME_MODE_MAX = 0x0F;
+
+using RuntimeSlotState = SlotPairState;
+
+inline void encodeRuntimePayload(const RuntimeBlockV1& record, uint8_t* payload) {
+  int32_t span = record.userSpanTrimPpm;
+  if (span > RUNTIME_SPAN_TRIM_LIMIT) {
+    span = RUNTIME_SPAN_TRIM_LIMIT;
+  } else if (span < -RUNTIME_SPAN_TRIM_LIMIT) {
+    span = -RUNTIME_SPAN_TRIM_LIMIT;
+  }
+  putLe(&payload[0], static_cast<uint32_t>(record.installTareRaw), 4);
+  putLe(&payload[4], static_cast<uint32_t>(record.userZeroTrimRaw), 4);
+  putLe(&payload[8], static_cast<uint32_t>(span), 3);
+  const uint8_t filter =
+      record.filterProfile > RUNTIME_MODE_MAX ? RUNTIME_MODE_MAX : record.filterProfile;
+  const uint8_t diagnostics =
+      record.diagnosticsMode > RUNTIME_MODE_MAX ? RUNTIME_MODE_MAX : record.diagnosticsMode;
+  payload[11] = static_cast<uint8_t>(filter | (diagnostics << 4U));
+  payload[12] = static_cast<uint8_t>(record.flags);
+}
+
+inline void decodeRuntimeSlot(const uint8_t* slot, RuntimeBlockV1& record) {
+  const uint8_t* payload = slot;
+  uint32_t span = getLe(&payload[8], 3);
+  if ((span & 0x800000u) != 0u) {
+    span |= 0xFF000000u;
+  }
+  record = RuntimeBlockV1{};
+  record.seq = slot[SLOT_SEQ_OFFSET];
+  record.installTareRaw = static_cast<int32_t>(getLe(&payload[0], 4));
+  record.userZeroTrimRaw = static_cast<int32_t>(getLe(&payload[4], 4));
+  record.userSpanTrimPpm = static_cast<int32_t>(span);
+  record.filterProfile = static_cast<uint8_t>(payload[11] & RUNTIME_MODE_MAX);
+  record.diagnosticsMode = static_cast<uint8_t>(payload[11] >> 4U);
+  record.flags = payload[12];
   seal(record);
-  return writeEepromBytesPaged(driver, COUNTERS_ADDR, reinterpret_cast<const uint8_t*>(&record),
-                               sizeof(record));
 }
 
-inline AT21CS::Status readCounters(AT21CS::Driver& driver, CounterBlockV1& record, bool& valid) {
+// Decode the 32-byte zone: the slot with the highest valid seq, otherwise a
+// valid legacy RuntimeBlockV1. record.seq is then the 8-bit wrapping slot seq,
+// not the legacy uint32 counter.
+inline bool decodeRuntime(const uint8_t* zone, RuntimeBlockV1& record, RuntimeSlotState& state) {
+  if (findNewestSlot(zone, state)) {
+    decodeRuntimeSlot(&zone[state.newestSlot * SLOT_SIZE], record);
+    return true;
+  }
+  std::memcpy(&record, zone, sizeof(record));
+  return isValid(record);
+}
+
+// Both slots arrive in one sequential read and are validated in one pass.
+inline AT21CS::Status readRuntime(AT21CS::Driver& driver, RuntimeBlockV1& record,
+                                  RuntimeSlotState& state, bool& valid) {
   valid = false;
-  const AT21CS::Status st = driver.readEeprom(COUNTERS_ADDR, reinterpret_cast<uint8_t*>(&record),
-                                               sizeof(record));
+  state = RuntimeSlotState{};
+  uint8_t zone[ZONE_SIZE];
+  const AT21CS::Status st = driver.readEeprom(RUNTIME_SLOTS_ADDR, zone, sizeof(zone));
   if (!st.ok()) {
     return st;
   }
-  valid = isValid(record);
+  valid = decodeRuntime(zone, record, state);
+  return st;
+}
+
+inline AT21CS::Status readRuntime(AT21CS::Driver& driver, RuntimeBlockV1& record, bool& valid) {
+  RuntimeSlotState state;
+  return readRuntime(driver, record, state, valid);
+}
+
+// Write the record into the inactive slot; the active slot stays valid until
+// the new one is complete.
+inline AT21CS::Status writeRuntimeSlot(AT21CS::Driver& driver, const RuntimeBlockV1& record,
+                                       RuntimeSlotState& state) {
+  if (!state.loaded) {
+    RuntimeBlockV1 current{};
+    bool valid = false;
+    const AT21CS::Status st = readRuntime(driver, current, state, valid);
+    if (!st.ok()) {
+      return st;
+    }
+  }
+  uint8_t payload[SLOT_PAYLOAD_SIZE];
+  encodeRuntimePayload(record, payload);
+  return writeNextSlot(driver, RUNTIME_SLOTS_ADDR, payload, state);
+}
+
+// Boot-time read of every identity and record in one device activation.
+struct BootRecords {
+  uint32_t manufacturerId = 0;
+  AT21CS::SerialNumberInfo serial{};
+  SecurityIdentityV1 identity{};
+  CalibrationBlockV1 calibrationMaster{};
+  CalibrationBlockV1 calibrationMirror{};
+  RuntimeBlockV1 runtime{};
+  RuntimeSlotState runtimeSlots{};
+  CounterBlockV1 counters{};
+  CounterLogState countersLog{};
+  bool serialValid = false;
+  bool identityValid = false;
+  bool calibrationMasterValid = false;
+  bool calibrationMirrorValid = false;
+  bool runtimeValid = false;
+  bool countersValid = false;
+};
+
+inline AT21CS::Status readBootRecords(AT21CS::Driver& driver, BootRecords& out) {
+  out = BootRecords{};
+  AT21CS::Batch batch;
+  batch.setContinueOnError(true);
+  (void)batch.readManufacturerId(out.manufacturerId);
+  (void)batch.readSerialNumber(out.serial);
+  (void)batch.readSecurity(SECURITY_IDENTITY_ADDR, reinterpret_cast<uint8_t*>(&out.identity),
+                           sizeof(out.identity));
+  (void)batch.readEeprom(CALIBRATION_MASTER_ADDR,
+                         reinterpret_cast<uint8_t*>(&out.calibrationMaster),
+                         sizeof(out.calibrationMaster));
+  (void)batch.readEeprom(CALIBRATION_MIRROR_ADDR,
+                         reinterpret_cast<uint8_t*>(&out.calibrationMirror),
+                         sizeof(out.calibrationMirror));
+  (void)batch.readEeprom(RUNTIME_ADDR, reinterpret_cast<uint8_t*>(&out.runtime),
+                         sizeof(out.runtime));
+  (void)batch.readEeprom(COUNTERS_ADDR, reinterpret_cast<uint8_t*>(&out.counters),
+                         sizeof(out.counters));
+
+  const AT21CS::Status st = driver.runBatch(batch);
+  out.serialValid = batch.status(1).ok();
+  out.identityValid = batch.status(2).ok() && isValid(out.identity);
+  out.calibrationMasterValid = batch.status(3).ok() && isValid(out.calibrationMaster);
+  out.calibrationMirrorValid = batch.status(4).ok() && isValid(out.calibrationMirror);
+  uint8_t zone[ZONE_SIZE];
+  if (batch.status(5).ok()) {
+    std::memcpy(zone, &out.runtime, sizeof(zone));
+    out.runtimeValid = decodeRuntime(zone, out.runtime, out.runtimeSlots);
+  }
+  if (batch.status(6).ok()) {
+    std::memcpy(zone, &out.counters, sizeof(zone));
+    out.countersValid = decodeCounters(zone, out.counters, out.countersLog);
+  }
   return st;
 }
 
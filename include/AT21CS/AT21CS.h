@@ -23,11 +23,15 @@
 
 namespace AT21CS {
 
+class Batch;
+class Waveform;
+
 /// @brief AT21CS runtime state machine.
 ///
 /// Transition overview:
 /// - UNINIT -> PROBING -> INIT_CONFIG -> READY during begin()
-/// - READY -> BUSY during blocking write-ready polling
+/// - READY -> BUSY during blocking write-ready polling or an asynchronous write
+///   started by startWriteEeprom(); tick() returns BUSY -> READY on completion
 /// - Any tracked failure: READY/BUSY/RECOVERING -> DEGRADED or OFFLINE
 /// - recover(): DEGRADED/OFFLINE -> RECOVERING -> READY (success path)
 /// - Fatal protocol/config mismatch may move to FAULT
@@ -44,6 +48,18 @@ enum class DriverState : uint8_t {
   FAULT
 };
 
+/// @brief Per-byte consumer for readEepromStream().
+/// @param value Byte just received.
+/// @param index Offset of the byte from the start of the read.
+/// @param user Opaque pointer passed to readEepromStream().
+using ByteSinkFn = void (*)(uint8_t value, size_t index, void* user);
+
+/// @brief Completion callback for Driver::startWaveform().
+/// @param result Final waveform status (see Driver::runWaveform()).
+/// @param user Opaque pointer passed to startWaveform().
+/// Called from tick() for timer-driven waveforms, never from the alarm handler.
+using WaveformDoneFn = void (*)(const Status& result, void* user);
+
 /// @brief Factory serial number payload from the Security register.
 struct SerialNumberInfo {
   uint8_t bytes[cmd::SECURITY_SERIAL_SIZE]; ///< Raw 8-byte serial payload.
@@ -51,6 +67,31 @@ struct SerialNumberInfo {
   bool crcOk;                               ///< True when the serial CRC matches.
 };
 
+/// @brief Observed internal write-cycle (t_WR) durations for one device.
+/// Durations are bus-time accounted from the write's Stop to the first ACK poll;
+/// tick()-driven writes add only an upper bound clamped to p90Us.
+struct WriteCycleStats {
+  uint32_t samples = 0;  ///< Write cycles measured since begin().
+  uint32_t lastUs = 0;   ///< Most recent observed t_WR.
+  uint32_t minUs = 0;    ///< Shortest observed t_WR.
+  uint32_t maxUs = 0;    ///< Longest observed t_WR.
+  uint32_t p90Us = 0;    ///< Running 90th-percentile estimate.
+};
+
+/// @brief Interrupt-masked time, measured around every critical section.
+///
+/// A transaction ends with each Stop condition and includes the reset/discovery
+/// window that preceded it. On ESP32 the CPU cycle counter is used; elsewhere
+/// the sum of delays spent inside the sections.
+struct MaskingStats {
+  uint32_t transactions = 0;   ///< Transactions measured.
+  uint32_t lastTotalUs = 0;    ///< Masked time in the most recent transaction.
+  uint32_t lastMaxUs = 0;      ///< Longest single section in the most recent transaction.
+  uint32_t peakTotalUs = 0;    ///< Largest per-transaction masked time.
+  uint32_t peakWindowUs = 0;   ///< Longest single section.
+  uint32_t totalUs = 0;        ///< Cumulative masked time (saturating).
+};
+
 /// @brief Cached settings and health state, read without bus I/O.
 struct SettingsSnapshot {
   Config config;                         ///< Active runtime configuration snapshot.
@@ -58,6 +99,14 @@ struct SettingsSnapshot {
   bool initialized = false;
   PartType detectedPart = PartType::UNKNOWN;
   SpeedMode speedMode = SpeedMode::HIGH_SPEED;
+  bool sessionActive = false;            ///< True while a persistent session is held.
+  uint16_t shadowEepromValid = 0;        ///< Shadow validity, bit n = EEPROM page n.
+  uint8_t shadowSecurityValid = 0;       ///< Shadow validity, bit n = Security page n.
+  bool romZoneMaskValid = false;         ///< romZoneMask has been loaded (Config::romZoneGuard).
+  uint8_t romZoneMask = 0;               ///< Cached ROM zones, bit n = zone n.
+  uint32_t edgeOverheadCycles = 0;       ///< Measured per-edge cost removed from bit delays (ESP32).
+  WriteCycleStats writeCycle;            ///< Learned t_WR statistics.
+  MaskingStats masking;                  ///< Interrupt-masked time statistics.
   uint32_t lastOkMs = 0;
   uint32_t lastErrorMs = 0;
   Status lastError = Status::Ok();
@@ -66,6 +115,31 @@ struct SettingsSnapshot {
   uint32_t totalSuccess = 0;
 };
 
+/// @brief Pass window of one timing parameter, measured with the others at
+/// their active values. Both ends reproduced the reference pattern.
+struct TimingWindow {
+  uint32_t minNs = 0;  ///< Shortest passing value.
+  uint32_t maxNs = 0;  ///< Longest passing value.
+};
+
+/// @brief Sweep settings for Driver::characterizeTiming().
+struct TimingScanConfig {
+  uint32_t stepNs = 250;    ///< Sweep step; finer than 1000 only matters on ESP32 direct GPIO.
+  uint32_t marginNs = 250;  ///< Minimum distance of each chosen value from its window edges.
+  uint8_t trials = 3;       ///< Pattern reads per candidate; every read must match.
+};
+
+/// @brief Result of Driver::characterizeTiming().
+struct TimingScanResult {
+  TimingProfile profile{};  ///< Suggested profile; valid when the scan returns Ok.
+  TimingWindow bit;         ///< t_BIT window.
+  TimingWindow low0;        ///< t_LOW0 window.
+  TimingWindow low1;        ///< t_LOW1 window.
+  TimingWindow readLow;     ///< t_RD window.
+  TimingWindow readSample;  ///< Release-to-sample window.
+  uint32_t candidates = 0;  ///< Candidate values tried.
+};
+
 /// @brief AT21CS01/AT21CS11 single-wire EEPROM driver.
 /// Not thread-safe: serialize access from one task/thread or guard with an external mutex.
 class Driver {
@@ -76,7 +150,8 @@ class Driver {
   /// @return Status::Ok() on success, error otherwise.
   Status begin(const Config& config);
 
-  /// @brief Record the caller's current scheduler timestamp.
+  /// @brief Record the caller's current scheduler timestamp and advance any
+  /// asynchronous write (at most one ACK poll or page write per call).
   /// @param nowMs Current monotonic time in milliseconds.
   void tick(uint32_t nowMs);
 
@@ -96,6 +171,13 @@ class Driver {
   /// @return Status::Ok() when discovery succeeds, error otherwise.
   Status resetAndDiscover();
 
+  /// @brief Drop the persistent session so the next operation runs reset/discovery.
+  void invalidateSession() { _sessionActive = false; }
+
+  /// @brief Check whether a persistent session is currently held.
+  /// @return true when the next operation may skip reset/discovery.
+  bool sessionActive() const { return _sessionActive; }
+
   /// @brief Check whether the device is currently present.
   /// @param[out] present Set true when presence is detected.
   /// @return Status::Ok() on a completed check, error otherwise.
@@ -158,6 +240,9 @@ class Driver {
   /// @return Saturating success count.
   uint32_t totalSuccess() const { return _totalSuccess; }
 
+  /// @brief Clear interrupt-masking statistics (SettingsSnapshot::masking).
+  void resetMaskingStats() { _masking = MaskingStats{}; }
+
   /// @brief Get the detected AT21CS part type.
   /// @return Detected part, or UNKNOWN before successful discovery.
   PartType detectedPart() const { return _detectedPart; }
@@ -185,6 +270,22 @@ class Driver {
   /// @return Status::Ok() on success, error otherwise.
   Status readEeprom(uint8_t address, uint8_t* data, size_t len);
 
+  /// @brief Read EEPROM bytes, handing each one to a sink as it arrives.
+  ///
+  /// The sink runs between received bytes, inside the read transaction, so a
+  /// CRC or parser is finished when the Stop condition ends. With
+  /// CriticalSection::PER_TRANSACTION it runs with interrupts masked. Keep it to
+  /// a few microseconds and place it in IRAM on ESP32. The bus is master-paced,
+  /// so a slow sink only stretches the read. Shadow-cache hits call the sink
+  /// without bus I/O.
+  /// @param address Start address in the 128-byte EEPROM area.
+  /// @param len Number of bytes to read.
+  /// @param sink Called once per byte in address order.
+  /// @param user Opaque pointer passed to sink.
+  /// @return Status::Ok() on success, error otherwise. On a bus error the sink
+  ///         may have seen some or all bytes.
+  Status readEepromStream(uint8_t address, size_t len, ByteSinkFn sink, void* user);
+
   /// @brief Write one EEPROM byte.
   /// @param address EEPROM byte address.
   /// @param value Byte value to write.
@@ -205,6 +306,116 @@ class Driver {
   /// @return Status::Ok() after all write cycles complete, error otherwise.
   Status writeEeprom(uint8_t address, const uint8_t* data, size_t len);
 
+  /// @brief Write bytes across EEPROM pages and read each page back under one activation.
+  /// Each page is written, ACK-polled until t_WR ends, and read back without a
+  /// reset in between. A mismatch counts as a successful bus operation in the
+  /// health counters.
+  /// @param address EEPROM start address.
+  /// @param data Source buffer.
+  /// @param len Number of bytes to write.
+  /// @return Status::Ok() when every byte reads back as written, VERIFY_FAILED
+  ///         with detail = first differing offset from address, error otherwise.
+  Status writeEepromVerified(uint8_t address, const uint8_t* data, size_t len);
+
+  /// @brief Write bytes across EEPROM pages, skipping pages whose content already matches.
+  /// Compares against the shadow cache when valid, otherwise against one fresh read.
+  /// @param address EEPROM start address.
+  /// @param data Source buffer.
+  /// @param len Number of bytes to write.
+  /// @param[out] pagesSkipped Number of page writes avoided.
+  /// @return Status::Ok() after all required write cycles complete, error otherwise.
+  Status writeEepromIfChanged(uint8_t address, const uint8_t* data, size_t len,
+                              uint8_t& pagesSkipped);
+
+  // Shadow cache
+  /// @brief Fill the whole EEPROM and Security shadow with one sequential read each.
+  /// @return Status::Ok() on success, INVALID_STATE when Config::shadowCache is off.
+  Status fillShadowCache();
+
+  /// @brief Drop all shadow pages so the next reads go to the bus.
+  void invalidateShadowCache();
+
+  // Identity cache
+  /// @brief Forget cached IDs and lock/freeze states (Config::identityCache).
+  void invalidateIdentityCache();
+
+  // Asynchronous EEPROM write
+  /// @brief Start a non-blocking EEPROM write across page boundaries.
+  /// The data is copied; tick() ACK-polls t_WR and issues the following pages.
+  /// Other operations return INVALID_STATE until the write finishes.
+  /// @param address EEPROM start address.
+  /// @param data Source buffer.
+  /// @param len Number of bytes to write.
+  /// @return IN_PROGRESS once the first page is issued, error otherwise.
+  Status startWriteEeprom(uint8_t address, const uint8_t* data, size_t len);
+
+  /// @brief Result of the last asynchronous write, read without bus I/O.
+  /// @return IN_PROGRESS while running, Status::Ok() on completion, error otherwise.
+  Status writeStatus() const { return _asyncStatus; }
+
+  /// @brief Check whether an asynchronous write is still running.
+  /// @return true between startWriteEeprom() and completion or failure.
+  bool writeInProgress() const { return _asyncActive; }
+
+  /// @brief Read the clock the driver times writes with (Config::nowMs or millis()).
+  /// @return Current monotonic milliseconds.
+  uint32_t nowMs() const { return _nowMs(); }
+
+  // Batching
+  /// @brief Run operations recorded in a Batch (AT21CS/Batch.h) under one activation.
+  /// Every operation is validated before bus I/O; reset/discovery runs at most once
+  /// (again after a failure when the batch continues on error), and the batch
+  /// counts as a single tracked operation in the health counters.
+  /// @param batch Recorded operations; receives per-operation results.
+  /// @return Status::Ok() when every operation succeeded, INVALID_PARAM with the
+  ///         operation index in detail when one is invalid, otherwise the first failure.
+  Status runBatch(Batch& batch);
+
+  // Pre-encoded waveforms
+  /// @brief Replay a Waveform (AT21CS/Waveform.h) and capture its sample points.
+  /// Runs reset/discovery when needed, then drives every symbol with the same
+  /// delay engine as the bit primitives, masking interrupts one bit slot at a
+  /// time whatever Config::criticalSection says. The replay does not stop at a
+  /// NACK. Waveforms that write drop the shadow and identity caches; poll the
+  /// write cycle with waitReady().
+  /// @param wave Encoded waveform; receives the sampled levels.
+  /// @return Status::Ok() when every sent byte was acknowledged, the first NACK
+  ///         (Waveform::ackStatus()) otherwise; INVALID_STATE for a waveform
+  ///         encoded for another speed or profile, INVALID_PARAM for an empty,
+  ///         overflowed or speed-changing waveform, WRITE_PROTECTED for a write
+  ///         while Config::romZoneGuard is on.
+  Status runWaveform(Waveform& wave);
+
+  /// @brief Start a waveform that runs from timer alarms (Config::timerPhy).
+  /// Reset/discovery runs synchronously first. Each segment of at least
+  /// Config::timerMinUs is left to a one-shot alarm, so the CPU is free until
+  /// the next edge; shorter segments and sample points are spun inside the
+  /// alarm handler with interrupts masked. The alarm handler only drives and
+  /// samples the line: the tick() after the final alarm decodes the result,
+  /// records it in the health counters and calls done. Other operations
+  /// return INVALID_STATE until then. Without
+  /// Config::timerPhy, and for High-Speed waveforms whose slots are too short
+  /// for alarm latency, the waveform runs synchronously as in runWaveform().
+  /// @param wave Encoded waveform; must stay valid until completion.
+  /// @param done Optional completion callback, called once with the result
+  ///        (from tick() when timer-driven, before returning otherwise).
+  /// @param user Opaque pointer passed to done.
+  /// @return IN_PROGRESS while timer-driven; otherwise the final status, with
+  ///         the same checks as runWaveform().
+  Status startWaveform(Waveform& wave, WaveformDoneFn done = nullptr, void* user = nullptr);
+
+  /// @brief Result of the last startWaveform(), read without bus I/O.
+  /// @return IN_PROGRESS until tick() records the result, the final status otherwise.
+  Status waveformStatus() const { return _phyStatus; }
+
+  /// @brief Check whether a timer-driven waveform is still pending.
+  /// @return true between startWaveform() and the tick() that records its result.
+  bool waveformInProgress() const { return _phyUntracked; }
+
+  /// @brief Advance a timer-driven waveform; called by the alarm backend when
+  /// the delay passed to Config::alarmStart has elapsed (ISR-safe).
+  void onTimerAlarm();
+
   // Security register
   /// @brief Read bytes from the Security register.
   /// @param address Security register start address.
@@ -233,22 +444,34 @@ class Driver {
   /// @return Status::Ok() after all write cycles complete, error otherwise.
   Status writeSecurityUser(uint8_t address, const uint8_t* data, size_t len);
 
+  /// @brief Write Security user bytes and read each page back under one activation.
+  /// Same sequence and results as writeEepromVerified().
+  /// @param address Security user start address (0x10..0x1F).
+  /// @param data Source buffer.
+  /// @param len Number of bytes to write.
+  /// @return Status::Ok() when every byte reads back as written, VERIFY_FAILED
+  ///         with detail = first differing offset from address, error otherwise.
+  Status writeSecurityUserVerified(uint8_t address, const uint8_t* data, size_t len);
+
   /// @brief Permanently lock the Security register.
   /// @return Status::Ok() after the lock write cycle completes, error otherwise.
   Status lockSecurityRegister();
 
   /// @brief Read the Security register lock state.
+  /// With Config::identityCache, a locked result is cached and later calls skip the bus.
   /// @param[out] locked Set true when locked.
   /// @return Status::Ok() on success, error otherwise.
   Status isSecurityLocked(bool& locked);
 
   // IDs
   /// @brief Read and validate the factory serial number.
+  /// With Config::identityCache, a valid serial is cached on first read.
   /// @param[out] serial Serial payload and validation flags.
   /// @return Status::Ok() on read success, error otherwise.
   Status readSerialNumber(SerialNumberInfo& serial);
 
   /// @brief Read the 24-bit manufacturer/device identifier.
+  /// With Config::identityCache, served from the value read by begin()/recover().
   /// @param[out] manufacturerId Raw 24-bit identifier.
   /// @return Status::Ok() on success, error otherwise.
   Status readManufacturerId(uint32_t& manufacturerId);
@@ -281,6 +504,7 @@ class Driver {
   Status freezeRomZones();
 
   /// @brief Check whether ROM-zone configuration is frozen.
+  /// With Config::identityCache, a frozen result is cached and later calls skip the bus.
   /// @param[out] frozen Set true when frozen.
   /// @return Status::Ok() on success, error otherwise.
   Status areRomZonesFrozen(bool& frozen);
@@ -304,6 +528,42 @@ class Driver {
   /// @return Status::Ok() on completed check, error otherwise.
   Status isStandardSpeed(bool& enabled);
 
+  // Timing profiles
+  /// @brief Check a profile against the datasheet limits of a speed mode
+  /// (t_BIT, t_LOW0, t_LOW1, t_RD, t_MRS, t_RCV, t_HTSS). No bus I/O.
+  /// @param profile Profile to check.
+  /// @param mode Speed mode the profile is meant for.
+  /// @return Status::Ok() when usable, INVALID_CONFIG naming the first violated limit.
+  static Status validateTimingProfile(const TimingProfile& profile, SpeedMode mode);
+
+  /// @brief Replace the profile used for one speed mode without begin().
+  /// Takes effect immediately when that mode is active. No bus I/O.
+  /// @param mode Speed mode whose profile is replaced.
+  /// @param profile New profile, checked with validateTimingProfile().
+  /// @return Status::Ok(), INVALID_CONFIG for a profile outside the limits,
+  ///         NOT_INITIALIZED or INVALID_STATE (async write or waveform running).
+  Status setTimingProfile(SpeedMode mode, const TimingProfile& profile);
+
+  /// @brief Sweep bit-slot timing against the attached device and suggest a profile.
+  ///
+  /// Reads the factory serial (CRC-checked) and EEPROM 0x00..0x0F with the
+  /// active profile as a reference, then varies t_BIT, t_LOW0, t_LOW1, t_RD and
+  /// the sample point one at a time, stepping outward from the active value
+  /// until a candidate fails to reproduce the reference. From those pass windows
+  /// it picks the shortest t_BIT, t_LOW0 and t_RD and centred t_LOW1 and sample
+  /// point, each at least marginNs inside its window and within the datasheet
+  /// limits, and verifies the result. No candidate samples past t_MRS. Read-only; takes about two seconds in
+  /// High-Speed. Failed candidates are not counted as health failures. The
+  /// active profile is left unchanged: apply the result with setTimingProfile()
+  /// or Config.
+  /// @param[out] result Pass windows and the suggested profile.
+  /// @param scan Step, margin and repetitions.
+  /// @return Status::Ok() with result.profile set; IO_ERROR (detail = failing
+  ///         parameter index 0..4 in result order, 5 = verification) when no
+  ///         profile fits the margin; the activation or reference-read error otherwise.
+  Status characterizeTiming(TimingScanResult& result,
+                            const TimingScanConfig& scan = TimingScanConfig{});
+
   // Utilities
   /// @brief Compute CRC-8 with polynomial 0x31 over a byte buffer.
   /// @param data Input bytes.
@@ -312,31 +572,17 @@ class Driver {
   static uint8_t crc8_31(const uint8_t* data, size_t len);
 
  private:
-  struct TimingProfile {
-    uint16_t bitUs;
-    uint16_t low0Us;
-    uint16_t low1Us;
-    uint16_t readLowUs;
-    uint16_t readSampleUs;
-    uint16_t htssUs;
-  };
-
-  static constexpr TimingProfile HIGH_SPEED_TIMING = {
-      12,  // bitUs
-      8,   // low0Us
-      1,   // low1Us   (actual ~1.6us with overhead, within t_LOW1 1-2us)
-      1,   // readLowUs
-      1,   // readSampleUs  (sample at t_RD+1 = 2us, within t_MRS ~3us and t_HLD0 min 2us)
-      150  // htssUs
-  };
-
-  static constexpr TimingProfile STANDARD_SPEED_TIMING = {
-      60,  // bitUs
-      32,  // low0Us
-      6,   // low1Us
-      6,   // readLowUs
-      14,  // readSampleUs
-      600  // htssUs
+  // Delays inside one bit slot, precomputed per speed by _updateSegments().
+  enum BitSegment : uint8_t {
+    SEG_LOW0 = 0,
+    SEG_HIGH0,
+    SEG_LOW1,
+    SEG_HIGH1,
+    SEG_READ_LOW,
+    SEG_READ_SAMPLE,
+    SEG_READ_REST,
+    SEG_HTSS,
+    SEG_COUNT
   };
 
   // Reset/discovery timing always uses high-speed table after reset.
@@ -371,25 +617,79 @@ class Driver {
 
   void _sendStart();
   void _sendStop();
+  void _enterCritical();
+  void _exitCritical();
+  void _beginTransactionMask();
+  void _endTransactionMask();
 
   // Protocol helpers (raw operations)
   uint8_t _deviceAddress(uint8_t opcode, bool read) const;
   Status _activateDevice();
+  bool _sessionUsable();
+  Status _waitWriteCycle();
+  Status _waitReadyRaw(uint32_t timeoutMs, bool afterWrite);
+  void _recordWriteCycle(uint32_t elapsedUs);
+  uint32_t _writeCycleHeadUs() const;
+  Status _asyncIssuePage();
+  void _asyncPoll();
+  void _asyncFinish(const Status& st);
   Status _resetAndDiscoverRaw();
   Status _addressOnlyRaw(uint8_t opcode, bool read, bool& ack);
-  Status _readRandomRaw(uint8_t opcode, uint8_t address, uint8_t* data, size_t len);
+  Status _readRandomRaw(uint8_t opcode, uint8_t address, uint8_t* data, size_t len,
+                        ByteSinkFn sink = nullptr, void* user = nullptr);
   Status _writeRaw(uint8_t opcode, uint8_t address, const uint8_t* data, size_t len);
+  Status _writeVerifiedRaw(uint8_t opcode, uint8_t address, const uint8_t* data, size_t len);
+  Status _trackVerified(const Status& st);
   Status _readManufacturerIdRaw(uint32_t& manufacturerId);
-  Status _readCurrentAddressRaw(uint8_t& value);
+  void _cacheManufacturerId(uint32_t manufacturerId);
+  void _cacheSerial(const SerialNumberInfo& serial);
+  Status _revalidateIdentityCache(uint32_t manufacturerId);
+  Status _readRomZoneMaskRaw();
+  int8_t _protectedZone(uint8_t address, size_t len) const;
+  Status _guardRomZones(uint8_t address, size_t len);
+  Status _readCurrentAddressRaw(uint8_t* data, size_t len, ByteSinkFn sink = nullptr,
+                                void* user = nullptr);
+  Status _readEepromRaw(uint8_t address, uint8_t* data, size_t len, ByteSinkFn sink = nullptr,
+                        void* user = nullptr);
+  void _rxBytes(uint8_t* data, size_t len, ByteSinkFn sink, void* user);
+  Status _readShadowed(uint8_t opcode, uint8_t address, uint8_t* data, size_t len);
+  Status _fillShadowRaw(uint8_t opcode, uint8_t address, size_t len);
+  static Status _validateBatchOp(const Batch& batch, uint8_t index);
+  Status _runBatchOp(Batch& batch, uint8_t index, bool& active, bool& usedBus);
+  static Status _checkSerialNumber(SerialNumberInfo& serial);
+  void _updateShadow(uint8_t opcode, uint8_t address, const uint8_t* data, size_t len, bool ok);
+  void _trackAddressPointer(uint8_t opcode, uint8_t next);
 
   // Validation helpers
   static bool _isZoneIndexValid(uint8_t zoneIndex);
   static bool _isSecurityUserAddressValid(uint8_t address);
 
   void _setSpeedMode(SpeedMode mode);
+  const TimingProfile& _profileFor(SpeedMode mode) const;
+  Status _timingTrial(const TimingProfile& candidate, const uint8_t* reference, uint8_t trials,
+                      bool& passed);
+  Status _scanTimingWindow(uint32_t TimingProfile::*field, uint32_t fromNs, uint32_t toNs,
+                           const TimingScanConfig& scan, const uint8_t* reference,
+                           TimingWindow& window, uint32_t& candidates);
   void _resetHealth();
   uint32_t _nowMs() const;
   void _sleepUs(uint32_t us) const;
+  void _yieldUs(uint32_t us) const;
+  void _updateSegments();
+  void _waitSegment(BitSegment segment) const;
+  Status _checkWaveform(const Waveform& wave) const;
+  void _prepareWaveform(Waveform& wave);
+  void _replayWaveform(Waveform& wave);
+  void _waitTicks(uint32_t ticks, uint32_t tickNs) const;
+  bool _waveEdge(bool high, bool low);
+  void _storeWaveSample(Waveform& wave, size_t index) const;
+  void _phyRun();
+  bool _phyFinished() const;
+  Status _setupTimerPhy();
+  void _releaseTimerPhy();
+#if defined(ARDUINO_ARCH_ESP32)
+  void _measureEdgeOverhead();
+#endif
 
  private:
   Config _config{};
@@ -398,7 +698,11 @@ class Driver {
 
   PartType _detectedPart = PartType::UNKNOWN;
   SpeedMode _speedMode = SpeedMode::HIGH_SPEED;
+  // Speed re-applied by activation; survives raw resets that drop the device
+  // back to High-Speed (probe(), resetAndDiscover(), isPresent()).
+  SpeedMode _requestedSpeed = SpeedMode::HIGH_SPEED;
   TimingProfile _timing = HIGH_SPEED_TIMING;
+  uint32_t _segmentUs[SEG_COUNT] = {};
 
   uint32_t _lastOkMs = 0;
   uint32_t _lastErrorMs = 0;
@@ -409,7 +713,74 @@ class Driver {
 
   uint32_t _lastTickMs = 0;
 
+  bool _sessionActive = false;
+  uint32_t _sessionLastMs = 0;
+
+  // Model of the device's shared EEPROM/Security address pointer. Only valid
+  // after a successful EEPROM transaction without an intervening reset/error.
+  bool _addressPointerValid = false;
+  uint8_t _addressPointer = 0;
+
+  // Optional RAM shadow (Config::shadowCache), one validity bit per 8-byte page.
+  uint8_t _shadowEeprom[cmd::EEPROM_SIZE] = {};
+  uint8_t _shadowSecurity[cmd::SECURITY_SIZE] = {};
+  uint16_t _shadowEepromValid = 0;
+  uint8_t _shadowSecurityValid = 0;
+
+  // Factory-immutable and one-way device facts (Config::identityCache). Lock and
+  // freeze are cached only once observed set.
+  uint32_t _cachedManufacturerId = 0;
+  uint8_t _cachedSerial[cmd::SECURITY_SERIAL_SIZE] = {};
+  bool _manufacturerIdCached = false;
+  bool _serialCached = false;
+  bool _securityLockedCached = false;
+  bool _romZonesFrozenCached = false;
+
+  // ROM-zone bitmap for Config::romZoneGuard; zones only ever become ROM.
+  bool _romZoneMaskValid = false;
+  uint8_t _romZoneMask = 0;
+
+  WriteCycleStats _writeCycle{};
+
+  // Interrupt-masking instrumentation (Config::criticalSection).
+  MaskingStats _masking{};
+  bool _masked = false;
+  bool _transactionMasked = false;
+  uint32_t _maskTxnTotalUs = 0;
+  uint32_t _maskTxnMaxUs = 0;
+  mutable uint32_t _maskSleptUs = 0;
+#if defined(ARDUINO_ARCH_ESP32)
+  uint32_t _maskStartCycles = 0;
+#endif
+
+  // Asynchronous write engine driven by tick().
+  uint8_t _asyncData[cmd::EEPROM_SIZE] = {};
+  bool _asyncActive = false;
+  uint8_t _asyncAddress = 0;
+  uint8_t _asyncLen = 0;
+  uint8_t _asyncOffset = 0;
+  uint8_t _asyncChunk = 0;
+  uint32_t _asyncPageStartMs = 0;
+  Status _asyncStatus = Status::Ok();
+
+  // Timer-driven waveform PHY (Config::timerPhy); advanced by onTimerAlarm().
+  // _phyIndex, _phySample, _phyLow and the waveform samples belong to the
+  // alarm handler while _phyActive is set; it clears _phyActive under
+  // _timingMux and the task side reads it back through _phyFinished(). The
+  // other fields are only touched from task context.
+  Waveform* _phyWave = nullptr;
+  WaveformDoneFn _phyDone = nullptr;
+  void* _phyUser = nullptr;
+  size_t _phyIndex = 0;
+  size_t _phySample = 0;
+  bool _phyLow = false;
+  volatile bool _phyActive = false;
+  bool _phyUntracked = false;  // Started; tick() has not recorded the result yet.
+  Status _phyStatus = Status::Ok();
+
 #if defined(ARDUINO_ARCH_ESP32)
+  void* _phyTimer = nullptr;  // gptimer handle when no Config::alarmStart is set.
+  uint32_t _waveCyclesPerTickQ8 = 0;
   mutable portMUX_TYPE _timingMux = portMUX_INITIALIZER_UNLOCKED;
   // Direct-register GPIO for sub-microsecond bit-bang timing.
   volatile uint32_t* _gpioSetReg = nullptr;
@@ -417,6 +788,12 @@ class Driver {
   volatile uint32_t* _gpioInReg = nullptr;
   uint32_t _gpioMask = 0;
   uint32_t _cyclesPerUs = 240;  // CPU cycles per microsecond (cached at begin)
+  // Cycle-domain bit timing: spin lengths net of the measured cost of one
+  // edge plus one _waitSegment() call. Used only with direct GPIO and no
+  // Config::sleepUs hook.
+  bool _cycleTimed = false;
+  uint32_t _edgeOverheadCycles = 0;
+  uint32_t _segmentCycles[SEG_COUNT] = {};
 #endif
 };
 }  // namespace AT21CS
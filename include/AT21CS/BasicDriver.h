@@ -0,0 +1,503 @@
+/// @file BasicDriver.h
+/// @brief Compile-time specialized lean driver for one AT21CS device.
+///
+/// BasicDriver<SpeedPolicy, PresencePolicy, TimingPolicy> fixes the bit timing,
+/// presence check and line/delay primitives at compile time. Every bit-slot
+/// delay is a template constant, so the bit primitives fold to straight-line
+/// edge + spin sequences with no profile loads, hook checks or presence-pin
+/// reads inside the polling loops.
+///
+/// It covers the data path only: reset/discovery, EEPROM and Security reads,
+/// EEPROM page writes, write-ready polling and the manufacturer ID. Health
+/// tracking, sessions, caches, batching and the asynchronous engine stay in
+/// Driver, which remains the runtime-configured driver.
+///
+///     using Board = AT21CS::BasicDriver<AT21CS::HighSpeedPolicy,
+///                                       AT21CS::NoPresencePin,
+///                                       AT21CS::CycleTiming<6, 240>>;
+///     Board eeprom;
+///     eeprom.begin();
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "AT21CS/AT21CS.h"
+#include "AT21CS/CommandTable.h"
+#include "AT21CS/Config.h"
+#include "AT21CS/Status.h"
+
+#if defined(ARDUINO_ARCH_ESP32)
+#include <driver/gpio.h>
+#endif
+
+namespace AT21CS {
+
+// ---------------------------------------------------------------------------
+// Speed policies: a SpeedMode and a constexpr TimingProfile. A profile from
+// Driver::characterizeTiming() can be baked in with a policy of the same shape.
+// ---------------------------------------------------------------------------
+
+/// @brief High-Speed mode with the default profile.
+struct HighSpeedPolicy {
+  static constexpr SpeedMode MODE = SpeedMode::HIGH_SPEED;
+  static constexpr TimingProfile TIMING = HIGH_SPEED_TIMING;
+};
+
+/// @brief Standard Speed mode (AT21CS01 only) with the default profile.
+struct StandardSpeedPolicy {
+  static constexpr SpeedMode MODE = SpeedMode::STANDARD_SPEED;
+  static constexpr TimingProfile TIMING = STANDARD_SPEED_TIMING;
+};
+
+// ---------------------------------------------------------------------------
+// Presence policies: present() is consulted once per operation.
+// ---------------------------------------------------------------------------
+
+/// @brief No presence pin; the check folds away.
+struct NoPresencePin {
+  static constexpr bool present() { return true; }
+};
+
+#if defined(ARDUINO_ARCH_ESP32)
+/// @brief Presence pin read straight from the GPIO input register.
+template <uint8_t Pin, bool ActiveHigh = true>
+struct GpioPresencePin {
+  static_assert(Pin < 64, "presence pin must be 0..63");
+
+  static bool present() {
+    const uint32_t in = (Pin < 32U) ? REG_READ(GPIO_IN_REG) : REG_READ(GPIO_IN1_REG);
+    const bool high = (in & (1UL << (Pin % 32U))) != 0U;
+    return high == ActiveHigh;
+  }
+};
+#endif
+
+// ---------------------------------------------------------------------------
+// Timing policies: line access, delays and interrupt masking.
+// ---------------------------------------------------------------------------
+
+/// @brief Line and delays through Config-style hooks (host simulation, test rigs).
+/// Delays are truncated to whole microseconds, as in Driver with Config::sleepUs.
+struct HookTiming {
+  LineWriteFn lineWrite = nullptr;
+  LineReadFn lineRead = nullptr;
+  void* lineUser = nullptr;
+  SleepUsFn sleepUs = nullptr;
+  void* timeUser = nullptr;
+
+  Status configure() {
+    if (lineWrite == nullptr || lineRead == nullptr || sleepUs == nullptr) {
+      return Status::Error(Err::INVALID_CONFIG, "lineWrite, lineRead and sleepUs are required");
+    }
+    lineWrite(false, lineUser);
+    return Status::Ok();
+  }
+  void lineLow() const { lineWrite(true, lineUser); }
+  void release() const { lineWrite(false, lineUser); }
+  bool read() const { return lineRead(lineUser); }
+  template <uint32_t Ns>
+  void wait() const {
+    if constexpr (Ns >= 1000U) {
+      sleepUs(Ns / 1000U, timeUser);
+    }
+  }
+  void waitUs(uint32_t us) const { sleepUs(us, timeUser); }
+  void enterCritical() {}
+  void exitCritical() {}
+};
+
+#if defined(ARDUINO_ARCH_ESP32)
+/// @brief Direct GPIO registers and CPU-cycle spins for a fixed pin and clock.
+/// @tparam SioPin SI/O GPIO (0..63).
+/// @tparam CpuMhz CPU frequency the firmware runs at.
+/// @tparam EdgeOverheadCycles Cost of one edge plus loop entry, removed from every
+///         delay; SettingsSnapshot::edgeOverheadCycles from a Driver on the same
+///         build is a good value.
+template <uint8_t SioPin, uint32_t CpuMhz = 240, uint32_t EdgeOverheadCycles = 0>
+struct CycleTiming {
+  static_assert(SioPin < 64, "SI/O pin must be 0..63");
+  static_assert(CpuMhz > 0, "CPU frequency must be > 0");
+
+  static constexpr uint32_t MASK = 1UL << (SioPin % 32U);
+
+  Status configure() {
+    gpio_config_t sioCfg{};
+    sioCfg.pin_bit_mask = (1ULL << SioPin);
+    sioCfg.mode = GPIO_MODE_INPUT_OUTPUT_OD;
+    sioCfg.pull_up_en = GPIO_PULLUP_DISABLE;
+    sioCfg.pull_down_en = GPIO_PULLDOWN_DISABLE;
+    sioCfg.intr_type = GPIO_INTR_DISABLE;
+    if (gpio_config(&sioCfg) != ESP_OK) {
+      return Status::Error(Err::INVALID_CONFIG, "Failed to configure sioPin", SioPin);
+    }
+    release();
+    return Status::Ok();
+  }
+  AT21CS_IRAM void lineLow() const {
+    REG_WRITE((SioPin < 32U) ? GPIO_OUT_W1TC_REG : GPIO_OUT1_W1TC_REG, MASK);
+  }
+  AT21CS_IRAM void release() const {
+    REG_WRITE((SioPin < 32U) ? GPIO_OUT_W1TS_REG : GPIO_OUT1_W1TS_REG, MASK);
+  }
+  AT21CS_IRAM bool read() const {
+    return (REG_READ((SioPin < 32U) ? GPIO_IN_REG : GPIO_IN1_REG) & MASK) != 0U;
+  }
+  template <uint32_t Ns>
+  AT21CS_IRAM void wait() const {
+    constexpr uint64_t cycles = static_cast<uint64_t>(Ns) * CpuMhz / 1000U;
+    if constexpr (cycles > EdgeOverheadCycles) {
+      const uint32_t start = esp_cpu_get_cycle_count();
+      while ((esp_cpu_get_cycle_count() - start) < static_cast<uint32_t>(cycles - EdgeOverheadCycles)) {}
+    }
+  }
+  void waitUs(uint32_t us) const {
+    const uint32_t start = esp_cpu_get_cycle_count();
+    while ((esp_cpu_get_cycle_count() - start) < us * CpuMhz) {}
+  }
+  AT21CS_IRAM void enterCritical() { portENTER_CRITICAL(&_mux); }
+  AT21CS_IRAM void exitCritical() { portEXIT_CRITICAL(&_mux); }
+
+ private:
+  portMUX_TYPE _mux = portMUX_INITIALIZER_UNLOCKED;
+};
+#endif
+
+/// @brief Lean AT21CS driver specialized at compile time.
+///
+/// Every operation runs reset/discovery first (and re-enters Standard Speed
+/// when SpeedPolicy asks for it), then one transaction, one byte per
+/// interrupt-masked section. Write-ready polling is bounded by accounted bus
+/// time, so no clock source is needed. Not thread-safe.
+template <class SpeedPolicy, class PresencePolicy = NoPresencePin,
+          class TimingPolicy = HookTiming>
+class BasicDriver {
+ public:
+  static constexpr TimingProfile TIMING = SpeedPolicy::TIMING;
+  static constexpr SpeedMode MODE = SpeedPolicy::MODE;
+
+  static_assert(TIMING.low1Ns < TIMING.low0Ns, "t_LOW1 must be shorter than t_LOW0");
+  static_assert(TIMING.low0Ns < TIMING.bitNs, "t_LOW0 must leave high time in t_BIT");
+  static_assert(TIMING.readLowNs + TIMING.readSampleNs < TIMING.bitNs,
+                "read sample point must fall inside t_BIT");
+  static_assert(TIMING.readLowNs + TIMING.readSampleNs <=
+                    (MODE == SpeedMode::HIGH_SPEED ? 2000U : 8000U),
+                "read sample point must not pass t_MRS");
+
+  /// @param timing Line/delay policy instance (hooks for HookTiming).
+  /// @param addressBits Device address bits A2:A0 (0-7).
+  /// @param presence Presence policy instance.
+  explicit BasicDriver(const TimingPolicy& timing = TimingPolicy{}, uint8_t addressBits = 0,
+                       const PresencePolicy& presence = PresencePolicy{})
+      : _timing(timing), _presence(presence), _addressBits(static_cast<uint8_t>(addressBits & 0x07U)) {}
+
+  /// @brief Configure the line and discover the device in SpeedPolicy's mode.
+  /// @return Status::Ok() on success, error otherwise.
+  Status begin() {
+    const Status st = _timing.configure();
+    if (!st.ok()) {
+      return st;
+    }
+    return _activate();
+  }
+
+  /// @brief Issue a reset and discovery sequence (leaves the device in High-Speed).
+  /// @return Status::Ok() when discovery succeeds, error otherwise.
+  Status resetAndDiscover() {
+    if (!_presence.present()) {
+      return Status::Error(Err::NOT_PRESENT, "Presence pin indicates device absent");
+    }
+    _timing.lineLow();
+    _timing.template wait<DISCHARGE_LOW_NS>();
+    _timing.release();
+    _timing.template wait<RESET_RECOVERY_NS>();
+
+    _timing.enterCritical();
+    _timing.lineLow();
+    _timing.template wait<DISCOVERY_REQUEST_NS>();
+    _timing.release();
+    _timing.template wait<DISCOVERY_STROBE_DELAY_NS>();
+    _timing.lineLow();
+    _timing.template wait<DISCOVERY_STROBE_NS>();
+    _timing.release();
+    _timing.template wait<DISCOVERY_SAMPLE_DELAY_NS>();
+    const bool present = !_timing.read();
+    _timing.exitCritical();
+
+    _timing.template wait<HIGH_SPEED_TIMING.htssNs>();
+    if (!present) {
+      return Status::Error(Err::DISCOVERY_FAILED, "Discovery response not detected");
+    }
+    return Status::Ok();
+  }
+
+  /// @brief Read EEPROM bytes with one random read.
+  /// @param address Start address in the 128-byte EEPROM area.
+  /// @param[out] data Destination buffer.
+  /// @param len Number of bytes to read.
+  /// @return Status::Ok() on success, error otherwise.
+  Status readEeprom(uint8_t address, uint8_t* data, size_t len) {
+    return _read(cmd::OPCODE_EEPROM, address, data, len, cmd::EEPROM_SIZE);
+  }
+
+  /// @brief Read bytes from the Security register.
+  /// @param address Security register start address.
+  /// @param[out] data Destination buffer.
+  /// @param len Number of bytes to read.
+  /// @return Status::Ok() on success, error otherwise.
+  Status readSecurity(uint8_t address, uint8_t* data, size_t len) {
+    return _read(cmd::OPCODE_SECURITY, address, data, len, cmd::SECURITY_SIZE);
+  }
+
+  /// @brief Write bytes within one EEPROM page and wait for the write cycle.
+  /// @param address Start address.
+  /// @param data Source buffer.
+  /// @param len Number of bytes (1..8, must not cross a page).
+  /// @param timeoutMs Write-cycle budget in accounted bus time, 1..250 ms.
+  /// @return Status::Ok() after the write cycle completes, error otherwise.
+  Status writeEepromPage(uint8_t address, const uint8_t* data, size_t len,
+                         uint32_t timeoutMs = 25) {
+    if (data == nullptr) {
+      return Status::Error(Err::INVALID_PARAM, "EEPROM write buffer is null");
+    }
+    if (len == 0 || static_cast<size_t>(address) >= cmd::EEPROM_SIZE ||
+        (address % cmd::PAGE_SIZE) + len > cmd::PAGE_SIZE) {
+      return Status::Error(Err::INVALID_PARAM, "EEPROM page write must stay within one page");
+    }
+    Status st = _activate();
+    if (!st.ok()) {
+      return st;
+    }
+
+    _sendStart();
+    if (!txByte(_deviceAddress(cmd::OPCODE_EEPROM, false))) {
+      _sendStop();
+      return Status::Error(Err::NACK_DEVICE_ADDRESS, "Device address NACK");
+    }
+    if (!txByte(address)) {
+      _sendStop();
+      return Status::Error(Err::NACK_MEMORY_ADDRESS, "Memory address NACK");
+    }
+    for (size_t i = 0; i < len; ++i) {
+      if (!txByte(data[i])) {
+        _sendStop();
+        return Status::Error(Err::NACK_DATA, "Data byte NACK", static_cast<int32_t>(i));
+      }
+    }
+    _sendStop();
+    return waitReady(timeoutMs);
+  }
+
+  /// @brief ACK-poll until the device accepts its address again.
+  /// @param timeoutMs Budget in accounted bus time, 1..250 ms.
+  /// @return Status::Ok() when ready, BUSY_TIMEOUT when the budget is spent.
+  Status waitReady(uint32_t timeoutMs = 25) {
+    if (timeoutMs == 0 || timeoutMs > 250U) {
+      return Status::Error(Err::INVALID_PARAM, "timeoutMs must be 1..250");
+    }
+    if (!_presence.present()) {
+      return Status::Error(Err::NOT_PRESENT, "Presence pin indicates device absent");
+    }
+    const uint32_t budgetUs = timeoutMs * 1000U;
+    for (uint32_t elapsedUs = 0; elapsedUs < budgetUs; elapsedUs += POLL_US + READY_POLL_INTERVAL_US) {
+      _sendStart();
+      const bool ack = txByte(_deviceAddress(cmd::OPCODE_EEPROM, false));
+      _sendStop();
+      if (ack) {
+        return Status::Ok();
+      }
+      _timing.waitUs(READY_POLL_INTERVAL_US);
+    }
+    return Status::Error(Err::BUSY_TIMEOUT, "Device did not become ready");
+  }
+
+  /// @brief Read the 24-bit manufacturer/device identifier.
+  /// @param[out] manufacturerId Raw 24-bit identifier.
+  /// @return Status::Ok() on success, error otherwise.
+  Status readManufacturerId(uint32_t& manufacturerId) {
+    Status st = _activate();
+    if (!st.ok()) {
+      return st;
+    }
+    _sendStart();
+    if (!txByte(_deviceAddress(cmd::OPCODE_MANUFACTURER_ID, true))) {
+      _sendStop();
+      return Status::Error(Err::NACK_DEVICE_ADDRESS, "Manufacturer ID command NACK");
+    }
+    const uint8_t b0 = rxByte(true);
+    const uint8_t b1 = rxByte(true);
+    const uint8_t b2 = rxByte(false);
+    _sendStop();
+    manufacturerId = (static_cast<uint32_t>(b0) << 16U) | (static_cast<uint32_t>(b1) << 8U) |
+                     static_cast<uint32_t>(b2);
+    return Status::Ok();
+  }
+
+  /// @brief Transmit one logic-0 bit.
+  AT21CS_IRAM void txBit0() { _txBit0<SpeedPolicy>(); }
+
+  /// @brief Transmit one logic-1 bit.
+  AT21CS_IRAM void txBit1() { _txBit1<SpeedPolicy>(); }
+
+  /// @brief Receive one bit.
+  /// @return Sampled bit value.
+  AT21CS_IRAM bool rxBit() {
+    _timing.lineLow();
+    _timing.template wait<TIMING.readLowNs>();
+    _timing.release();
+    _timing.template wait<TIMING.readSampleNs>();
+    const bool bit = _timing.read();
+    _timing.template wait<TIMING.bitNs - TIMING.readLowNs - TIMING.readSampleNs>();
+    return bit;
+  }
+
+  /// @brief Transmit one byte MSB-first and read the ACK slot.
+  /// @param value Byte to send.
+  /// @return true when the device ACKed.
+  AT21CS_IRAM bool txByte(uint8_t value) { return _txByte<SpeedPolicy>(value); }
+
+  /// @brief Receive one byte MSB-first and send ACK or NACK.
+  /// @param ack true to ACK, false to NACK.
+  /// @return Received byte.
+  AT21CS_IRAM uint8_t rxByte(bool ack) {
+    _timing.enterCritical();
+    uint8_t value = 0;
+    for (int8_t bit = 7; bit >= 0; --bit) {
+      if (rxBit()) {
+        value = static_cast<uint8_t>(value | static_cast<uint8_t>(1U << bit));
+      }
+    }
+    if (ack) {
+      txBit0();
+    } else {
+      txBit1();
+    }
+    _timing.exitCritical();
+    return value;
+  }
+
+  /// @return The timing policy instance.
+  TimingPolicy& timing() { return _timing; }
+
+ private:
+  // Reset/discovery sequence, identical to Driver's (always High-Speed).
+  static constexpr uint32_t DISCHARGE_LOW_NS = 150000;
+  static constexpr uint32_t RESET_RECOVERY_NS = 10000;
+  static constexpr uint32_t DISCOVERY_REQUEST_NS = 1000;
+  static constexpr uint32_t DISCOVERY_STROBE_DELAY_NS = 2000;
+  static constexpr uint32_t DISCOVERY_STROBE_NS = 2000;
+  static constexpr uint32_t DISCOVERY_SAMPLE_DELAY_NS = 1000;
+  static constexpr uint32_t READY_POLL_INTERVAL_US = 100;
+  // One ACK poll: Start, address byte + ACK slot, Stop.
+  static constexpr uint32_t POLL_US = (2U * TIMING.htssNs + 9U * TIMING.bitNs) / 1000U;
+
+  uint8_t _deviceAddress(uint8_t opcode, bool read) const {
+    return cmd::deviceAddress(opcode, _addressBits, read);
+  }
+
+  // Transmit primitives take the speed as a parameter so activation can send
+  // the Standard Speed command with High-Speed timing.
+  template <class Speed>
+  AT21CS_IRAM void _txBit0() {
+    _timing.lineLow();
+    _timing.template wait<Speed::TIMING.low0Ns>();
+    _timing.release();
+    _timing.template wait<Speed::TIMING.bitNs - Speed::TIMING.low0Ns>();
+  }
+
+  template <class Speed>
+  AT21CS_IRAM void _txBit1() {
+    _timing.lineLow();
+    _timing.template wait<Speed::TIMING.low1Ns>();
+    _timing.release();
+    _timing.template wait<Speed::TIMING.bitNs - Speed::TIMING.low1Ns>();
+  }
+
+  template <class Speed>
+  AT21CS_IRAM bool _txByte(uint8_t value) {
+    _timing.enterCritical();
+    for (int8_t bit = 7; bit >= 0; --bit) {
+      if (((value >> bit) & 0x01U) != 0U) {
+        _txBit1<Speed>();
+      } else {
+        _txBit0<Speed>();
+      }
+    }
+    // ACK slot with the same speed's read strobe.
+    _timing.lineLow();
+    _timing.template wait<Speed::TIMING.readLowNs>();
+    _timing.release();
+    _timing.template wait<Speed::TIMING.readSampleNs>();
+    const bool ack = !_timing.read();
+    _timing.template wait<Speed::TIMING.bitNs - Speed::TIMING.readLowNs -
+                          Speed::TIMING.readSampleNs>();
+    _timing.exitCritical();
+    return ack;
+  }
+
+  template <class Speed = SpeedPolicy>
+  AT21CS_IRAM void _sendStart() {
+    _timing.release();
+    _timing.template wait<Speed::TIMING.htssNs>();
+  }
+
+  template <class Speed = SpeedPolicy>
+  AT21CS_IRAM void _sendStop() {
+    _timing.release();
+    _timing.template wait<Speed::TIMING.htssNs>();
+  }
+
+  Status _activate() {
+    Status st = resetAndDiscover();
+    if (!st.ok() || MODE != SpeedMode::STANDARD_SPEED) {
+      return st;
+    }
+    // Discovery leaves the device in High-Speed; switch with High-Speed bit timing.
+    _sendStart<HighSpeedPolicy>();
+    const bool ack = _txByte<HighSpeedPolicy>(_deviceAddress(cmd::OPCODE_STANDARD_SPEED, false));
+    _sendStop<HighSpeedPolicy>();
+    if (!ack) {
+      return Status::Error(Err::NACK_DEVICE_ADDRESS, "Standard Speed command NACK during activation");
+    }
+    return Status::Ok();
+  }
+
+  Status _read(uint8_t opcode, uint8_t address, uint8_t* data, size_t len, size_t size) {
+    if (data == nullptr) {
+      return Status::Error(Err::INVALID_PARAM, "Read buffer is null");
+    }
+    if (len == 0 || static_cast<size_t>(address) >= size || len > size - address) {
+      return Status::Error(Err::INVALID_PARAM, "Read range out of bounds");
+    }
+    Status st = _activate();
+    if (!st.ok()) {
+      return st;
+    }
+
+    _sendStart();
+    if (!txByte(_deviceAddress(opcode, false))) {
+      _sendStop();
+      return Status::Error(Err::NACK_DEVICE_ADDRESS, "Device address NACK");
+    }
+    if (!txByte(address)) {
+      _sendStop();
+      return Status::Error(Err::NACK_MEMORY_ADDRESS, "Memory address NACK");
+    }
+    _sendStart();
+    if (!txByte(_deviceAddress(opcode, true))) {
+      _sendStop();
+      return Status::Error(Err::NACK_DEVICE_ADDRESS, "Device address NACK");
+    }
+    for (size_t i = 0; i < len; ++i) {
+      data[i] = rxByte(i + 1U < len);
+    }
+    _sendStop();
+    return Status::Ok();
+  }
+
+  TimingPolicy _timing;
+  PresencePolicy _presence;
+  uint8_t _addressBits;
+};
+
+}  // namespace AT21CS
@@ -0,0 +1,124 @@
+/// @file Batch.h
+/// @brief Records a sequence of driver operations to run under one device activation.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "AT21CS/AT21CS.h"
+#include "AT21CS/Status.h"
+
+namespace AT21CS {
+
+/// @brief Maximum number of operations recorded in one Batch.
+static constexpr uint8_t BATCH_MAX_OPS = 16;
+
+/// @brief Operation list executed by Driver::runBatch().
+///
+/// Recording performs no bus I/O and copies no data: buffers and output
+/// references must stay valid until runBatch() returns. runBatch() validates
+/// every operation, runs reset/discovery at most once, executes the operations
+/// back to back, and records one health outcome for the whole batch. Page
+/// writes wait for their own write cycle before the next operation starts.
+class Batch {
+ public:
+  /// @brief Record an EEPROM read (shadow-cache hits cost no bus time).
+  /// @param address Start address in the 128-byte EEPROM area.
+  /// @param[out] data Destination buffer.
+  /// @param len Number of bytes to read.
+  /// @return Status::Ok() when recorded, INVALID_STATE when the batch is full.
+  Status readEeprom(uint8_t address, uint8_t* data, size_t len);
+
+  /// @brief Record a Security register read.
+  /// @param address Security register start address.
+  /// @param[out] data Destination buffer.
+  /// @param len Number of bytes to read.
+  /// @return Status::Ok() when recorded, INVALID_STATE when the batch is full.
+  Status readSecurity(uint8_t address, uint8_t* data, size_t len);
+
+  /// @brief Record a single-page EEPROM write followed by its write-cycle wait.
+  /// @param address EEPROM start address.
+  /// @param data Source buffer.
+  /// @param len Number of bytes, 1..8 within one page.
+  /// @return Status::Ok() when recorded, INVALID_STATE when the batch is full.
+  Status writeEepromPage(uint8_t address, const uint8_t* data, size_t len);
+
+  /// @brief Record a single-page Security user write followed by its write-cycle wait.
+  /// @param address Security user start address (0x10..0x1F).
+  /// @param data Source buffer.
+  /// @param len Number of bytes, 1..8 within one page.
+  /// @return Status::Ok() when recorded, INVALID_STATE when the batch is full.
+  Status writeSecurityUserPage(uint8_t address, const uint8_t* data, size_t len);
+
+  /// @brief Record a bounded write-ready poll (see Driver::waitReady()).
+  /// @param timeoutMs Timeout in milliseconds, range 1..250.
+  /// @return Status::Ok() when recorded, INVALID_STATE when the batch is full.
+  Status waitReady(uint32_t timeoutMs);
+
+  /// @brief Record a 24-bit manufacturer ID read.
+  /// @param[out] manufacturerId Receives the raw identifier.
+  /// @return Status::Ok() when recorded, INVALID_STATE when the batch is full.
+  Status readManufacturerId(uint32_t& manufacturerId);
+
+  /// @brief Record a factory serial number read with product-ID and CRC checks.
+  /// @param[out] serial Receives the serial payload and validation flags.
+  /// @return Status::Ok() when recorded, INVALID_STATE when the batch is full.
+  Status readSerialNumber(SerialNumberInfo& serial);
+
+  /// @brief Keep running the remaining operations after one fails.
+  /// When off (default), later operations are skipped with INVALID_STATE.
+  /// @param enabled true to continue, re-activating the device first.
+  void setContinueOnError(bool enabled) { _continueOnError = enabled; }
+
+  /// @brief Remove all recorded operations and results.
+  void clear();
+
+  /// @return Number of recorded operations.
+  uint8_t size() const { return _count; }
+
+  /// @brief Result of one operation from the last runBatch().
+  /// @param index Operation index in recording order.
+  /// @return Operation status, INVALID_STATE when not run, INVALID_PARAM for a bad index.
+  Status status(uint8_t index) const;
+
+  /// @return Number of operations that failed in the last runBatch().
+  uint8_t failedOps() const { return _failedOps; }
+
+  /// @return Index of the first failed operation, or -1 when none failed.
+  int8_t firstFailedIndex() const { return _firstFailed; }
+
+ private:
+  friend class Driver;
+
+  enum class OpType : uint8_t {
+    READ_EEPROM,
+    READ_SECURITY,
+    WRITE_EEPROM_PAGE,
+    WRITE_SECURITY_PAGE,
+    WAIT_READY,
+    READ_MANUFACTURER_ID,
+    READ_SERIAL_NUMBER
+  };
+
+  struct Op {
+    OpType type;
+    uint8_t address;
+    uint8_t len;
+    uint32_t timeoutMs;
+    uint8_t* in;
+    const uint8_t* out;
+    uint32_t* id;
+    SerialNumberInfo* serial;
+  };
+
+  Status _add(const Op& op);
+
+  Op _ops[BATCH_MAX_OPS] = {};
+  Status _status[BATCH_MAX_OPS] = {};
+  uint8_t _count = 0;
+  uint8_t _failedOps = 0;
+  int8_t _firstFailed = -1;
+  bool _continueOnError = false;
+};
+
+}  // namespace AT21CS
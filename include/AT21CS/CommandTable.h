@@ -18,6 +18,12 @@ static constexpr uint8_t OPCODE_ROM_ZONE = 0x07;
 static constexpr uint8_t OPCODE_FREEZE_ROM = 0x01;
 static constexpr uint8_t OPCODE_LOCK_SECURITY = 0x02;
 
+// Device address byte: opcode in bits 7:4, A2:A0 in bits 3:1, R/W in bit 0.
+constexpr uint8_t deviceAddress(uint8_t opcode, uint8_t addressBits, bool read) {
+  return static_cast<uint8_t>((opcode << 4U) | ((addressBits & 0x07U) << 1U) |
+                              (read ? 0x01U : 0x00U));
+}
+
 // Memory sizes.
 static constexpr size_t EEPROM_SIZE = 128;
 static constexpr size_t SECURITY_SIZE = 32;
@@ -38,6 +44,7 @@ static constexpr uint32_t MANUFACTURER_ID_AT21CS11 = 0x00D380;
 static constexpr uint8_t ROM_ZONE_REGISTER_COUNT = 4;
 static constexpr uint8_t ROM_ZONE_REGISTERS[ROM_ZONE_REGISTER_COUNT] = {0x01, 0x02, 0x04, 0x08};
 static constexpr uint8_t ROM_ZONE_ROM_VALUE = 0xFF;
+static constexpr size_t ROM_ZONE_SIZE = EEPROM_SIZE / ROM_ZONE_REGISTER_COUNT;
 
 // Freeze ROM command payload.
 static constexpr uint8_t FREEZE_ROM_ADDR = 0x55;
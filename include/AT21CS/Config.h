@@ -19,6 +19,48 @@ enum class SpeedMode : uint8_t {
   STANDARD_SPEED
 };
 
+/// @brief Scope of each interrupt-masked (critical) section while bit-banging.
+enum class CriticalSection : uint8_t {
+  PER_BIT = 0,      ///< Mask one bit slot at a time: lowest interrupt latency.
+  PER_BYTE,         ///< Mask one byte plus its ACK/NACK slot (default).
+  PER_TRANSACTION   ///< Mask from after Start to before Stop: no preemption inside a frame.
+};
+
+/// @brief Bit-slot timing for one speed mode, in nanoseconds.
+///
+/// Config::sleepUs hooks and host builds receive whole microseconds
+/// (truncated); the ESP32 cycle engine uses the full resolution. Plain data, so
+/// a profile from Driver::characterizeTiming() can be kept per board (a
+/// constant, NVS) and passed back through Config.
+struct TimingProfile {
+  uint32_t bitNs;         ///< Bit frame, t_BIT.
+  uint32_t low0Ns;        ///< Low time for a '0', t_LOW0.
+  uint32_t low1Ns;        ///< Low time for a '1', t_LOW1.
+  uint32_t readLowNs;     ///< Read strobe low time, t_RD.
+  uint32_t readSampleNs;  ///< Strobe release to sample, within t_MRS.
+  uint32_t htssNs;        ///< Start/Stop high time, t_HTSS.
+};
+
+/// @brief Default High-Speed timing.
+inline constexpr TimingProfile HIGH_SPEED_TIMING = {
+    12000,  // bitNs
+    8000,   // low0Ns
+    1500,   // low1Ns   (centre of t_LOW1 1-2us)
+    1000,   // readLowNs  (t_RD min 1us)
+    1000,   // readSampleNs  (sample 2us after the fall: t_MRS max, t_HLD0 min)
+    150000  // htssNs
+};
+
+/// @brief Default Standard Speed timing (AT21CS01 only).
+inline constexpr TimingProfile STANDARD_SPEED_TIMING = {
+    60000,  // bitNs
+    32000,  // low0Ns
+    6000,   // low1Ns
+    6000,   // readLowNs  (t_RD 4-8us)
+    1000,   // readSampleNs  (sample 7us after the fall: within t_MRS 8us, t_HLD0 min 8us)
+    600000  // htssNs
+};
+
 /// Millisecond timestamp callback.
 /// @param user User context pointer passed through from Config
 /// @return Current monotonic milliseconds
@@ -29,6 +71,24 @@ using NowMsFn = uint32_t (*)(void* user);
 /// @param user User context pointer passed through from Config
 using SleepUsFn = void (*)(uint32_t us, void* user);
 
+/// SI/O line drive callback for a custom PHY backend.
+/// @param low true to pull the line low, false to release it
+/// @param user User context pointer passed through from Config
+using LineWriteFn = void (*)(bool low, void* user);
+
+/// SI/O line sample callback for a custom PHY backend.
+/// @param user User context pointer passed through from Config
+/// @return true when the line reads HIGH
+using LineReadFn = bool (*)(void* user);
+
+/// One-shot alarm callback for the timer-driven waveform PHY.
+/// Called with the driver's interrupt mask held, from startWaveform() and from
+/// the alarm handler, so it must only arm the timer.
+/// @param delayUs Microseconds from now until the alarm; the backend then calls
+///        Driver::onTimerAlarm(), typically from its timer ISR
+/// @param user User context pointer passed through from Config
+using AlarmStartFn = void (*)(uint32_t delayUs, void* user);
+
 /// @brief Driver configuration.
 struct Config {
   /// SI/O GPIO pin used by this device instance (required).
@@ -60,6 +120,58 @@ struct Config {
   /// Desired speed mode after begin() (AT21CS11 only supports HIGH_SPEED).
   SpeedMode startupSpeed = SpeedMode::HIGH_SPEED;
 
+  /// Keep the device activated between operations instead of running
+  /// reset/discovery before every transaction. The session is dropped after any
+  /// failed operation, a presence-pin absence, or sessionIdleTimeoutMs without
+  /// bus activity; the next operation then re-activates the device.
+  bool persistentSession = false;
+
+  /// Idle time after which a persistent session is re-activated (0 = never expires).
+  uint32_t sessionIdleTimeoutMs = 1000;
+
+  /// Learn this device's write-cycle time and, after a write, yield to other
+  /// tasks for most of it before the first ACK poll, then poll with a short
+  /// doubling backoff instead of the fixed 100 us cadence.
+  bool adaptiveWritePolling = false;
+
+  /// Keep a RAM shadow of the 128-byte EEPROM and 32-byte Security register.
+  /// Reads of fully cached pages return without bus I/O; misses fill whole pages.
+  bool shadowCache = false;
+
+  /// Cache the manufacturer ID, factory serial number, and the one-way Security
+  /// lock and ROM-freeze states once read, so later reads need no bus I/O.
+  /// recover() re-reads the IDs and drops the cache when a different device answers.
+  bool identityCache = false;
+
+  /// Reject EEPROM writes into ROM zones with Err::WRITE_PROTECTED before any bus
+  /// I/O. The four ROM-zone registers are read once, on the first write after
+  /// begin()/recover(), and the bitmap is updated by setZoneRom().
+  bool romZoneGuard = false;
+
+  /// High-Speed bit timing. begin() rejects profiles outside the datasheet
+  /// limits (Driver::validateTimingProfile()); Driver::characterizeTiming()
+  /// measures a board-specific one.
+  TimingProfile highSpeedTiming = HIGH_SPEED_TIMING;
+
+  /// Standard Speed bit timing; see highSpeedTiming.
+  TimingProfile standardSpeedTiming = STANDARD_SPEED_TIMING;
+
+  /// Interrupt-masking granularity. PER_TRANSACTION keeps write streams from
+  /// being stretched into a false Stop by preemption, at the cost of masking
+  /// interrupts for a whole frame (about 1.2 ms for a 128-byte High-Speed read).
+  CriticalSection criticalSection = CriticalSection::PER_BYTE;
+
+  /// Run Standard Speed waveforms from Driver::startWaveform() on one-shot
+  /// timer alarms instead of spinning through every segment. Segments shorter
+  /// than timerMinUs are still spun inside the alarm handler; High-Speed
+  /// waveforms always fall back to the spin replay. Uses alarmStart when set,
+  /// otherwise a built-in gptimer (ESP32 with ESP-IDF 5).
+  bool timerPhy = false;
+
+  /// Shortest segment handed to the timer, range 2..1000 us. Keep it above the
+  /// alarm interrupt latency of the target.
+  uint16_t timerMinUs = 20;
+
   /// Optional monotonic millisecond source.
   /// If null, driver falls back to Arduino millis().
   NowMsFn nowMs = nullptr;
@@ -70,6 +182,23 @@ struct Config {
 
   /// User context for timing callbacks.
   void* timeUser = nullptr;
+
+  /// Optional SI/O line backend (host simulation, GPIO expanders, test rigs).
+  /// Set both or neither; when set, begin() skips SI/O GPIO setup and every
+  /// edge and sample goes through these hooks. sioPin still identifies the line.
+  LineWriteFn lineWrite = nullptr;
+
+  /// Optional SI/O line sample hook; see lineWrite.
+  LineReadFn lineRead = nullptr;
+
+  /// User context for line callbacks.
+  void* lineUser = nullptr;
+
+  /// Optional one-shot alarm backend for timerPhy (custom timers, host tests).
+  AlarmStartFn alarmStart = nullptr;
+
+  /// User context for alarmStart.
+  void* alarmUser = nullptr;
 };
 
 }  // namespace AT21CS
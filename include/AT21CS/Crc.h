@@ -0,0 +1,189 @@
+/// @file Crc.h
+/// @brief Table-driven CRC-8/0x31, CRC-16/CCITT-FALSE, and CRC-32 (IEEE 802.3) engines.
+///
+/// Lookup tables are generated at compile time. Every algorithm has an
+/// incremental form that carries the raw CRC register between calls:
+///
+///     uint32_t state = crc::CRC32_INIT;
+///     state = crc::crc32Update(state, header, 8);
+///     state = crc::crc32Update(state, payload, 24);
+///     const uint32_t crc = crc::crc32Final(state);
+///
+/// CRC-32 uses slice-by-4 (4 KiB of tables). Define AT21CS_CRC_USE_ROM=1 on
+/// ESP32 to route CRC-32 through the ROM routine instead.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#ifndef AT21CS_CRC_USE_ROM
+#define AT21CS_CRC_USE_ROM 0
+#endif
+
+#if AT21CS_CRC_USE_ROM && defined(ARDUINO_ARCH_ESP32)
+#include <esp_rom_crc.h>
+#endif
+
+namespace AT21CS {
+namespace crc {
+
+/// @brief Initial CRC-8/0x31 register (Security serial checksum, reflected 0x8C).
+static constexpr uint8_t CRC8_31_INIT = 0x00;
+/// @brief Initial CRC-16/CCITT-FALSE register; the result needs no final XOR.
+static constexpr uint16_t CRC16_CCITT_INIT = 0xFFFF;
+/// @brief Initial CRC-32 register; finish with crc32Final().
+static constexpr uint32_t CRC32_INIT = 0xFFFFFFFFu;
+
+namespace detail {
+
+struct Table8 {
+  uint8_t t[256];
+};
+
+struct Table16 {
+  uint16_t t[256];
+};
+
+struct Table32x4 {
+  uint32_t t[4][256];
+};
+
+constexpr Table8 makeCrc8_31Table() {
+  Table8 table{};
+  for (uint32_t i = 0; i < 256U; ++i) {
+    uint8_t crc = static_cast<uint8_t>(i);
+    for (uint8_t bit = 0; bit < 8U; ++bit) {
+      crc = ((crc & 0x01U) != 0U) ? static_cast<uint8_t>((crc >> 1U) ^ 0x8CU)
+                                  : static_cast<uint8_t>(crc >> 1U);
+    }
+    table.t[i] = crc;
+  }
+  return table;
+}
+
+constexpr Table16 makeCrc16CcittTable() {
+  Table16 table{};
+  for (uint32_t i = 0; i < 256U; ++i) {
+    uint16_t crc = static_cast<uint16_t>(i << 8U);
+    for (uint8_t bit = 0; bit < 8U; ++bit) {
+      crc = ((crc & 0x8000U) != 0U) ? static_cast<uint16_t>((crc << 1U) ^ 0x1021U)
+                                    : static_cast<uint16_t>(crc << 1U);
+    }
+    table.t[i] = crc;
+  }
+  return table;
+}
+
+constexpr Table32x4 makeCrc32Tables() {
+  Table32x4 tables{};
+  for (uint32_t i = 0; i < 256U; ++i) {
+    uint32_t crc = i;
+    for (uint8_t bit = 0; bit < 8U; ++bit) {
+      crc = ((crc & 1U) != 0U) ? ((crc >> 1U) ^ 0xEDB88320u) : (crc >> 1U);
+    }
+    tables.t[0][i] = crc;
+  }
+  // Slice n advances a byte through n further zero bytes.
+  for (uint32_t i = 0; i < 256U; ++i) {
+    for (uint8_t slice = 1; slice < 4U; ++slice) {
+      const uint32_t prev = tables.t[slice - 1U][i];
+      tables.t[slice][i] = (prev >> 8U) ^ tables.t[0][prev & 0xFFU];
+    }
+  }
+  return tables;
+}
+
+inline constexpr Table8 CRC8_31_TABLE = makeCrc8_31Table();
+inline constexpr Table16 CRC16_CCITT_TABLE = makeCrc16CcittTable();
+inline constexpr Table32x4 CRC32_TABLES = makeCrc32Tables();
+
+}  // namespace detail
+
+// CRC-8, polynomial 0x31 reflected (Dallas/Maxim), init 0, no final XOR.
+inline uint8_t crc8_31Update(uint8_t crc, const uint8_t* data, size_t len) {
+  for (size_t i = 0; i < len; ++i) {
+    crc = detail::CRC8_31_TABLE.t[static_cast<uint8_t>(crc ^ data[i])];
+  }
+  return crc;
+}
+
+inline uint8_t crc8_31(const uint8_t* data, size_t len) {
+  return crc8_31Update(CRC8_31_INIT, data, len);
+}
+
+// CRC-16/CCITT-FALSE, polynomial 0x1021, init 0xFFFF, no final XOR.
+inline uint16_t crc16CcittUpdate(uint16_t crc, const uint8_t* data, size_t len) {
+  for (size_t i = 0; i < len; ++i) {
+    crc = static_cast<uint16_t>((crc << 8U) ^
+                                detail::CRC16_CCITT_TABLE.t[static_cast<uint8_t>((crc >> 8U) ^
+                                                                                 data[i])]);
+  }
+  return crc;
+}
+
+inline uint16_t crc16Ccitt(const uint8_t* data, size_t len) {
+  return crc16CcittUpdate(CRC16_CCITT_INIT, data, len);
+}
+
+// CRC-32 reference implementations, kept for the benchmark and self-checks.
+inline uint32_t crc32UpdateBitwise(uint32_t crc, const uint8_t* data, size_t len) {
+  for (size_t i = 0; i < len; ++i) {
+    crc ^= static_cast<uint32_t>(data[i]);
+    for (uint8_t bit = 0; bit < 8U; ++bit) {
+      crc = ((crc & 1U) != 0U) ? ((crc >> 1U) ^ 0xEDB88320u) : (crc >> 1U);
+    }
+  }
+  return crc;
+}
+
+inline uint32_t crc32UpdateBytewise(uint32_t crc, const uint8_t* data, size_t len) {
+  for (size_t i = 0; i < len; ++i) {
+    crc = (crc >> 8U) ^ detail::CRC32_TABLES.t[0][(crc ^ data[i]) & 0xFFU];
+  }
+  return crc;
+}
+
+/// @brief Advance a CRC-32 register by one byte (for per-byte streaming sinks).
+inline uint32_t crc32UpdateByte(uint32_t crc, uint8_t value) {
+  return (crc >> 8U) ^ detail::CRC32_TABLES.t[0][(crc ^ value) & 0xFFU];
+}
+
+// Slice-by-4: four bytes per step, composed byte-wise so any alignment and
+// endianness is safe.
+inline uint32_t crc32UpdateSlice4(uint32_t crc, const uint8_t* data, size_t len) {
+  const auto& t = detail::CRC32_TABLES.t;
+  while (len >= 4U) {
+    crc ^= static_cast<uint32_t>(data[0]) | (static_cast<uint32_t>(data[1]) << 8U) |
+           (static_cast<uint32_t>(data[2]) << 16U) | (static_cast<uint32_t>(data[3]) << 24U);
+    crc = t[3][crc & 0xFFU] ^ t[2][(crc >> 8U) & 0xFFU] ^ t[1][(crc >> 16U) & 0xFFU] ^
+          t[0][crc >> 24U];
+    data += 4;
+    len -= 4U;
+  }
+  return crc32UpdateBytewise(crc, data, len);
+}
+
+#if AT21CS_CRC_USE_ROM && defined(ARDUINO_ARCH_ESP32)
+// The ROM routine takes and returns finished CRC values.
+inline uint32_t crc32UpdateRom(uint32_t crc, const uint8_t* data, size_t len) {
+  return ~esp_rom_crc32_le(~crc, data, static_cast<uint32_t>(len));
+}
+#endif
+
+/// @brief Advance a CRC-32 register with the fastest available engine.
+inline uint32_t crc32Update(uint32_t crc, const uint8_t* data, size_t len) {
+#if AT21CS_CRC_USE_ROM && defined(ARDUINO_ARCH_ESP32)
+  return crc32UpdateRom(crc, data, len);
+#else
+  return crc32UpdateSlice4(crc, data, len);
+#endif
+}
+
+inline constexpr uint32_t crc32Final(uint32_t crc) { return ~crc; }
+
+inline uint32_t crc32(const uint8_t* data, size_t len) {
+  return crc32Final(crc32Update(CRC32_INIT, data, len));
+}
+
+}  // namespace crc
+}  // namespace AT21CS
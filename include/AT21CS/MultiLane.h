@@ -0,0 +1,170 @@
+/// @file MultiLane.h
+/// @brief Parallel bit-banging of several AT21CS devices on one GPIO bank.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(ARDUINO_ARCH_ESP32)
+#include <freertos/FreeRTOS.h>
+#include <freertos/portmacro.h>
+#endif
+
+#include "AT21CS/CommandTable.h"
+#include "AT21CS/Config.h"
+#include "AT21CS/Status.h"
+
+namespace AT21CS {
+
+/// @brief Maximum number of lanes driven by one LaneGroup.
+static constexpr uint8_t MAX_LANES = 8;
+
+/// @brief Configuration for a group of devices on distinct SI/O pins.
+struct LaneGroupConfig {
+  /// SI/O pin per lane. All pins must sit in the same GPIO bank (0..31 or 32..63).
+  int sioPins[MAX_LANES] = {-1, -1, -1, -1, -1, -1, -1, -1};
+
+  /// Device address bits A2:A0 per lane (0-7).
+  uint8_t addressBits[MAX_LANES] = {};
+
+  /// Number of configured lanes, range 1..MAX_LANES.
+  uint8_t laneCount = 0;
+
+  /// Maximum time to wait for t_WR completion after a page write. Range: 1..250 ms.
+  uint32_t writeTimeoutMs = 25;
+
+  /// Optional monotonic millisecond source. If null, falls back to Arduino millis().
+  NowMsFn nowMs = nullptr;
+
+  /// Optional microsecond delay hook. If null, falls back to the CPU cycle counter
+  /// on ESP32 and delayMicroseconds() elsewhere.
+  SleepUsFn sleepUs = nullptr;
+
+  /// User context for timing callbacks.
+  void* timeUser = nullptr;
+
+  /// Optional per-lane line backend (host simulation, test rigs). Set both or
+  /// neither; when set, begin() skips GPIO setup and each lane's edges and
+  /// samples go through these hooks with lineUser[lane]. Edges are issued lane
+  /// by lane without a sleep in between, so all lanes still see one instant.
+  LineWriteFn lineWrite = nullptr;
+
+  /// Optional per-lane line sample hook; see lineWrite.
+  LineReadFn lineRead = nullptr;
+
+  /// User context for the line callbacks, one per lane.
+  void* lineUser[MAX_LANES] = {};
+};
+
+/// @brief Drives up to MAX_LANES AT21CS devices in lock-step, High-Speed only.
+///
+/// Every edge is issued to all participating lanes with one combined GPIO mask
+/// write, and all lanes are sampled in the same read window. Per-lane bit
+/// patterns are supported: all lanes go low together and '1' lanes are
+/// released after t_LOW1, '0' lanes after t_LOW0.
+///
+/// Buffers are lane-major: lane n uses data[n * stride .. n * stride + len - 1].
+/// Lanes that NACK drop out for the rest of the transaction and are cleared in
+/// the returned okMask; the call then fails with IO_ERROR and detail set to the
+/// mask of failed lanes. Not thread-safe.
+class LaneGroup {
+ public:
+  /// @brief Configure all lane pins and run one reset/discovery.
+  /// @param config Lane pins, address bits, and timing hooks.
+  /// @return Status::Ok() when configured, even if some lanes are absent.
+  Status begin(const LaneGroupConfig& config);
+
+  /// @brief Release all lane pins.
+  void end();
+
+  /// @brief Check if begin() has completed successfully.
+  /// @return true after successful begin() and before end().
+  bool isInitialized() const { return _initialized; }
+
+  /// @brief Number of configured lanes.
+  /// @return Lane count from the active configuration.
+  uint8_t laneCount() const { return _config.laneCount; }
+
+  /// @brief Lanes that answered the last reset/discovery.
+  /// @return Bit n set when lane n is present.
+  uint8_t presentMask() const { return _presentMask; }
+
+  /// @brief Reset and discover all lanes in parallel.
+  /// @param[out] presentMask Bit n set when lane n answered discovery.
+  /// @return Status::Ok() when every lane answered, IO_ERROR otherwise.
+  Status resetAndDiscover(uint8_t& presentMask);
+
+  /// @brief Read the same EEPROM range from every lane.
+  /// @param address Start address in the 128-byte EEPROM area.
+  /// @param[out] data Lane-major destination, laneCount() * len bytes.
+  /// @param len Number of bytes per lane.
+  /// @param[out] okMask Bit n set when lane n completed.
+  /// @return Status::Ok() when every lane completed, error otherwise.
+  Status readEeprom(uint8_t address, uint8_t* data, size_t len, uint8_t& okMask);
+
+  /// @brief Read the same Security register range from every lane.
+  /// @param address Security register start address.
+  /// @param[out] data Lane-major destination, laneCount() * len bytes.
+  /// @param len Number of bytes per lane.
+  /// @param[out] okMask Bit n set when lane n completed.
+  /// @return Status::Ok() when every lane completed, error otherwise.
+  Status readSecurity(uint8_t address, uint8_t* data, size_t len, uint8_t& okMask);
+
+  /// @brief Read the 24-bit manufacturer ID of every lane.
+  /// @param[out] ids laneCount() identifiers.
+  /// @param[out] okMask Bit n set when lane n completed.
+  /// @return Status::Ok() when every lane completed, error otherwise.
+  Status readManufacturerId(uint32_t* ids, uint8_t& okMask);
+
+  /// @brief Write one EEPROM page on every lane and wait for all write cycles.
+  /// @param address EEPROM start address.
+  /// @param data Source bytes, lane-major when laneStride > 0.
+  /// @param len Number of bytes per lane, 1..8 within one page.
+  /// @param laneStride Distance between lanes in data; 0 writes identical bytes.
+  /// @param[out] okMask Bit n set when lane n completed its write cycle.
+  /// @return Status::Ok() when every lane completed, error otherwise.
+  Status writeEepromPage(uint8_t address, const uint8_t* data, size_t len, size_t laneStride,
+                         uint8_t& okMask);
+
+ private:
+  Status _checkInitialized() const;
+  Status _laneResult(uint8_t requested, uint8_t okMask) const;
+  Status _readRandom(uint8_t opcode, uint8_t address, uint8_t* data, size_t len,
+                     uint8_t& okMask);
+  uint8_t _discover();
+  uint8_t _waitReady(uint8_t lanes);
+
+  // A line word is the GPIO bank bit set for a lane mask (the lane mask itself
+  // on non-ESP32 targets).
+  uint32_t _lineWord(uint8_t lanes) const;
+  uint8_t _lanesFromWord(uint32_t word) const;
+  void _lineLow(uint32_t word);
+  void _releaseLine(uint32_t word);
+  uint32_t _readLines() const;
+  void _hookLines(uint32_t word, bool low);
+
+  uint8_t _txBytes(const uint8_t* values, uint8_t lanes);
+  uint8_t _txSame(uint8_t value, uint8_t lanes);
+  void _rxBytes(uint8_t* values, uint8_t lanes, bool ack);
+  uint8_t _txDeviceAddress(uint8_t opcode, bool read, uint8_t lanes);
+  void _sendStartStop();
+
+  uint32_t _nowMs() const;
+  void _sleepUs(uint32_t us) const;
+
+  LaneGroupConfig _config{};
+  bool _initialized = false;
+  uint8_t _presentMask = 0;
+  uint8_t _allLanes = 0;
+
+#if defined(ARDUINO_ARCH_ESP32)
+  mutable portMUX_TYPE _timingMux = portMUX_INITIALIZER_UNLOCKED;
+  volatile uint32_t* _gpioSetReg = nullptr;
+  volatile uint32_t* _gpioClrReg = nullptr;
+  volatile uint32_t* _gpioInReg = nullptr;
+  uint32_t _laneBits[MAX_LANES] = {};
+  uint32_t _cyclesPerUs = 240;
+#endif
+};
+
+}  // namespace AT21CS
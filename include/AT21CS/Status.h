@@ -22,7 +22,10 @@ enum class Err : uint8_t {
   UNSUPPORTED_COMMAND,
   CRC_MISMATCH,
   PART_MISMATCH,
-  IO_ERROR
+  IO_ERROR,
+  IN_PROGRESS,
+  VERIFY_FAILED,
+  WRITE_PROTECTED
 };
 
 /// @brief Status structure returned by all fallible APIs.
@@ -34,8 +37,8 @@ struct Status {
   /// @return true when code == Err::OK.
   constexpr bool ok() const { return code == Err::OK; }
 
-  /// @return false; AT21CS has no asynchronous in-progress status.
-  constexpr bool inProgress() const { return false; }
+  /// @return true when an asynchronous operation was started and has not completed.
+  constexpr bool inProgress() const { return code == Err::IN_PROGRESS; }
 
   /// @brief Create a successful status value.
   /// @return Status with Err::OK.
@@ -0,0 +1,189 @@
+/// @file Waveform.h
+/// @brief Pre-encoded bus transactions as (level, duration) symbol streams.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "AT21CS/AT21CS.h"
+#include "AT21CS/CommandTable.h"
+#include "AT21CS/Config.h"
+#include "AT21CS/Status.h"
+
+namespace AT21CS {
+
+/// @brief Maximum number of symbols held by one Waveform (a one-page write or
+/// an 8-byte random read fits).
+static constexpr size_t WAVEFORM_MAX_SYMBOLS = 384;
+
+/// @brief Maximum number of sample points (ACK slots and received bits) in one Waveform.
+static constexpr size_t WAVEFORM_MAX_SAMPLES = 128;
+
+/// @brief First data sample of a Waveform::encodeRandomRead() transaction
+/// (after the device address, word address and read address ACKs).
+static constexpr size_t WAVEFORM_READ_DATA_SAMPLE = 3;
+
+/// @brief One line level held for a number of ticks, packed like half an RMT item.
+struct WaveSymbol {
+  static constexpr uint16_t HIGH_BIT = 0x8000;    ///< Set: line released; clear: driven low.
+  static constexpr uint16_t SAMPLE_BIT = 0x4000;  ///< Sample the line when the symbol ends.
+  static constexpr uint16_t TICKS_MASK = 0x3FFF;  ///< Duration in ticks.
+
+  uint16_t raw;
+
+  /// @return true when the line is released (pulled high) for this symbol.
+  constexpr bool high() const { return (raw & HIGH_BIT) != 0U; }
+
+  /// @return true when the line is sampled at the end of this symbol.
+  constexpr bool sample() const { return (raw & SAMPLE_BIT) != 0U; }
+
+  /// @return Duration in ticks, 1..16383.
+  constexpr uint16_t ticks() const { return static_cast<uint16_t>(raw & TICKS_MASK); }
+};
+
+/// @brief A transaction encoded ahead of time as line-level symbols.
+///
+/// Each bit slot becomes the same low/high segments Driver::txBit0(),
+/// txBit1() and rxBit() produce for the profile, at tickNs resolution; Start
+/// and Stop are one t_HTSS high each. Read slots carry WaveSymbol::SAMPLE_BIT
+/// on the symbol that ends at the sample point, and every sample gets an index
+/// in transmission order (one per ACK slot of a sent byte, eight per received
+/// byte). Durations longer than 16383 ticks are split over several symbols.
+///
+/// Driver::runWaveform() replays the symbols with its delay engine and masks
+/// interrupts one bit slot at a time. A peripheral such as the ESP32 RMT can
+/// transmit symbols() directly (two per item, with SAMPLE_BIT cleared) while
+/// a receiver captures the line at the marked sample points.
+///
+/// Encoding performs no bus I/O. Appending past WAVEFORM_MAX_SYMBOLS or
+/// WAVEFORM_MAX_SAMPLES marks the waveform overflowed; it is then rejected.
+class Waveform {
+ public:
+  /// @brief Clear the waveform and set the timing used by later encoding.
+  /// @param timing Bit-slot profile, checked with Driver::validateTimingProfile().
+  /// @param mode Speed mode the profile belongs to.
+  /// @param addressBits Device address bits A2:A0 (0-7).
+  /// @param tickNs Symbol resolution in nanoseconds, 1..1000. Segments are
+  ///        truncated to whole ticks like the driver truncates to microseconds.
+  /// @return Status::Ok(), INVALID_PARAM or INVALID_CONFIG otherwise.
+  Status begin(const TimingProfile& timing, SpeedMode mode, uint8_t addressBits,
+               uint32_t tickNs = 1000);
+
+  /// @brief Remove all symbols and samples; the timing is kept.
+  void clear();
+
+  /// @brief Append a Start condition (t_HTSS high).
+  void start();
+
+  /// @brief Append a Stop condition (t_HTSS high).
+  void stop();
+
+  /// @brief Append one byte, MSB first, followed by its ACK read slot.
+  /// @param value Byte to send.
+  /// @return Sample index of the ACK slot.
+  size_t txByte(uint8_t value);
+
+  /// @brief Append eight read slots followed by the master ACK or NACK bit.
+  /// @param ack true to acknowledge (more bytes follow), false for the last byte.
+  /// @return Sample index of the most significant bit.
+  size_t rxByte(bool ack);
+
+  /// @brief Encode a complete random read (dummy write, repeated Start, read).
+  /// Data byte i is sampleByte(WAVEFORM_READ_DATA_SAMPLE + 8 * i) after replay.
+  /// @param opcode Command opcode (cmd::OPCODE_EEPROM, OPCODE_SECURITY, ...).
+  /// @param address Start address.
+  /// @param len Number of bytes to read, at least 1.
+  /// @return Status::Ok(), NOT_INITIALIZED before begin(), INVALID_PARAM when
+  ///         len is 0 or the buffer is too small.
+  Status encodeRandomRead(uint8_t opcode, uint8_t address, size_t len);
+
+  /// @brief Encode a complete write frame (address, data bytes, Stop).
+  /// The write cycle (t_WR) starts at the Stop; poll with Driver::waitReady().
+  /// @param opcode Command opcode.
+  /// @param address Start address.
+  /// @param data Bytes to send (copied into the symbols).
+  /// @param len Number of bytes, at least 1.
+  /// @return Status::Ok(), NOT_INITIALIZED before begin(), INVALID_PARAM for
+  ///         bad arguments or a full buffer.
+  Status encodeWrite(uint8_t opcode, uint8_t address, const uint8_t* data, size_t len);
+
+  /// @return Encoded symbols, valid for size() entries.
+  const WaveSymbol* symbols() const { return _symbols; }
+
+  /// @return Number of encoded symbols.
+  size_t size() const { return _count; }
+
+  /// @return Number of sample points.
+  size_t sampleCount() const { return _sampleCount; }
+
+  /// @return Sum of all symbol durations in ticks.
+  uint32_t totalTicks() const { return _totalTicks; }
+
+  /// @return Symbol resolution in nanoseconds.
+  uint32_t tickNs() const { return _tickNs; }
+
+  /// @return Speed mode given to begin().
+  SpeedMode speedMode() const { return _mode; }
+
+  /// @return true when an append did not fit.
+  bool overflowed() const { return _overflow; }
+
+  /// @brief Line level captured at one sample point by the last replay.
+  /// @param index Sample index.
+  /// @return true when the line read high; false for an unknown index.
+  bool sample(size_t index) const;
+
+  /// @brief Eight consecutive samples, MSB first (as returned by rxByte()).
+  /// @param first Sample index of the most significant bit.
+  /// @return Assembled byte.
+  uint8_t sampleByte(size_t first) const;
+
+  /// @brief Store a captured level, for PHYs that replay the symbols themselves.
+  /// @param index Sample index, below sampleCount().
+  /// @param high Level read at the sample point.
+  void storeSample(size_t index, bool high);
+
+  /// @brief First NACK among the captured ACK slots of sent bytes.
+  /// @return Status::Ok() when every sent byte was acknowledged; otherwise
+  ///         NACK_DEVICE_ADDRESS, NACK_MEMORY_ADDRESS, or NACK_DATA with
+  ///         detail = data byte index within its frame.
+  Status ackStatus() const;
+
+ private:
+  friend class Driver;
+
+  void _append(bool high, uint32_t ticks, bool sample);
+  void _txBit(bool one);
+  void _rxBit();
+
+  TimingProfile _timing = HIGH_SPEED_TIMING;
+  SpeedMode _mode = SpeedMode::HIGH_SPEED;
+  uint8_t _addressBits = 0;
+  uint32_t _tickNs = 0;
+
+  // Segment lengths in ticks, in the order of Driver::BitSegment.
+  uint32_t _low0 = 0;
+  uint32_t _high0 = 0;
+  uint32_t _low1 = 0;
+  uint32_t _high1 = 0;
+  uint32_t _readLow = 0;
+  uint32_t _readSample = 0;
+  uint32_t _readRest = 0;
+  uint32_t _htss = 0;
+
+  WaveSymbol _symbols[WAVEFORM_MAX_SYMBOLS] = {};
+  size_t _count = 0;
+  size_t _sampleCount = 0;
+  uint32_t _totalTicks = 0;
+  uint8_t _samples[WAVEFORM_MAX_SAMPLES / 8U] = {};
+  uint8_t _ackMask[WAVEFORM_MAX_SAMPLES / 8U] = {};         // Sample is a sent byte's ACK.
+  uint8_t _addressAckMask[WAVEFORM_MAX_SAMPLES / 8U] = {};  // ACK of a device address byte.
+
+  uint8_t _frameBytes = 0;
+  bool _frameWrites = false;
+  bool _writes = false;
+  bool _speedCommand = false;
+  bool _overflow = false;
+};
+
+}  // namespace AT21CS
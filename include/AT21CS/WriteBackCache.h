@@ -0,0 +1,129 @@
+/// @file WriteBackCache.h
+/// @brief Write-combining EEPROM page cache layered on one Driver.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "AT21CS/AT21CS.h"
+#include "AT21CS/CommandTable.h"
+#include "AT21CS/Status.h"
+
+namespace AT21CS {
+
+/// @brief Number of 8-byte pages in the EEPROM array.
+static constexpr uint8_t WRITE_BACK_PAGES = cmd::EEPROM_SIZE / cmd::PAGE_SIZE;
+
+/// @brief Flush policy for WriteBackCache.
+struct WriteBackConfig {
+  /// Flush a page once it has been dirty this long. 0 disables age-based flushing.
+  uint32_t maxAgeMs = 1000;
+
+  /// Start flushing once this many pages are dirty, range 0..16. 0 disables
+  /// count-based flushing.
+  uint8_t maxDirtyPages = 4;
+};
+
+/// @brief Write-back counters, read without bus I/O.
+struct WriteBackStats {
+  uint32_t stagedWrites = 0;  ///< write*() calls absorbed by the cache.
+  uint32_t bytesStaged = 0;   ///< Bytes written into the cache.
+  uint32_t pageWrites = 0;    ///< Page writes issued to the device.
+  uint32_t fillReads = 0;     ///< Reads of clean bytes inside a partially dirty page.
+  uint32_t failedFlushes = 0; ///< Page writes that failed; the page stays dirty.
+};
+
+/// @brief Holds dirty EEPROM bytes in RAM and writes each page once.
+///
+/// Writes only update RAM; repeated byte or field updates to the same page
+/// merge into a single page write. tick() starts one asynchronous page write
+/// (Driver::startWriteEeprom()) when the oldest dirty page reaches maxAgeMs or
+/// maxDirtyPages pages are dirty, and advances it with Driver::tick(). flush()
+/// writes every dirty page before returning. Each page write covers the span
+/// from the first to the last dirty byte; clean bytes inside that span are
+/// read from the device first.
+///
+/// readEeprom() returns device contents overlaid with unflushed bytes. Data is
+/// lost on reset or power loss until flushed. While the cache owns writes, do
+/// not write the same addresses through the Driver directly. Not thread-safe.
+class WriteBackCache {
+ public:
+  /// @brief Attach to an initialized driver. The driver must outlive the cache.
+  /// @param driver Driver used for reads and page writes.
+  /// @param config Flush policy.
+  /// @return Status::Ok(), INVALID_PARAM for a null driver or bad policy.
+  Status begin(Driver* driver, const WriteBackConfig& config = WriteBackConfig{});
+
+  /// @brief Flush all dirty pages and detach from the driver.
+  /// @return Result of the final flush().
+  Status end();
+
+  /// @brief Read EEPROM bytes, including writes not yet flushed.
+  /// @param address Start address in the 128-byte EEPROM area.
+  /// @param[out] data Destination buffer.
+  /// @param len Number of bytes to read.
+  /// @return Status::Ok() on success, error otherwise.
+  Status readEeprom(uint8_t address, uint8_t* data, size_t len);
+
+  /// @brief Stage one EEPROM byte.
+  /// @param address EEPROM byte address.
+  /// @param value Byte value.
+  /// @return Status::Ok() when staged, error otherwise.
+  Status writeEepromByte(uint8_t address, uint8_t value);
+
+  /// @brief Stage EEPROM bytes across any number of pages.
+  /// @param address EEPROM start address.
+  /// @param data Source buffer (copied).
+  /// @param len Number of bytes.
+  /// @return Status::Ok() when staged, error otherwise.
+  Status writeEeprom(uint8_t address, const uint8_t* data, size_t len);
+
+  /// @brief Advance an in-flight page write and apply the flush policy.
+  /// @param nowMs Current monotonic time in milliseconds.
+  void tick(uint32_t nowMs);
+
+  /// @brief Write every dirty page and wait for each write cycle.
+  /// @return Status::Ok() when nothing remains dirty, first failure otherwise.
+  Status flush();
+
+  /// @brief Drop all unflushed bytes without writing them.
+  void discard();
+
+  /// @return Bit n set when page n holds unflushed bytes (including an in-flight page).
+  uint16_t dirtyMask() const;
+
+  /// @return Number of pages holding unflushed bytes.
+  uint8_t dirtyPages() const;
+
+  /// @return true while a page write started by tick() is running.
+  bool flushing() const { return _inflightPage >= 0; }
+
+  /// @return Write-back counters.
+  const WriteBackStats& stats() const { return _stats; }
+
+  /// @return Status of the most recent failed page write, or Ok().
+  Status lastError() const { return _lastError; }
+
+ private:
+  Status _checkAttached() const;
+  Status _writePage(uint8_t page, bool async);
+  Status _drainInflight();
+  void _finishInflight(const Status& result);
+  int8_t _oldestDirtyPage() const;
+
+  Driver* _driver = nullptr;
+  WriteBackConfig _config;
+
+  uint8_t _data[cmd::EEPROM_SIZE] = {};
+  uint8_t _dirty[WRITE_BACK_PAGES] = {};  // Dirty-byte mask per page.
+  uint32_t _dirtySinceMs[WRITE_BACK_PAGES] = {};
+  uint32_t _nowMs = 0;
+
+  int8_t _inflightPage = -1;
+  uint8_t _inflightMask = 0;
+
+  WriteBackStats _stats;
+  Status _lastError = Status::Ok();
+};
+
+}  // namespace AT21CS
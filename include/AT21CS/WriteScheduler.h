@@ -0,0 +1,106 @@
+/// @file WriteScheduler.h
+/// @brief Interleaves EEPROM writes across several drivers to overlap t_WR.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "AT21CS/AT21CS.h"
+#include "AT21CS/Status.h"
+
+namespace AT21CS {
+
+/// @brief Maximum number of drivers owned by one WriteScheduler.
+static constexpr uint8_t SCHEDULER_MAX_DEVICES = 8;
+
+/// @brief Maximum number of queued (not yet started) write jobs.
+static constexpr uint8_t SCHEDULER_MAX_JOBS = 16;
+
+/// @brief Completion callback for one scheduled write job.
+/// @param deviceIndex Index returned by WriteScheduler::addDevice().
+/// @param address EEPROM start address of the job.
+/// @param result Final status of the write.
+/// @param user User context from WriteScheduler::setJobDoneCallback().
+using JobDoneFn = void (*)(uint8_t deviceIndex, uint8_t address, const Status& result, void* user);
+
+/// @brief Cooperative scheduler that keeps one asynchronous write in flight per SI/O line.
+///
+/// Jobs are started with Driver::startWriteEeprom() and advanced with
+/// Driver::tick(), so while one device runs its internal write cycle the
+/// scheduler issues pages to devices on other lines. Devices that share an
+/// SI/O pin are never addressed while another device on that pin is in t_WR.
+/// Jobs for one line start in submission order. Not thread-safe; call tick()
+/// from the same task that owns the drivers.
+class WriteScheduler {
+ public:
+  /// @brief Register a driver. The driver must outlive the scheduler.
+  /// @param device Initialized driver instance.
+  /// @param[out] deviceIndex Index used by submit().
+  /// @return Status::Ok() or INVALID_PARAM / INVALID_STATE when full.
+  Status addDevice(Driver* device, uint8_t& deviceIndex);
+
+  /// @brief Queue an EEPROM write (any length, split into pages by the driver).
+  /// @param deviceIndex Index returned by addDevice().
+  /// @param address EEPROM start address.
+  /// @param data Source bytes; must stay valid until the job completes.
+  /// @param len Number of bytes, 1..128 within the EEPROM.
+  /// @return Status::Ok() when queued, INVALID_STATE when the queue is full.
+  Status submit(uint8_t deviceIndex, uint8_t address, const uint8_t* data, size_t len);
+
+  /// @brief Advance running writes and start queued jobs on free lines.
+  /// @param nowMs Current monotonic time, forwarded to Driver::tick().
+  void tick(uint32_t nowMs);
+
+  /// @brief Set the per-job completion callback.
+  /// @param callback Function invoked once per finished job, or nullptr.
+  /// @param user User context passed to the callback.
+  void setJobDoneCallback(JobDoneFn callback, void* user);
+
+  /// @brief Check whether a device or any device sharing its SI/O pin is writing.
+  /// @param deviceIndex Index returned by addDevice().
+  /// @return true while the device's line must not be used.
+  bool lineBusy(uint8_t deviceIndex) const;
+
+  /// @return true when no job is queued or running.
+  bool idle() const;
+
+  /// @return Number of queued jobs that have not started.
+  uint8_t pendingJobs() const { return _jobCount; }
+
+  /// @return Number of jobs finished successfully.
+  uint32_t completedJobs() const { return _completedJobs; }
+
+  /// @return Number of jobs finished with an error.
+  uint32_t failedJobs() const { return _failedJobs; }
+
+  /// @return Status of the most recent failed job, or Ok().
+  Status lastError() const { return _lastError; }
+
+ private:
+  struct Job {
+    uint8_t device;
+    uint8_t address;
+    const uint8_t* data;
+    uint8_t len;
+  };
+
+  bool _pinBusy(int sioPin) const;
+  void _finish(uint8_t deviceIndex, const Status& result);
+  void _removeJob(uint8_t slot);
+
+  Driver* _devices[SCHEDULER_MAX_DEVICES] = {};
+  bool _running[SCHEDULER_MAX_DEVICES] = {};
+  uint8_t _runningAddress[SCHEDULER_MAX_DEVICES] = {};
+  uint8_t _deviceCount = 0;
+
+  Job _jobs[SCHEDULER_MAX_JOBS] = {};
+  uint8_t _jobCount = 0;
+
+  JobDoneFn _jobDone = nullptr;
+  void* _jobDoneUser = nullptr;
+  uint32_t _completedJobs = 0;
+  uint32_t _failedJobs = 0;
+  Status _lastError = Status::Ok();
+};
+
+}  // namespace AT21CS
@@ -2,6 +2,9 @@
 /// @brief Implementation of the AT21CS01/AT21CS11 single-wire EEPROM driver.
 
 #include "AT21CS/AT21CS.h"
+#include "AT21CS/Batch.h"
+#include "AT21CS/Crc.h"
+#include "AT21CS/Waveform.h"
 
 #include <Arduino.h>
 
@@ -13,11 +16,19 @@
 #include <esp_timer.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/portmacro.h>
+#include <freertos/task.h>
 #if __has_include(<esp_cpu.h>)
 #include <esp_cpu.h>
 #endif
 #endif
 
+#if defined(ARDUINO_ARCH_ESP32) && __has_include(<driver/gptimer.h>)
+#include <driver/gptimer.h>
+#define AT21CS_HAS_GPTIMER 1
+#else
+#define AT21CS_HAS_GPTIMER 0
+#endif
+
 namespace {
 
 inline void incrementWrap(uint8_t& value) {
@@ -75,6 +86,16 @@ inline bool isValidSpeedMode(AT21CS::SpeedMode mode) {
   return false;
 }
 
+inline bool isValidCriticalSection(AT21CS::CriticalSection scope) {
+  switch (scope) {
+    case AT21CS::CriticalSection::PER_BIT:
+    case AT21CS::CriticalSection::PER_BYTE:
+    case AT21CS::CriticalSection::PER_TRANSACTION:
+      return true;
+  }
+  return false;
+}
+
 inline uint32_t saturatedAdd(uint32_t lhs, uint32_t rhs) {
   const uint32_t room = UINT32_MAX - lhs;
   return (rhs > room) ? UINT32_MAX : (lhs + rhs);
@@ -91,15 +112,56 @@ inline uint32_t waitReadyStallGuardIterations(uint32_t timeoutMs) {
   return (polls < 32U) ? 32U : polls;
 }
 
+inline uint16_t pageSpanMask(uint8_t address, size_t len) {
+  const size_t firstPage = static_cast<size_t>(address) / AT21CS::cmd::PAGE_SIZE;
+  const size_t lastPage = (static_cast<size_t>(address) + len - 1U) / AT21CS::cmd::PAGE_SIZE;
+  uint16_t mask = 0;
+  for (size_t page = firstPage; page <= lastPage; ++page) {
+    mask = static_cast<uint16_t>(mask | (1U << page));
+  }
+  return mask;
+}
+
 static constexpr uint32_t MAX_READY_TIMEOUT_MS = 250;
 
+inline bool sameProfile(const AT21CS::TimingProfile& a, const AT21CS::TimingProfile& b) {
+  return a.bitNs == b.bitNs && a.low0Ns == b.low0Ns && a.low1Ns == b.low1Ns &&
+         a.readLowNs == b.readLowNs && a.readSampleNs == b.readSampleNs && a.htssNs == b.htssNs;
+}
+
+// Datasheet bit-slot limits per speed mode, in nanoseconds. t_RD shares the
+// t_LOW1 range; t_BIT must also leave t_RCV after the longest low phase. The
+// sample point (t_RD plus the sample delay) must not pass t_MRS, which is also
+// the shortest t_HLD0 a device may hold a '0' for.
+struct TimingLimits {
+  uint32_t bitMinNs;
+  uint32_t bitMaxNs;
+  uint32_t low0MinNs;
+  uint32_t low0MaxNs;
+  uint32_t low1MinNs;
+  uint32_t low1MaxNs;
+  uint32_t recoveryMinNs;
+  uint32_t htssMinNs;
+  uint32_t sampleMaxNs;
+};
+
+static constexpr TimingLimits HIGH_SPEED_LIMITS = {0,    25000, 6000,   16000, 1000,
+                                                   2000, 2000,  150000, 2000};
+static constexpr TimingLimits STANDARD_SPEED_LIMITS = {40000, 100000, 24000,  64000, 4000,
+                                                       8000,  8000,   600000, 8000};
+
+// characterizeTiming() reference: factory serial, then EEPROM 0x00..0x0F.
+static constexpr size_t TIMING_SCAN_EEPROM_BYTES = 16;
+static constexpr size_t TIMING_SCAN_PATTERN_BYTES =
+    AT21CS::cmd::SECURITY_SERIAL_SIZE + TIMING_SCAN_EEPROM_BYTES;
+static constexpr uint32_t READY_POLL_INTERVAL_US = 100;
+static constexpr uint32_t ADAPTIVE_POLL_MIN_US = 25;
+static constexpr uint32_t ADAPTIVE_POLL_MAX_US = 400;
+
 }  // namespace
 
 namespace AT21CS {
 
-constexpr Driver::TimingProfile Driver::HIGH_SPEED_TIMING;
-constexpr Driver::TimingProfile Driver::STANDARD_SPEED_TIMING;
-
 Status Driver::begin(const Config& config) {
   if (_initialized) {
     end();
@@ -107,7 +169,7 @@ Status Driver::begin(const Config& config) {
     // Clean up GPIO from a previously failed begin() that configured the pin
     // but didn't complete initialization.
 #if defined(ARDUINO_ARCH_ESP32)
-    if (_gpioSetReg != nullptr) {
+    if (_gpioSetReg != nullptr || _config.lineWrite != nullptr) {
       _releaseLine();
     }
 #else
@@ -120,15 +182,30 @@ Status Driver::begin(const Config& config) {
   _driverState = DriverState::UNINIT;
   _detectedPart = PartType::UNKNOWN;
   _setSpeedMode(SpeedMode::HIGH_SPEED);
+  _requestedSpeed = SpeedMode::HIGH_SPEED;
   _resetHealth();
   _lastTickMs = 0;
+  _sessionActive = false;
+  _addressPointerValid = false;
+  invalidateShadowCache();
+  invalidateIdentityCache();
+  _romZoneMaskValid = false;
+  _asyncActive = false;
+  _asyncStatus = Status::Ok();
+  _phyWave = nullptr;
+  _phyUntracked = false;
+  _phyStatus = Status::Ok();
+  _writeCycle = WriteCycleStats{};
+  _masking = MaskingStats{};
 
   auto failBegin = [this](Status failure, DriverState state) -> Status {
     _initialized = false;
     _driverState = state;
     _detectedPart = PartType::UNKNOWN;
     _setSpeedMode(SpeedMode::HIGH_SPEED);
+    _requestedSpeed = SpeedMode::HIGH_SPEED;
     _resetHealth();
+    _sessionActive = false;
     return failure;
   };
 
@@ -174,6 +251,29 @@ Status Driver::begin(const Config& config) {
     return failBegin(Status::Error(Err::INVALID_CONFIG, "invalid startupSpeed enum"),
                      DriverState::FAULT);
   }
+  if (!isValidCriticalSection(config.criticalSection)) {
+    return failBegin(Status::Error(Err::INVALID_CONFIG, "invalid criticalSection enum"),
+                     DriverState::FAULT);
+  }
+  if ((config.lineWrite == nullptr) != (config.lineRead == nullptr)) {
+    return failBegin(Status::Error(Err::INVALID_CONFIG, "lineWrite and lineRead must be set together"),
+                     DriverState::FAULT);
+  }
+  if (config.timerPhy && (config.timerMinUs < 2U || config.timerMinUs > 1000U)) {
+    return failBegin(Status::Error(Err::INVALID_CONFIG, "timerMinUs must be in range 2..1000"),
+                     DriverState::FAULT);
+  }
+  if (config.timerPhy && config.alarmStart == nullptr && !AT21CS_HAS_GPTIMER) {
+    return failBegin(Status::Error(Err::INVALID_CONFIG, "timerPhy needs alarmStart on this target"),
+                     DriverState::FAULT);
+  }
+  Status timingSt = validateTimingProfile(config.highSpeedTiming, SpeedMode::HIGH_SPEED);
+  if (timingSt.ok()) {
+    timingSt = validateTimingProfile(config.standardSpeedTiming, SpeedMode::STANDARD_SPEED);
+  }
+  if (!timingSt.ok()) {
+    return failBegin(timingSt, DriverState::FAULT);
+  }
 
   _config = config;
   if (_config.offlineThreshold == 0) {
@@ -183,9 +283,13 @@ Status Driver::begin(const Config& config) {
   _driverState = DriverState::UNINIT;
   _detectedPart = PartType::UNKNOWN;
   _setSpeedMode(SpeedMode::HIGH_SPEED);
+  _requestedSpeed = SpeedMode::HIGH_SPEED;
   _resetHealth();
 
   Status st = _configurePins();
+  if (st.ok()) {
+    st = _setupTimerPhy();
+  }
   if (!st.ok()) {
     return failBegin(st, DriverState::FAULT);
   }
@@ -240,6 +344,7 @@ Status Driver::begin(const Config& config) {
   }
 
   _detectedPart = detected;
+  _cacheManufacturerId(manufacturerId);
 
   _driverState = DriverState::INIT_CONFIG;
   if (_config.startupSpeed == SpeedMode::STANDARD_SPEED) {
@@ -254,8 +359,10 @@ Status Driver::begin(const Config& config) {
           DriverState::FAULT);
     }
     _setSpeedMode(SpeedMode::STANDARD_SPEED);
+    _requestedSpeed = SpeedMode::STANDARD_SPEED;
   } else {
     _setSpeedMode(SpeedMode::HIGH_SPEED);
+    _requestedSpeed = SpeedMode::HIGH_SPEED;
   }
 
   _initialized = true;
@@ -263,6 +370,8 @@ Status Driver::begin(const Config& config) {
   _lastOkMs = _nowMs();
   _lastTickMs = _lastOkMs;
   _lastError = Status::Ok();
+  _sessionActive = _config.persistentSession;
+  _sessionLastMs = _lastOkMs;
 
   return Status::Ok();
 }
@@ -272,12 +381,25 @@ void Driver::tick(uint32_t nowMs) {
     return;
   }
   _lastTickMs = nowMs;
+  if (_phyUntracked && _phyFinished()) {
+    // Decoded here rather than in the alarm handler, which only touches the line.
+    _phyUntracked = false;
+    _phyStatus = _phyWave->ackStatus();
+    (void)_trackIo(_phyStatus);
+    if (_phyDone != nullptr) {
+      _phyDone(_phyStatus, _phyUser);
+    }
+  }
+  if (_asyncActive) {
+    _asyncPoll();
+  }
 }
 
 void Driver::end() {
+  _releaseTimerPhy();
   if (_config.sioPin >= 0) {
 #if defined(ARDUINO_ARCH_ESP32)
-    if (_gpioSetReg != nullptr) {
+    if (_gpioSetReg != nullptr || _config.lineWrite != nullptr) {
       _releaseLine();
     }
 #else
@@ -290,12 +412,26 @@ void Driver::end() {
   _driverState = DriverState::UNINIT;
   _detectedPart = PartType::UNKNOWN;
   _setSpeedMode(SpeedMode::HIGH_SPEED);
+  _requestedSpeed = SpeedMode::HIGH_SPEED;
   _resetHealth();
+  _sessionActive = false;
+  _addressPointerValid = false;
+  invalidateShadowCache();
+  invalidateIdentityCache();
+  _romZoneMaskValid = false;
+  _asyncActive = false;
+  _asyncStatus = Status::Ok();
+  _phyWave = nullptr;
+  _phyUntracked = false;
+  _phyStatus = Status::Ok();
+  _writeCycle = WriteCycleStats{};
+  _masking = MaskingStats{};
 #if defined(ARDUINO_ARCH_ESP32)
   _gpioSetReg = nullptr;
   _gpioClrReg = nullptr;
   _gpioInReg = nullptr;
   _gpioMask = 0;
+  _cycleTimed = false;
 #endif
 }
 
@@ -311,6 +447,16 @@ Status Driver::getSettings(SettingsSnapshot& out) const {
   out.state = _driverState;
   out.detectedPart = _detectedPart;
   out.speedMode = _speedMode;
+  out.sessionActive = _sessionActive;
+  out.shadowEepromValid = _shadowEepromValid;
+  out.shadowSecurityValid = _shadowSecurityValid;
+  out.romZoneMaskValid = _romZoneMaskValid;
+  out.romZoneMask = _romZoneMask;
+#if defined(ARDUINO_ARCH_ESP32)
+  out.edgeOverheadCycles = _edgeOverheadCycles;
+#endif
+  out.writeCycle = _writeCycle;
+  out.masking = _masking;
   out.lastOkMs = _lastOkMs;
   out.lastErrorMs = _lastErrorMs;
   out.lastError = _lastError;
@@ -351,6 +497,10 @@ Status Driver::recover() {
     return _trackIo(Status::Error(Err::NOT_PRESENT, "Presence pin indicates device absent"));
   }
 
+  // The module may have been swapped while offline; cached contents are stale.
+  invalidateShadowCache();
+  _romZoneMaskValid = false;
+
   _driverState = DriverState::RECOVERING;
   Status discovery = Status::Error(Err::DISCOVERY_FAILED, "Discovery failed");
   const uint16_t attempts = retryAttempts(_config.discoveryRetries);
@@ -382,6 +532,11 @@ Status Driver::recover() {
     return _trackIo(Status::Error(Err::PART_MISMATCH, "Detected part does not match expectedPart"));
   }
 
+  st = _revalidateIdentityCache(manufacturerId);
+  if (!st.ok()) {
+    return _trackIo(st);
+  }
+
   // After reset+discovery, device is always in High-Speed mode.
   // Re-apply startup speed setting if Standard Speed was configured.
   if (_config.startupSpeed == SpeedMode::STANDARD_SPEED && _detectedPart == PartType::AT21CS01) {
@@ -395,10 +550,13 @@ Status Driver::recover() {
           Status::Error(Err::NACK_DEVICE_ADDRESS, "Standard Speed command NACK during recovery"));
     }
     _setSpeedMode(SpeedMode::STANDARD_SPEED);
+    _requestedSpeed = SpeedMode::STANDARD_SPEED;
   } else {
     _setSpeedMode(SpeedMode::HIGH_SPEED);
+    _requestedSpeed = SpeedMode::HIGH_SPEED;
   }
 
+  _sessionActive = _config.persistentSession;
   return _trackIo(Status::Ok());
 }
 
@@ -465,47 +623,7 @@ Status Driver::waitReady(uint32_t timeoutMs) {
     return Status::Error(Err::INVALID_PARAM, "timeoutMs must be <= 250");
   }
 
-  if (_config.presencePin >= 0 && !_presencePinReportsPresent()) {
-    _driverState = DriverState::OFFLINE;
-    return _trackIo(Status::Error(Err::NOT_PRESENT, "Presence pin indicates device absent"));
-  }
-
-  _driverState = DriverState::BUSY;
-  const uint32_t startMs = _nowMs();
-  uint32_t lastObservedMs = startMs;
-  uint32_t stalledPolls = 0;
-  const uint32_t maxStalledPolls = waitReadyStallGuardIterations(timeoutMs);
-  while (true) {
-    if (_config.presencePin >= 0 && !_presencePinReportsPresent()) {
-      _driverState = DriverState::OFFLINE;
-      return _trackIo(Status::Error(Err::NOT_PRESENT, "Presence pin indicates device absent"));
-    }
-
-    bool ack = false;
-    st = _addressOnlyRaw(cmd::OPCODE_EEPROM, false, ack);
-    if (!st.ok()) {
-      return _trackIo(st);
-    }
-    if (ack) {
-      return _trackIo(Status::Ok());
-    }
-
-    const uint32_t elapsedMs = _nowMs() - startMs;
-    if (elapsedMs >= timeoutMs) {
-      return _trackIo(Status::Error(Err::BUSY_TIMEOUT, "Timed out waiting for write cycle completion"));
-    }
-    const uint32_t observedMs = _nowMs();
-    if (observedMs == lastObservedMs) {
-      if (++stalledPolls >= maxStalledPolls) {
-        return _trackIo(Status::Error(Err::BUSY_TIMEOUT, "Timed out waiting for write cycle completion"));
-      }
-    } else {
-      lastObservedMs = observedMs;
-      stalledPolls = 0;
-    }
-
-    _sleepUs(100);
-  }
+  return _trackIo(_waitReadyRaw(timeoutMs, false));
 }
 
 Status Driver::readCurrentAddress(uint8_t& value) {
@@ -519,7 +637,7 @@ Status Driver::readCurrentAddress(uint8_t& value) {
     return _trackIo(st);
   }
 
-  st = _readCurrentAddressRaw(value);
+  st = _readCurrentAddressRaw(&value, 1);
   return _trackIo(st);
 }
 
@@ -535,12 +653,48 @@ Status Driver::readEeprom(uint8_t address, uint8_t* data, size_t len) {
     return Status::Error(Err::INVALID_PARAM, "EEPROM read range out of bounds");
   }
 
+  if (_config.shadowCache) {
+    return _readShadowed(cmd::OPCODE_EEPROM, address, data, len);
+  }
+
+  st = _activateDevice();
+  if (!st.ok()) {
+    return _trackIo(st);
+  }
+
+  st = _readEepromRaw(address, data, len);
+  return _trackIo(st);
+}
+
+Status Driver::readEepromStream(uint8_t address, size_t len, ByteSinkFn sink, void* user) {
+  Status st = _checkInitialized();
+  if (!st.ok()) {
+    return st;
+  }
+  if (sink == nullptr) {
+    return Status::Error(Err::INVALID_PARAM, "EEPROM read sink is null");
+  }
+  if (!rangeFits(address, len, cmd::EEPROM_SIZE)) {
+    return Status::Error(Err::INVALID_PARAM, "EEPROM read range out of bounds");
+  }
+
+  if (_config.shadowCache) {
+    uint8_t data[cmd::EEPROM_SIZE];
+    st = _readShadowed(cmd::OPCODE_EEPROM, address, data, len);
+    if (st.ok()) {
+      for (size_t i = 0; i < len; ++i) {
+        sink(data[i], i, user);
+      }
+    }
+    return st;
+  }
+
   st = _activateDevice();
   if (!st.ok()) {
     return _trackIo(st);
   }
 
-  st = _readRandomRaw(cmd::OPCODE_EEPROM, address, data, len);
+  st = _readEepromRaw(address, nullptr, len, sink, user);
   return _trackIo(st);
 }
 
@@ -569,6 +723,11 @@ Status Driver::writeEepromPage(uint8_t address, const uint8_t* data, size_t len)
     return Status::Error(Err::INVALID_PARAM, "EEPROM page write crosses page boundary");
   }
 
+  st = _guardRomZones(address, len);
+  if (!st.ok()) {
+    return st;
+  }
+
   st = _activateDevice();
   if (!st.ok()) {
     return _trackIo(st);
@@ -576,10 +735,12 @@ Status Driver::writeEepromPage(uint8_t address, const uint8_t* data, size_t len)
 
   st = _writeRaw(cmd::OPCODE_EEPROM, address, data, len);
   if (!st.ok()) {
+    _updateShadow(cmd::OPCODE_EEPROM, address, data, len, false);
     return _trackIo(st);
   }
 
-  st = waitReady(_config.writeTimeoutMs);
+  st = _waitWriteCycle();
+  _updateShadow(cmd::OPCODE_EEPROM, address, data, len, st.ok());
   return st;
 }
 
@@ -597,6 +758,11 @@ Status Driver::writeEeprom(uint8_t address, const uint8_t* data, size_t len) {
   if (!rangeFits(address, len, cmd::EEPROM_SIZE)) {
     return Status::Error(Err::INVALID_PARAM, "EEPROM write range out of bounds");
   }
+  // Check the whole range so a protected zone never leaves a partial write.
+  init = _guardRomZones(address, len);
+  if (!init.ok()) {
+    return init;
+  }
 
   size_t offset = 0;
   while (offset < len) {
@@ -615,16 +781,24 @@ Status Driver::writeEeprom(uint8_t address, const uint8_t* data, size_t len) {
   return Status::Ok();
 }
 
-Status Driver::readSecurity(uint8_t address, uint8_t* data, size_t len) {
+Status Driver::writeEepromVerified(uint8_t address, const uint8_t* data, size_t len) {
   Status st = _checkInitialized();
   if (!st.ok()) {
     return st;
   }
   if (data == nullptr) {
-    return Status::Error(Err::INVALID_PARAM, "Security read buffer is null");
+    return Status::Error(Err::INVALID_PARAM, "EEPROM write buffer is null");
   }
-  if (!rangeFits(address, len, cmd::SECURITY_SIZE)) {
-    return Status::Error(Err::INVALID_PARAM, "Security read range out of bounds");
+  if (len == 0) {
+    return Status::Error(Err::INVALID_PARAM, "EEPROM write length must be >= 1");
+  }
+  if (!rangeFits(address, len, cmd::EEPROM_SIZE)) {
+    return Status::Error(Err::INVALID_PARAM, "EEPROM write range out of bounds");
+  }
+
+  st = _guardRomZones(address, len);
+  if (!st.ok()) {
+    return st;
   }
 
   st = _activateDevice();
@@ -632,67 +806,38 @@ Status Driver::readSecurity(uint8_t address, uint8_t* data, size_t len) {
     return _trackIo(st);
   }
 
-  st = _readRandomRaw(cmd::OPCODE_SECURITY, address, data, len);
-  return _trackIo(st);
+  st = _writeVerifiedRaw(cmd::OPCODE_EEPROM, address, data, len);
+  return _trackVerified(st);
 }
 
-Status Driver::writeSecurityUserByte(uint8_t address, uint8_t value) {
-  return writeSecurityUserPage(address, &value, 1);
-}
+Status Driver::writeEepromIfChanged(uint8_t address, const uint8_t* data, size_t len,
+                                    uint8_t& pagesSkipped) {
+  pagesSkipped = 0;
 
-Status Driver::writeSecurityUserPage(uint8_t address, const uint8_t* data, size_t len) {
   Status st = _checkInitialized();
   if (!st.ok()) {
     return st;
   }
-  if (!_isSecurityUserAddressValid(address)) {
-    return Status::Error(Err::INVALID_PARAM, "Security writes are allowed only in 0x10..0x1F");
-  }
   if (data == nullptr) {
-    return Status::Error(Err::INVALID_PARAM, "Security write buffer is null");
-  }
-  if (len == 0 || len > cmd::PAGE_SIZE) {
-    return Status::Error(Err::INVALID_PARAM, "Security page write length must be 1..8");
+    return Status::Error(Err::INVALID_PARAM, "EEPROM write buffer is null");
   }
-  const uint16_t endAddress = static_cast<uint16_t>(address) + static_cast<uint16_t>(len);
-  if (endAddress > static_cast<uint16_t>(cmd::SECURITY_USER_MAX) + 1U) {
-    return Status::Error(Err::INVALID_PARAM, "Security write exceeds user area 0x10..0x1F");
+  if (len == 0) {
+    return Status::Error(Err::INVALID_PARAM, "EEPROM write length must be >= 1");
   }
-  if (!staysWithinPage(address, len, cmd::PAGE_SIZE)) {
-    return Status::Error(Err::INVALID_PARAM, "Security page write crosses page boundary");
+  if (!rangeFits(address, len, cmd::EEPROM_SIZE)) {
+    return Status::Error(Err::INVALID_PARAM, "EEPROM write range out of bounds");
   }
 
-  st = _activateDevice();
+  st = _guardRomZones(address, len);
   if (!st.ok()) {
-    return _trackIo(st);
+    return st;
   }
 
-  st = _writeRaw(cmd::OPCODE_SECURITY, address, data, len);
+  // Served from the shadow cache without bus I/O when those pages are valid.
+  uint8_t current[cmd::EEPROM_SIZE];
+  st = readEeprom(address, current, len);
   if (!st.ok()) {
-    return _trackIo(st);
-  }
-
-  st = waitReady(_config.writeTimeoutMs);
-  return st;
-}
-
-Status Driver::writeSecurityUser(uint8_t address, const uint8_t* data, size_t len) {
-  Status init = _checkInitialized();
-  if (!init.ok()) {
-    return init;
-  }
-  if (data == nullptr) {
-    return Status::Error(Err::INVALID_PARAM, "Security write buffer is null");
-  }
-  if (len == 0) {
-    return Status::Error(Err::INVALID_PARAM, "Security write length must be >= 1");
-  }
-  if (!_isSecurityUserAddressValid(address)) {
-    return Status::Error(Err::INVALID_PARAM, "Security writes are allowed only in 0x10..0x1F");
-  }
-  const uint16_t endAddress = static_cast<uint16_t>(address) + static_cast<uint16_t>(len);
-  if (endAddress > static_cast<uint16_t>(cmd::SECURITY_USER_MAX) + 1U) {
-    return Status::Error(Err::INVALID_PARAM, "Security write exceeds user area 0x10..0x1F");
+    return st;
   }
 
   size_t offset = 0;
@@ -703,247 +848,388 @@ Status Driver::writeSecurityUser(uint8_t address, const uint8_t* data, size_t le
     if (chunk > len - offset) {
       chunk = len - offset;
     }
-    Status st = writeSecurityUserPage(curAddr, data + offset, chunk);
-    if (!st.ok()) {
-      return st;
+    if (std::memcmp(&current[offset], data + offset, chunk) == 0) {
+      ++pagesSkipped;
+    } else {
+      st = writeEepromPage(curAddr, data + offset, chunk);
+      if (!st.ok()) {
+        return st;
+      }
     }
     offset += chunk;
   }
   return Status::Ok();
 }
 
-Status Driver::lockSecurityRegister() {
+Status Driver::startWriteEeprom(uint8_t address, const uint8_t* data, size_t len) {
   Status st = _checkInitialized();
   if (!st.ok()) {
     return st;
   }
-
-  const uint8_t lockData = 0x00;
-  st = _activateDevice();
-  if (!st.ok()) {
-    return _trackIo(st);
+  if (data == nullptr) {
+    return Status::Error(Err::INVALID_PARAM, "EEPROM write buffer is null");
+  }
+  if (len == 0) {
+    return Status::Error(Err::INVALID_PARAM, "EEPROM write length must be >= 1");
+  }
+  if (!rangeFits(address, len, cmd::EEPROM_SIZE)) {
+    return Status::Error(Err::INVALID_PARAM, "EEPROM write range out of bounds");
   }
 
-  st = _writeRaw(cmd::OPCODE_LOCK_SECURITY, cmd::LOCK_SECURITY_ADDRESS, &lockData, 1);
+  st = _guardRomZones(address, len);
   if (!st.ok()) {
-    return _trackIo(st);
+    return st;
   }
 
-  st = waitReady(_config.writeTimeoutMs);
-  return st;
+  std::memcpy(_asyncData, data, len);
+  _asyncAddress = address;
+  _asyncLen = static_cast<uint8_t>(len);
+  _asyncOffset = 0;
+  _asyncActive = true;
+  return _asyncIssuePage();
 }
 
-Status Driver::isSecurityLocked(bool& locked) {
-  locked = false;
-
+Status Driver::fillShadowCache() {
   Status st = _checkInitialized();
   if (!st.ok()) {
     return st;
   }
+  if (!_config.shadowCache) {
+    return Status::Error(Err::INVALID_STATE, "Config::shadowCache is disabled");
+  }
 
   st = _activateDevice();
   if (!st.ok()) {
     return _trackIo(st);
   }
 
-  bool ack = false;
-  st = _addressOnlyRaw(cmd::OPCODE_LOCK_SECURITY, true, ack);
+  _shadowEepromValid = 0;
+  _shadowSecurityValid = 0;
+  st = _readEepromRaw(0x00, _shadowEeprom, cmd::EEPROM_SIZE);
   if (!st.ok()) {
     return _trackIo(st);
   }
+  _shadowEepromValid = pageSpanMask(0x00, cmd::EEPROM_SIZE);
 
-  locked = !ack;
-  return _trackIo(Status::Ok());
-}
-
-Status Driver::readSerialNumber(SerialNumberInfo& serial) {
-  std::memset(&serial, 0, sizeof(serial));
-
-  Status st = readSecurity(cmd::SECURITY_SERIAL_START, serial.bytes, cmd::SECURITY_SERIAL_SIZE);
+  st = _readRandomRaw(cmd::OPCODE_SECURITY, 0x00, _shadowSecurity, cmd::SECURITY_SIZE);
   if (!st.ok()) {
-    return st;
+    return _trackIo(st);
   }
+  _shadowSecurityValid = static_cast<uint8_t>(pageSpanMask(0x00, cmd::SECURITY_SIZE));
+  return _trackIo(Status::Ok());
+}
 
-  serial.productIdOk = (serial.bytes[0] == cmd::SECURITY_PRODUCT_ID);
-  const uint8_t crc = crc8_31(serial.bytes, cmd::SECURITY_SERIAL_SIZE - 1U);
-  serial.crcOk = (crc == serial.bytes[cmd::SECURITY_SERIAL_SIZE - 1U]);
-
-  if (!serial.productIdOk) {
-    return Status::Error(Err::PART_MISMATCH, "Serial product ID is not 0xA0");
-  }
-  if (!serial.crcOk) {
-    return Status::Error(Err::CRC_MISMATCH, "Serial number CRC check failed");
-  }
+void Driver::invalidateShadowCache() {
+  _shadowEepromValid = 0;
+  _shadowSecurityValid = 0;
+}
 
-  return Status::Ok();
+void Driver::invalidateIdentityCache() {
+  _manufacturerIdCached = false;
+  _serialCached = false;
+  _securityLockedCached = false;
+  _romZonesFrozenCached = false;
 }
 
-Status Driver::readManufacturerId(uint32_t& manufacturerId) {
+Status Driver::runWaveform(Waveform& wave) {
   Status st = _checkInitialized();
   if (!st.ok()) {
     return st;
   }
+  st = _checkWaveform(wave);
+  if (!st.ok()) {
+    return st;
+  }
 
   st = _activateDevice();
   if (!st.ok()) {
     return _trackIo(st);
   }
 
-  st = _readManufacturerIdRaw(manufacturerId);
-  return _trackIo(st);
+  _prepareWaveform(wave);
+  _replayWaveform(wave);
+  return _trackIo(wave.ackStatus());
 }
 
-Status Driver::detectPart(PartType& part) {
-  part = PartType::UNKNOWN;
-
-  uint32_t manufacturerId = 0;
-  Status st = readManufacturerId(manufacturerId);
-  if (!st.ok()) {
-    return st;
-  }
-
-  if (manufacturerId == cmd::MANUFACTURER_ID_AT21CS01) {
-    part = PartType::AT21CS01;
-  } else if (manufacturerId == cmd::MANUFACTURER_ID_AT21CS11) {
-    part = PartType::AT21CS11;
-  } else {
-    return Status::Error(Err::PART_MISMATCH, "Unknown manufacturer ID", static_cast<int32_t>(manufacturerId));
+Status Driver::startWaveform(Waveform& wave, WaveformDoneFn done, void* user) {
+  if (!_config.timerPhy || wave._mode != SpeedMode::STANDARD_SPEED) {
+    // High-Speed slots are shorter than any alarm latency: spin instead.
+    const Status result = runWaveform(wave);
+    _phyStatus = result;
+    if (done != nullptr) {
+      done(result, user);
+    }
+    return result;
   }
 
-  return Status::Ok();
-}
-
-Status Driver::readRomZoneRegister(uint8_t zoneIndex, uint8_t& value) {
   Status st = _checkInitialized();
   if (!st.ok()) {
     return st;
   }
-  if (!_isZoneIndexValid(zoneIndex)) {
-    return Status::Error(Err::INVALID_PARAM, "zoneIndex must be in range 0..3");
+  st = _checkWaveform(wave);
+  if (!st.ok()) {
+    return st;
   }
-
-  const uint8_t zoneRegisterAddress = cmd::ROM_ZONE_REGISTERS[zoneIndex];
   st = _activateDevice();
   if (!st.ok()) {
     return _trackIo(st);
   }
 
-  st = _readRandomRaw(cmd::OPCODE_ROM_ZONE, zoneRegisterAddress, &value, 1);
-  return _trackIo(st);
+  _prepareWaveform(wave);
+  _phyWave = &wave;
+  _phyDone = done;
+  _phyUser = user;
+  _phyIndex = 0;
+  _phySample = 0;
+  _phyLow = false;
+  _phyStatus = Status::Error(Err::IN_PROGRESS, "Waveform running from timer alarms");
+  _phyUntracked = true;
+  _phyActive = true;
+  _phyRun();
+  return _phyStatus;
 }
 
-Status Driver::isZoneRom(uint8_t zoneIndex, bool& isRom) {
-  isRom = false;
-  uint8_t value = 0;
-  Status st = readRomZoneRegister(zoneIndex, value);
+AT21CS_IRAM void Driver::onTimerAlarm() {
+  if (!_phyActive) {
+    return;
+  }
+  // The alarm ends the symbol started by the previous _phyRun().
+  if (_phyWave->_symbols[_phyIndex].sample()) {
+    _storeWaveSample(*_phyWave, _phySample++);
+  }
+  ++_phyIndex;
+  _phyRun();
+}
+
+Status Driver::runBatch(Batch& batch) {
+  batch._failedOps = 0;
+  batch._firstFailed = -1;
+  Status st = _checkInitialized();
   if (!st.ok()) {
     return st;
   }
+  for (uint8_t i = 0; i < batch._count; ++i) {
+    st = _validateBatchOp(batch, i);
+    if (!st.ok()) {
+      return st;
+    }
+  }
+  for (uint8_t i = 0; i < batch._count; ++i) {
+    batch._status[i] = Status::Error(Err::INVALID_STATE, "Batch operation not run");
+  }
+  if (batch._count == 0) {
+    return Status::Ok();
+  }
 
-  isRom = (value == cmd::ROM_ZONE_ROM_VALUE);
-  return Status::Ok();
+  bool active = false;
+  bool touchedBus = false;
+  Status firstFailure = Status::Ok();
+  Status busFailure = Status::Ok();
+  for (uint8_t i = 0; i < batch._count; ++i) {
+    bool usedBus = false;
+    const Status bus = _runBatchOp(batch, i, active, usedBus);
+    touchedBus = touchedBus || usedBus;
+    const Status& result = batch._status[i];
+    if (result.ok()) {
+      continue;
+    }
+
+    ++batch._failedOps;
+    if (batch._firstFailed < 0) {
+      batch._firstFailed = static_cast<int8_t>(i);
+      firstFailure = result;
+    }
+    if (!bus.ok()) {
+      if (busFailure.ok()) {
+        busFailure = bus;
+      }
+      // The device may be mid-frame or reset; re-activate before the next operation.
+      active = false;
+      _sessionActive = false;
+      _addressPointerValid = false;
+    }
+    if (!batch._continueOnError) {
+      for (uint8_t j = static_cast<uint8_t>(i + 1U); j < batch._count; ++j) {
+        batch._status[j] =
+            Status::Error(Err::INVALID_STATE, "Skipped after earlier batch failure", i);
+      }
+      break;
+    }
+  }
+
+  // One health outcome for the whole batch; shadow-only batches stay untracked.
+  if (touchedBus) {
+    (void)_trackIo(busFailure);
+  }
+  return firstFailure;
 }
 
-Status Driver::setZoneRom(uint8_t zoneIndex) {
+Status Driver::readSecurity(uint8_t address, uint8_t* data, size_t len) {
   Status st = _checkInitialized();
   if (!st.ok()) {
     return st;
   }
-  if (!_isZoneIndexValid(zoneIndex)) {
-    return Status::Error(Err::INVALID_PARAM, "zoneIndex must be in range 0..3");
+  if (data == nullptr) {
+    return Status::Error(Err::INVALID_PARAM, "Security read buffer is null");
+  }
+  if (!rangeFits(address, len, cmd::SECURITY_SIZE)) {
+    return Status::Error(Err::INVALID_PARAM, "Security read range out of bounds");
   }
 
-  const uint8_t zoneRegisterAddress = cmd::ROM_ZONE_REGISTERS[zoneIndex];
-  const uint8_t value = cmd::ROM_ZONE_ROM_VALUE;
-  st = _activateDevice();
-  if (!st.ok()) {
-    return _trackIo(st);
+  if (_config.shadowCache) {
+    return _readShadowed(cmd::OPCODE_SECURITY, address, data, len);
   }
 
-  st = _writeRaw(cmd::OPCODE_ROM_ZONE, zoneRegisterAddress, &value, 1);
+  st = _activateDevice();
   if (!st.ok()) {
     return _trackIo(st);
   }
 
-  st = waitReady(_config.writeTimeoutMs);
-  return st;
+  st = _readRandomRaw(cmd::OPCODE_SECURITY, address, data, len);
+  return _trackIo(st);
 }
 
-Status Driver::freezeRomZones() {
+Status Driver::writeSecurityUserByte(uint8_t address, uint8_t value) {
+  return writeSecurityUserPage(address, &value, 1);
+}
+
+Status Driver::writeSecurityUserPage(uint8_t address, const uint8_t* data, size_t len) {
   Status st = _checkInitialized();
   if (!st.ok()) {
     return st;
   }
+  if (!_isSecurityUserAddressValid(address)) {
+    return Status::Error(Err::INVALID_PARAM, "Security writes are allowed only in 0x10..0x1F");
+  }
+  if (data == nullptr) {
+    return Status::Error(Err::INVALID_PARAM, "Security write buffer is null");
+  }
+  if (len == 0 || len > cmd::PAGE_SIZE) {
+    return Status::Error(Err::INVALID_PARAM, "Security page write length must be 1..8");
+  }
+  const uint16_t endAddress = static_cast<uint16_t>(address) + static_cast<uint16_t>(len);
+  if (endAddress > static_cast<uint16_t>(cmd::SECURITY_USER_MAX) + 1U) {
+    return Status::Error(Err::INVALID_PARAM, "Security write exceeds user area 0x10..0x1F");
+  }
+  if (!staysWithinPage(address, len, cmd::PAGE_SIZE)) {
+    return Status::Error(Err::INVALID_PARAM, "Security page write crosses page boundary");
+  }
 
-  const uint8_t data = cmd::FREEZE_ROM_DATA;
   st = _activateDevice();
   if (!st.ok()) {
     return _trackIo(st);
   }
 
-  st = _writeRaw(cmd::OPCODE_FREEZE_ROM, cmd::FREEZE_ROM_ADDR, &data, 1);
+  st = _writeRaw(cmd::OPCODE_SECURITY, address, data, len);
   if (!st.ok()) {
+    _updateShadow(cmd::OPCODE_SECURITY, address, data, len, false);
     return _trackIo(st);
   }
 
-  st = waitReady(_config.writeTimeoutMs);
+  st = _waitWriteCycle();
+  _updateShadow(cmd::OPCODE_SECURITY, address, data, len, st.ok());
   return st;
 }
 
-Status Driver::areRomZonesFrozen(bool& frozen) {
-  frozen = false;
+Status Driver::writeSecurityUser(uint8_t address, const uint8_t* data, size_t len) {
+  Status init = _checkInitialized();
+  if (!init.ok()) {
+    return init;
+  }
+  if (data == nullptr) {
+    return Status::Error(Err::INVALID_PARAM, "Security write buffer is null");
+  }
+  if (len == 0) {
+    return Status::Error(Err::INVALID_PARAM, "Security write length must be >= 1");
+  }
+  if (!_isSecurityUserAddressValid(address)) {
+    return Status::Error(Err::INVALID_PARAM, "Security writes are allowed only in 0x10..0x1F");
+  }
+  const uint16_t endAddress = static_cast<uint16_t>(address) + static_cast<uint16_t>(len);
+  if (endAddress > static_cast<uint16_t>(cmd::SECURITY_USER_MAX) + 1U) {
+    return Status::Error(Err::INVALID_PARAM, "Security write exceeds user area 0x10..0x1F");
+  }
+
+  size_t offset = 0;
+  while (offset < len) {
+    const uint8_t curAddr = static_cast<uint8_t>(address + offset);
+    const uint8_t pageOffset = curAddr % cmd::PAGE_SIZE;
+    size_t chunk = cmd::PAGE_SIZE - pageOffset;
+    if (chunk > len - offset) {
+      chunk = len - offset;
+    }
+    Status st = writeSecurityUserPage(curAddr, data + offset, chunk);
+    if (!st.ok()) {
+      return st;
+    }
+    offset += chunk;
+  }
+  return Status::Ok();
+}
 
+Status Driver::writeSecurityUserVerified(uint8_t address, const uint8_t* data, size_t len) {
   Status st = _checkInitialized();
   if (!st.ok()) {
     return st;
   }
-
-  st = _activateDevice();
-  if (!st.ok()) {
-    return _trackIo(st);
+  if (data == nullptr) {
+    return Status::Error(Err::INVALID_PARAM, "Security write buffer is null");
+  }
+  if (len == 0) {
+    return Status::Error(Err::INVALID_PARAM, "Security write length must be >= 1");
+  }
+  if (!_isSecurityUserAddressValid(address)) {
+    return Status::Error(Err::INVALID_PARAM, "Security writes are allowed only in 0x10..0x1F");
+  }
+  const uint16_t endAddress = static_cast<uint16_t>(address) + static_cast<uint16_t>(len);
+  if (endAddress > static_cast<uint16_t>(cmd::SECURITY_USER_MAX) + 1U) {
+    return Status::Error(Err::INVALID_PARAM, "Security write exceeds user area 0x10..0x1F");
   }
 
-  bool ack = false;
-  st = _addressOnlyRaw(cmd::OPCODE_FREEZE_ROM, true, ack);
+  st = _activateDevice();
   if (!st.ok()) {
     return _trackIo(st);
   }
 
-  frozen = !ack;
-  return _trackIo(Status::Ok());
+  st = _writeVerifiedRaw(cmd::OPCODE_SECURITY, address, data, len);
+  return _trackVerified(st);
 }
 
-Status Driver::setHighSpeed() {
+Status Driver::lockSecurityRegister() {
   Status st = _checkInitialized();
   if (!st.ok()) {
     return st;
   }
 
+  const uint8_t lockData = 0x00;
   st = _activateDevice();
   if (!st.ok()) {
     return _trackIo(st);
   }
 
-  bool ack = false;
-  st = _addressOnlyRaw(cmd::OPCODE_HIGH_SPEED, false, ack);
+  st = _writeRaw(cmd::OPCODE_LOCK_SECURITY, cmd::LOCK_SECURITY_ADDRESS, &lockData, 1);
   if (!st.ok()) {
     return _trackIo(st);
   }
-  if (!ack) {
-    return _trackIo(Status::Error(Err::NACK_DEVICE_ADDRESS, "High-Speed command NACK"));
-  }
 
-  _setSpeedMode(SpeedMode::HIGH_SPEED);
-  return _trackIo(Status::Ok());
+  st = _waitWriteCycle();
+  if (st.ok() && _config.identityCache) {
+    _securityLockedCached = true;
+  }
+  return st;
 }
 
-Status Driver::isHighSpeed(bool& enabled) {
-  enabled = false;
+Status Driver::isSecurityLocked(bool& locked) {
+  locked = false;
 
   Status st = _checkInitialized();
   if (!st.ok()) {
     return st;
   }
+  if (_securityLockedCached) {
+    locked = true;
+    return Status::Ok();
+  }
 
   st = _activateDevice();
   if (!st.ok()) {
@@ -951,100 +1237,493 @@ Status Driver::isHighSpeed(bool& enabled) {
   }
 
   bool ack = false;
-  st = _addressOnlyRaw(cmd::OPCODE_HIGH_SPEED, true, ack);
+  st = _addressOnlyRaw(cmd::OPCODE_LOCK_SECURITY, true, ack);
   if (!st.ok()) {
     return _trackIo(st);
   }
 
-  enabled = ack;
+  locked = !ack;
+  _securityLockedCached = locked && _config.identityCache;
   return _trackIo(Status::Ok());
 }
 
-Status Driver::setStandardSpeed() {
+Status Driver::readSerialNumber(SerialNumberInfo& serial) {
+  std::memset(&serial, 0, sizeof(serial));
+
+  if (_serialCached) {
+    const Status init = _checkInitialized();
+    if (!init.ok()) {
+      return init;
+    }
+    std::memcpy(serial.bytes, _cachedSerial, sizeof(_cachedSerial));
+    return _checkSerialNumber(serial);
+  }
+
+  Status st = readSecurity(cmd::SECURITY_SERIAL_START, serial.bytes, cmd::SECURITY_SERIAL_SIZE);
+  if (!st.ok()) {
+    return st;
+  }
+
+  st = _checkSerialNumber(serial);
+  _cacheSerial(serial);
+  return st;
+}
+
+Status Driver::readManufacturerId(uint32_t& manufacturerId) {
   Status st = _checkInitialized();
   if (!st.ok()) {
     return st;
   }
+  if (_manufacturerIdCached) {
+    manufacturerId = _cachedManufacturerId;
+    return Status::Ok();
+  }
 
   st = _activateDevice();
   if (!st.ok()) {
     return _trackIo(st);
   }
 
-  bool ack = false;
-  st = _addressOnlyRaw(cmd::OPCODE_STANDARD_SPEED, false, ack);
+  st = _readManufacturerIdRaw(manufacturerId);
+  return _trackIo(st);
+}
+
+Status Driver::detectPart(PartType& part) {
+  part = PartType::UNKNOWN;
+
+  uint32_t manufacturerId = 0;
+  Status st = readManufacturerId(manufacturerId);
   if (!st.ok()) {
-    return _trackIo(st);
+    return st;
   }
-  if (!ack) {
-    if (_detectedPart == PartType::AT21CS11) {
-      return _trackIo(Status::Error(Err::UNSUPPORTED_COMMAND, "AT21CS11 does not support Standard Speed"));
-    }
-    return _trackIo(Status::Error(Err::NACK_DEVICE_ADDRESS, "Standard Speed command NACK"));
+
+  if (manufacturerId == cmd::MANUFACTURER_ID_AT21CS01) {
+    part = PartType::AT21CS01;
+  } else if (manufacturerId == cmd::MANUFACTURER_ID_AT21CS11) {
+    part = PartType::AT21CS11;
+  } else {
+    return Status::Error(Err::PART_MISMATCH, "Unknown manufacturer ID", static_cast<int32_t>(manufacturerId));
   }
 
-  _setSpeedMode(SpeedMode::STANDARD_SPEED);
-  return _trackIo(Status::Ok());
+  return Status::Ok();
 }
 
-Status Driver::isStandardSpeed(bool& enabled) {
-  enabled = false;
-
+Status Driver::readRomZoneRegister(uint8_t zoneIndex, uint8_t& value) {
   Status st = _checkInitialized();
   if (!st.ok()) {
     return st;
   }
-  if (_detectedPart == PartType::AT21CS11) {
-    return Status::Error(Err::UNSUPPORTED_COMMAND, "AT21CS11 does not support Standard Speed");
+  if (!_isZoneIndexValid(zoneIndex)) {
+    return Status::Error(Err::INVALID_PARAM, "zoneIndex must be in range 0..3");
   }
 
+  const uint8_t zoneRegisterAddress = cmd::ROM_ZONE_REGISTERS[zoneIndex];
   st = _activateDevice();
   if (!st.ok()) {
     return _trackIo(st);
   }
 
-  bool ack = false;
-  st = _addressOnlyRaw(cmd::OPCODE_STANDARD_SPEED, true, ack);
+  st = _readRandomRaw(cmd::OPCODE_ROM_ZONE, zoneRegisterAddress, &value, 1);
+  return _trackIo(st);
+}
+
+Status Driver::isZoneRom(uint8_t zoneIndex, bool& isRom) {
+  isRom = false;
+  uint8_t value = 0;
+  Status st = readRomZoneRegister(zoneIndex, value);
   if (!st.ok()) {
-    return _trackIo(st);
+    return st;
   }
 
-  enabled = ack;
-  return _trackIo(Status::Ok());
+  isRom = (value == cmd::ROM_ZONE_ROM_VALUE);
+  if (isRom && _romZoneMaskValid) {
+    _romZoneMask = static_cast<uint8_t>(_romZoneMask | (1U << zoneIndex));
+  }
+  return Status::Ok();
 }
 
-uint8_t Driver::crc8_31(const uint8_t* data, size_t len) {
-  if (len == 0) {
-    return 0;
+Status Driver::setZoneRom(uint8_t zoneIndex) {
+  Status st = _checkInitialized();
+  if (!st.ok()) {
+    return st;
   }
-  if (data == nullptr) {
-    return 0;
+  if (!_isZoneIndexValid(zoneIndex)) {
+    return Status::Error(Err::INVALID_PARAM, "zoneIndex must be in range 0..3");
   }
 
-  uint8_t crc = 0x00;
-  for (size_t i = 0; i < len; ++i) {
-    crc ^= data[i];
-    for (uint8_t bit = 0; bit < 8; ++bit) {
-      if ((crc & 0x01U) != 0U) {
-        crc = static_cast<uint8_t>((crc >> 1U) ^ 0x8CU);
-      } else {
-        crc = static_cast<uint8_t>(crc >> 1U);
-      }
-    }
+  const uint8_t zoneRegisterAddress = cmd::ROM_ZONE_REGISTERS[zoneIndex];
+  const uint8_t value = cmd::ROM_ZONE_ROM_VALUE;
+  st = _activateDevice();
+  if (!st.ok()) {
+    return _trackIo(st);
   }
-  return crc;
-}
 
-Status Driver::_trackIo(const Status& st) {
-  if (!_initialized) {
-    return st;
+  st = _writeRaw(cmd::OPCODE_ROM_ZONE, zoneRegisterAddress, &value, 1);
+  if (!st.ok()) {
+    return _trackIo(st);
   }
 
-  const uint32_t nowMs = _nowMs();
-  if (st.ok()) {
-    _lastOkMs = nowMs;
-    _lastError = Status::Ok();
-    _consecutiveFailures = 0;
+  st = _waitWriteCycle();
+  if (st.ok() && _romZoneMaskValid) {
+    _romZoneMask = static_cast<uint8_t>(_romZoneMask | (1U << zoneIndex));
+  }
+  return st;
+}
+
+Status Driver::freezeRomZones() {
+  Status st = _checkInitialized();
+  if (!st.ok()) {
+    return st;
+  }
+
+  const uint8_t data = cmd::FREEZE_ROM_DATA;
+  st = _activateDevice();
+  if (!st.ok()) {
+    return _trackIo(st);
+  }
+
+  st = _writeRaw(cmd::OPCODE_FREEZE_ROM, cmd::FREEZE_ROM_ADDR, &data, 1);
+  if (!st.ok()) {
+    return _trackIo(st);
+  }
+
+  st = _waitWriteCycle();
+  if (st.ok() && _config.identityCache) {
+    _romZonesFrozenCached = true;
+  }
+  return st;
+}
+
+Status Driver::areRomZonesFrozen(bool& frozen) {
+  frozen = false;
+
+  Status st = _checkInitialized();
+  if (!st.ok()) {
+    return st;
+  }
+  if (_romZonesFrozenCached) {
+    frozen = true;
+    return Status::Ok();
+  }
+
+  st = _activateDevice();
+  if (!st.ok()) {
+    return _trackIo(st);
+  }
+
+  bool ack = false;
+  st = _addressOnlyRaw(cmd::OPCODE_FREEZE_ROM, true, ack);
+  if (!st.ok()) {
+    return _trackIo(st);
+  }
+
+  frozen = !ack;
+  _romZonesFrozenCached = frozen && _config.identityCache;
+  return _trackIo(Status::Ok());
+}
+
+Status Driver::setHighSpeed() {
+  Status st = _checkInitialized();
+  if (!st.ok()) {
+    return st;
+  }
+
+  st = _activateDevice();
+  if (!st.ok()) {
+    return _trackIo(st);
+  }
+
+  bool ack = false;
+  st = _addressOnlyRaw(cmd::OPCODE_HIGH_SPEED, false, ack);
+  if (!st.ok()) {
+    return _trackIo(st);
+  }
+  if (!ack) {
+    return _trackIo(Status::Error(Err::NACK_DEVICE_ADDRESS, "High-Speed command NACK"));
+  }
+
+  _setSpeedMode(SpeedMode::HIGH_SPEED);
+  _requestedSpeed = SpeedMode::HIGH_SPEED;
+  return _trackIo(Status::Ok());
+}
+
+Status Driver::isHighSpeed(bool& enabled) {
+  enabled = false;
+
+  Status st = _checkInitialized();
+  if (!st.ok()) {
+    return st;
+  }
+
+  st = _activateDevice();
+  if (!st.ok()) {
+    return _trackIo(st);
+  }
+
+  bool ack = false;
+  st = _addressOnlyRaw(cmd::OPCODE_HIGH_SPEED, true, ack);
+  if (!st.ok()) {
+    return _trackIo(st);
+  }
+
+  enabled = ack;
+  return _trackIo(Status::Ok());
+}
+
+Status Driver::setStandardSpeed() {
+  Status st = _checkInitialized();
+  if (!st.ok()) {
+    return st;
+  }
+
+  st = _activateDevice();
+  if (!st.ok()) {
+    return _trackIo(st);
+  }
+
+  bool ack = false;
+  st = _addressOnlyRaw(cmd::OPCODE_STANDARD_SPEED, false, ack);
+  if (!st.ok()) {
+    return _trackIo(st);
+  }
+  if (!ack) {
+    if (_detectedPart == PartType::AT21CS11) {
+      return _trackIo(Status::Error(Err::UNSUPPORTED_COMMAND, "AT21CS11 does not support Standard Speed"));
+    }
+    return _trackIo(Status::Error(Err::NACK_DEVICE_ADDRESS, "Standard Speed command NACK"));
+  }
+
+  _setSpeedMode(SpeedMode::STANDARD_SPEED);
+  _requestedSpeed = SpeedMode::STANDARD_SPEED;
+  return _trackIo(Status::Ok());
+}
+
+Status Driver::isStandardSpeed(bool& enabled) {
+  enabled = false;
+
+  Status st = _checkInitialized();
+  if (!st.ok()) {
+    return st;
+  }
+  if (_detectedPart == PartType::AT21CS11) {
+    return Status::Error(Err::UNSUPPORTED_COMMAND, "AT21CS11 does not support Standard Speed");
+  }
+
+  st = _activateDevice();
+  if (!st.ok()) {
+    return _trackIo(st);
+  }
+
+  bool ack = false;
+  st = _addressOnlyRaw(cmd::OPCODE_STANDARD_SPEED, true, ack);
+  if (!st.ok()) {
+    return _trackIo(st);
+  }
+
+  enabled = ack;
+  return _trackIo(Status::Ok());
+}
+
+Status Driver::validateTimingProfile(const TimingProfile& profile, SpeedMode mode) {
+  const TimingLimits& lim =
+      (mode == SpeedMode::STANDARD_SPEED) ? STANDARD_SPEED_LIMITS : HIGH_SPEED_LIMITS;
+  if (profile.low0Ns < lim.low0MinNs || profile.low0Ns > lim.low0MaxNs) {
+    return Status::Error(Err::INVALID_CONFIG, "low0Ns outside t_LOW0 limits");
+  }
+  if (profile.low1Ns < lim.low1MinNs || profile.low1Ns > lim.low1MaxNs) {
+    return Status::Error(Err::INVALID_CONFIG, "low1Ns outside t_LOW1 limits");
+  }
+  if (profile.readLowNs < lim.low1MinNs || profile.readLowNs > lim.low1MaxNs) {
+    return Status::Error(Err::INVALID_CONFIG, "readLowNs outside t_RD limits");
+  }
+  if (profile.readLowNs + profile.readSampleNs > lim.sampleMaxNs) {
+    return Status::Error(Err::INVALID_CONFIG, "readLowNs + readSampleNs past t_MRS");
+  }
+  if (profile.bitNs < lim.bitMinNs || profile.bitNs > lim.bitMaxNs) {
+    return Status::Error(Err::INVALID_CONFIG, "bitNs outside t_BIT limits");
+  }
+  if (profile.bitNs < profile.low0Ns + lim.recoveryMinNs ||
+      profile.bitNs < profile.readLowNs + profile.readSampleNs + lim.recoveryMinNs) {
+    return Status::Error(Err::INVALID_CONFIG, "bitNs leaves less than t_RCV after the low phase");
+  }
+  if (profile.htssNs < lim.htssMinNs) {
+    return Status::Error(Err::INVALID_CONFIG, "htssNs below t_HTSS");
+  }
+  return Status::Ok();
+}
+
+Status Driver::setTimingProfile(SpeedMode mode, const TimingProfile& profile) {
+  if (!isValidSpeedMode(mode)) {
+    return Status::Error(Err::INVALID_PARAM, "invalid speed mode enum");
+  }
+  Status st = _checkInitialized(true);
+  if (!st.ok()) {
+    return st;
+  }
+  st = validateTimingProfile(profile, mode);
+  if (!st.ok()) {
+    return st;
+  }
+  if (mode == SpeedMode::STANDARD_SPEED) {
+    _config.standardSpeedTiming = profile;
+  } else {
+    _config.highSpeedTiming = profile;
+  }
+  if (mode == _speedMode) {
+    _setSpeedMode(_speedMode);
+  }
+  return Status::Ok();
+}
+
+Status Driver::characterizeTiming(TimingScanResult& result, const TimingScanConfig& scan) {
+  result = TimingScanResult{};
+  Status st = _checkInitialized();
+  if (!st.ok()) {
+    return st;
+  }
+  if (scan.stepNs == 0 || scan.trials == 0) {
+    return Status::Error(Err::INVALID_PARAM, "stepNs and trials must be > 0");
+  }
+
+  // Reference pattern with the active profile; a failure here is a real I/O error.
+  uint8_t reference[TIMING_SCAN_PATTERN_BYTES] = {};
+  _sessionActive = false;
+  st = _activateDevice();
+  if (st.ok()) {
+    st = _readRandomRaw(cmd::OPCODE_SECURITY, 0, reference, cmd::SECURITY_SERIAL_SIZE);
+  }
+  if (st.ok()) {
+    st = _readRandomRaw(cmd::OPCODE_EEPROM, 0, reference + cmd::SECURITY_SERIAL_SIZE,
+                        TIMING_SCAN_EEPROM_BYTES);
+  }
+  if (st.ok() && crc8_31(reference, cmd::SECURITY_SERIAL_SIZE - 1U) !=
+                     reference[cmd::SECURITY_SERIAL_SIZE - 1U]) {
+    st = Status::Error(Err::CRC_MISMATCH, "Reference serial CRC mismatch");
+  }
+  if (!st.ok()) {
+    return _trackIo(st);
+  }
+
+  const TimingProfile active = _timing;
+  const TimingLimits& lim =
+      (_speedMode == SpeedMode::STANDARD_SPEED) ? STANDARD_SPEED_LIMITS : HIGH_SPEED_LIMITS;
+  const uint32_t step = scan.stepNs;
+  const uint32_t margin = scan.marginNs;
+
+  st = _scanTimingWindow(&TimingProfile::bitNs, active.low0Ns + step, lim.bitMaxNs, scan,
+                         reference, result.bit, result.candidates);
+  if (st.ok()) {
+    st = _scanTimingWindow(&TimingProfile::low0Ns, lim.low1MaxNs, active.bitNs - step, scan,
+                           reference, result.low0, result.candidates);
+  }
+  if (st.ok()) {
+    st = _scanTimingWindow(&TimingProfile::low1Ns, step, lim.low0MinNs, scan, reference,
+                           result.low1, result.candidates);
+  }
+  // Read-slot candidates never sample past t_MRS.
+  if (st.ok()) {
+    st = _scanTimingWindow(&TimingProfile::readLowNs, step,
+                           lim.sampleMaxNs - active.readSampleNs, scan, reference,
+                           result.readLow, result.candidates);
+  }
+  if (st.ok()) {
+    st = _scanTimingWindow(&TimingProfile::readSampleNs, 0,
+                           lim.sampleMaxNs - active.readLowNs, scan, reference,
+                           result.readSample, result.candidates);
+  }
+  _sessionActive = false;
+  _addressPointerValid = false;
+  if (!st.ok()) {
+    return _trackIo(st);
+  }
+  (void)_trackIo(Status::Ok());
+
+  // Low times at the centre of their window clipped to the datasheet range;
+  // t_LOW0 and t_RD as short as the margin allows, so the sample point keeps
+  // the most of t_MRS.
+  auto centred = [margin](const TimingWindow& window, uint32_t minNs, uint32_t maxNs,
+                          uint32_t& value) {
+    const uint32_t lo = (window.minNs > minNs) ? window.minNs : minNs;
+    const uint32_t hi = (window.maxNs < maxNs) ? window.maxNs : maxNs;
+    if (hi < lo || hi - lo < 2U * margin) {
+      return false;
+    }
+    value = lo + (hi - lo) / 2U;
+    return true;
+  };
+
+  TimingProfile& out = result.profile;
+  out = active;
+  const uint32_t low0Lo = (result.low0.minNs > lim.low0MinNs) ? result.low0.minNs : lim.low0MinNs;
+  const uint32_t low0Hi = (result.low0.maxNs < lim.low0MaxNs) ? result.low0.maxNs : lim.low0MaxNs;
+  if (low0Hi < low0Lo || low0Hi - low0Lo < 2U * margin) {
+    return Status::Error(Err::IO_ERROR, "t_LOW0 window narrower than margin", 1);
+  }
+  out.low0Ns = low0Lo + margin;
+  if (!centred(result.low1, lim.low1MinNs, lim.low1MaxNs, out.low1Ns)) {
+    return Status::Error(Err::IO_ERROR, "t_LOW1 window narrower than margin", 2);
+  }
+  // A window reaching the t_RD minimum needs no margin below it.
+  out.readLowNs = (result.readLow.minNs <= lim.low1MinNs) ? lim.low1MinNs
+                                                          : result.readLow.minNs + margin;
+  if (out.readLowNs > result.readLow.maxNs || out.readLowNs > lim.low1MaxNs ||
+      out.readLowNs >= lim.sampleMaxNs) {
+    return Status::Error(Err::IO_ERROR, "t_RD window narrower than margin", 3);
+  }
+  if (!centred(result.readSample, 0, lim.sampleMaxNs - out.readLowNs, out.readSampleNs)) {
+    return Status::Error(Err::IO_ERROR, "Sample window narrower than margin", 4);
+  }
+
+  // t_BIT keeps the measured high-time need (t_PUP + t_RCV), never below t_RCV.
+  const uint32_t measuredHighNs = result.bit.minNs - active.low0Ns;
+  const uint32_t highNs = (measuredHighNs > lim.recoveryMinNs) ? measuredHighNs : lim.recoveryMinNs;
+  uint32_t bitNs = out.low0Ns + highNs + margin;
+  const uint32_t readSlotNs = out.readLowNs + out.readSampleNs + lim.recoveryMinNs + margin;
+  bitNs = (bitNs > readSlotNs) ? bitNs : readSlotNs;
+  bitNs = (bitNs > lim.bitMinNs) ? bitNs : lim.bitMinNs;
+  if (bitNs > lim.bitMaxNs || bitNs > result.bit.maxNs) {
+    return Status::Error(Err::IO_ERROR, "t_BIT window narrower than margin", 0);
+  }
+  out.bitNs = bitNs;
+
+  st = validateTimingProfile(out, _speedMode);
+  if (!st.ok()) {
+    return Status::Error(Err::IO_ERROR, "Suggested timing profile outside limits", 5);
+  }
+  bool passed = false;
+  st = _timingTrial(out, reference, scan.trials, passed);
+  _sessionActive = false;
+  _addressPointerValid = false;
+  if (!st.ok()) {
+    return _trackIo(st);
+  }
+  if (!passed) {
+    return Status::Error(Err::IO_ERROR, "Suggested timing profile failed verification", 5);
+  }
+  return Status::Ok();
+}
+
+uint8_t Driver::crc8_31(const uint8_t* data, size_t len) {
+  if (len == 0) {
+    return 0;
+  }
+  if (data == nullptr) {
+    return 0;
+  }
+  return crc::crc8_31(data, len);
+}
+
+Status Driver::_trackIo(const Status& st) {
+  if (!_initialized) {
+    return st;
+  }
+
+  const uint32_t nowMs = _nowMs();
+  if (st.ok()) {
+    _sessionLastMs = nowMs;
+    _lastOkMs = nowMs;
+    _lastError = Status::Ok();
+    _consecutiveFailures = 0;
     incrementWrap(_totalSuccess);
     if (_driverState != DriverState::SLEEPING) {
       _driverState = DriverState::READY;
@@ -1052,6 +1731,9 @@ Status Driver::_trackIo(const Status& st) {
     return st;
   }
 
+  // Any failure may leave the device mid-transaction or reset; re-activate next time.
+  _sessionActive = false;
+  _addressPointerValid = false;
   _lastErrorMs = nowMs;
   _lastError = st;
   incrementWrap(_totalFailures);
@@ -1062,6 +1744,7 @@ Status Driver::_trackIo(const Status& st) {
     return st;
   }
   if (st.code == Err::NOT_PRESENT) {
+    invalidateShadowCache();
     _driverState = DriverState::OFFLINE;
     return st;
   }
@@ -1079,6 +1762,12 @@ Status Driver::_checkInitialized(bool allowOffline) const {
   if (!_initialized) {
     return Status::Error(Err::NOT_INITIALIZED, "begin() must succeed before this operation");
   }
+  if (_asyncActive) {
+    return Status::Error(Err::INVALID_STATE, "Asynchronous write in progress; call tick()");
+  }
+  if (_phyUntracked) {
+    return Status::Error(Err::INVALID_STATE, "Timer-driven waveform in progress; call tick()");
+  }
   if (!allowOffline && _driverState == DriverState::OFFLINE) {
     return Status::Error(Err::INVALID_STATE, "Driver is offline; call recover()");
   }
@@ -1093,37 +1782,39 @@ Status Driver::_checkInitialized(bool allowOffline) const {
 
 Status Driver::_configurePins() {
 #if defined(ARDUINO_ARCH_ESP32)
-  gpio_config_t sioCfg{};
-  sioCfg.pin_bit_mask = (1ULL << static_cast<uint8_t>(_config.sioPin));
-  sioCfg.mode = GPIO_MODE_INPUT_OUTPUT_OD;
-  sioCfg.pull_up_en = GPIO_PULLUP_DISABLE;
-  sioCfg.pull_down_en = GPIO_PULLDOWN_DISABLE;
-  sioCfg.intr_type = GPIO_INTR_DISABLE;
-
-  if (gpio_config(&sioCfg) != ESP_OK) {
-    return Status::Error(Err::INVALID_CONFIG, "Failed to configure sioPin", _config.sioPin);
-  }
-  if (gpio_set_level(static_cast<gpio_num_t>(_config.sioPin), 1) != ESP_OK) {
-    return Status::Error(Err::INVALID_CONFIG, "Failed to release sioPin", _config.sioPin);
-  }
-
-  // Cache direct-register pointers for sub-microsecond GPIO access.
-  const uint8_t pin = static_cast<uint8_t>(_config.sioPin);
-  if (pin < 32) {
-    _gpioSetReg = reinterpret_cast<volatile uint32_t*>(GPIO_OUT_W1TS_REG);
-    _gpioClrReg = reinterpret_cast<volatile uint32_t*>(GPIO_OUT_W1TC_REG);
-    _gpioInReg  = reinterpret_cast<volatile uint32_t*>(GPIO_IN_REG);
-    _gpioMask   = (1U << pin);
-  } else {
-    _gpioSetReg = reinterpret_cast<volatile uint32_t*>(GPIO_OUT1_W1TS_REG);
-    _gpioClrReg = reinterpret_cast<volatile uint32_t*>(GPIO_OUT1_W1TC_REG);
-    _gpioInReg  = reinterpret_cast<volatile uint32_t*>(GPIO_IN1_REG);
-    _gpioMask   = (1U << (pin - 32));
-  }
-
   // Cache CPU frequency for cycle-accurate timing.
   _cyclesPerUs = static_cast<uint32_t>(getCpuFrequencyMhz());
 
+  if (_config.lineWrite == nullptr) {
+    gpio_config_t sioCfg{};
+    sioCfg.pin_bit_mask = (1ULL << static_cast<uint8_t>(_config.sioPin));
+    sioCfg.mode = GPIO_MODE_INPUT_OUTPUT_OD;
+    sioCfg.pull_up_en = GPIO_PULLUP_DISABLE;
+    sioCfg.pull_down_en = GPIO_PULLDOWN_DISABLE;
+    sioCfg.intr_type = GPIO_INTR_DISABLE;
+
+    if (gpio_config(&sioCfg) != ESP_OK) {
+      return Status::Error(Err::INVALID_CONFIG, "Failed to configure sioPin", _config.sioPin);
+    }
+    if (gpio_set_level(static_cast<gpio_num_t>(_config.sioPin), 1) != ESP_OK) {
+      return Status::Error(Err::INVALID_CONFIG, "Failed to release sioPin", _config.sioPin);
+    }
+
+    // Cache direct-register pointers for sub-microsecond GPIO access.
+    const uint8_t pin = static_cast<uint8_t>(_config.sioPin);
+    if (pin < 32) {
+      _gpioSetReg = reinterpret_cast<volatile uint32_t*>(GPIO_OUT_W1TS_REG);
+      _gpioClrReg = reinterpret_cast<volatile uint32_t*>(GPIO_OUT_W1TC_REG);
+      _gpioInReg  = reinterpret_cast<volatile uint32_t*>(GPIO_IN_REG);
+      _gpioMask   = (1U << pin);
+    } else {
+      _gpioSetReg = reinterpret_cast<volatile uint32_t*>(GPIO_OUT1_W1TS_REG);
+      _gpioClrReg = reinterpret_cast<volatile uint32_t*>(GPIO_OUT1_W1TC_REG);
+      _gpioInReg  = reinterpret_cast<volatile uint32_t*>(GPIO_IN1_REG);
+      _gpioMask   = (1U << (pin - 32));
+    }
+  }
+
   if (_config.presencePin >= 0) {
     gpio_config_t presenceCfg{};
     presenceCfg.pin_bit_mask = (1ULL << static_cast<uint8_t>(_config.presencePin));
@@ -1136,13 +1827,33 @@ Status Driver::_configurePins() {
     }
   }
 #else
-  pinMode(static_cast<uint8_t>(_config.sioPin), OUTPUT_OPEN_DRAIN);
-  digitalWrite(static_cast<uint8_t>(_config.sioPin), HIGH);
+  if (_config.lineWrite == nullptr) {
+    pinMode(static_cast<uint8_t>(_config.sioPin), OUTPUT_OPEN_DRAIN);
+    digitalWrite(static_cast<uint8_t>(_config.sioPin), HIGH);
+  }
   if (_config.presencePin >= 0) {
     pinMode(static_cast<uint8_t>(_config.presencePin), INPUT);
   }
 #endif
 
+  // A custom PHY backend owns the SI/O line; start it released.
+  if (_config.lineWrite != nullptr) {
+    _config.lineWrite(false, _config.lineUser);
+  }
+
+#if defined(ARDUINO_ARCH_ESP32)
+  // Cycle-domain bit timing needs direct GPIO and the built-in clock. The
+  // segments are rebuilt for this CPU frequency net of the measured overhead.
+  _cycleTimed = false;
+  _edgeOverheadCycles = 0;
+  _updateSegments();
+  if (_config.lineWrite == nullptr && _config.sleepUs == nullptr && _gpioSetReg != nullptr) {
+    _cycleTimed = true;
+    _measureEdgeOverhead();
+    _updateSegments();
+  }
+#endif
+
   return Status::Ok();
 }
 
@@ -1155,7 +1866,11 @@ bool Driver::_presencePinReportsPresent() const {
 }
 
 AT21CS_IRAM void Driver::_releaseLine() {
-#if defined(ARDUINO_ARCH_ESP32)
+  if (_config.lineWrite != nullptr) {
+    _config.lineWrite(false, _config.lineUser);
+    return;
+  }
+#if defined(ARDUINO_ARCH_ESP32)
   if (_gpioSetReg == nullptr) {
     return;
   }
@@ -1166,6 +1881,10 @@ AT21CS_IRAM void Driver::_releaseLine() {
 }
 
 AT21CS_IRAM void Driver::_lineLow() {
+  if (_config.lineWrite != nullptr) {
+    _config.lineWrite(true, _config.lineUser);
+    return;
+  }
 #if defined(ARDUINO_ARCH_ESP32)
   if (_gpioClrReg == nullptr) {
     return;
@@ -1177,6 +1896,9 @@ AT21CS_IRAM void Driver::_lineLow() {
 }
 
 AT21CS_IRAM bool Driver::_readLine() const {
+  if (_config.lineRead != nullptr) {
+    return _config.lineRead(_config.lineUser);
+  }
 #if defined(ARDUINO_ARCH_ESP32)
   if (_gpioInReg == nullptr) {
     return true;
@@ -1201,277 +1923,1319 @@ AT21CS_IRAM bool Driver::readLine() {
 }
 
 AT21CS_IRAM void Driver::txBit0() {
+  const bool perBit = _config.criticalSection == CriticalSection::PER_BIT;
+  if (perBit) {
+    _enterCritical();
+  }
+
   _lineLow();
-  _sleepUs(_timing.low0Us);
+  _waitSegment(SEG_LOW0);
   _releaseLine();
+  _waitSegment(SEG_HIGH0);
 
-  if (_timing.bitUs > _timing.low0Us) {
-    _sleepUs(static_cast<uint32_t>(_timing.bitUs - _timing.low0Us));
+  if (perBit) {
+    _exitCritical();
   }
 }
 
 AT21CS_IRAM void Driver::txBit1() {
+  const bool perBit = _config.criticalSection == CriticalSection::PER_BIT;
+  if (perBit) {
+    _enterCritical();
+  }
+
+  _lineLow();
+  _waitSegment(SEG_LOW1);
+  _releaseLine();
+  _waitSegment(SEG_HIGH1);
+
+  if (perBit) {
+    _exitCritical();
+  }
+}
+
+AT21CS_IRAM bool Driver::rxBit() {
+  const bool perBit = _config.criticalSection == CriticalSection::PER_BIT;
+  if (perBit) {
+    _enterCritical();
+  }
+
+  _lineLow();
+  _waitSegment(SEG_READ_LOW);
+  _releaseLine();
+  _waitSegment(SEG_READ_SAMPLE);
+
+  const bool bit = _readLine();
+  _waitSegment(SEG_READ_REST);
+
+  if (perBit) {
+    _exitCritical();
+  }
+  return bit;
+}
+
+AT21CS_IRAM bool Driver::txByte(uint8_t value) {
+  const bool perByte = _config.criticalSection == CriticalSection::PER_BYTE;
+  if (perByte) {
+    _enterCritical();
+  }
+
+  for (int8_t bit = 7; bit >= 0; --bit) {
+    const bool one = ((value >> bit) & 0x01U) != 0U;
+    if (one) {
+      txBit1();
+    } else {
+      txBit0();
+    }
+  }
+
+  const bool ack = !rxBit();
+
+  if (perByte) {
+    _exitCritical();
+  }
+
+  return ack;
+}
+
+AT21CS_IRAM uint8_t Driver::rxByte(bool ack) {
+  const bool perByte = _config.criticalSection == CriticalSection::PER_BYTE;
+  if (perByte) {
+    _enterCritical();
+  }
+
+  uint8_t value = 0;
+  for (int8_t bit = 7; bit >= 0; --bit) {
+    if (rxBit()) {
+      value = static_cast<uint8_t>(value | static_cast<uint8_t>(1U << bit));
+    }
+  }
+
+  if (ack) {
+    txBit0();
+  } else {
+    txBit1();
+  }
+
+  if (perByte) {
+    _exitCritical();
+  }
+
+  return value;
+}
+
+AT21CS_IRAM void Driver::_sendStart() {
+  // Interrupts may run during the idle time: a longer high is still a Start.
+  _endTransactionMask();
+  _releaseLine();
+  _waitSegment(SEG_HTSS);
+  _beginTransactionMask();
+}
+
+AT21CS_IRAM void Driver::_sendStop() {
+  _endTransactionMask();
+  _releaseLine();
+  _waitSegment(SEG_HTSS);
+
+  // Each Stop closes one measured transaction.
+  _masking.transactions = (_masking.transactions == UINT32_MAX) ? UINT32_MAX
+                                                                : _masking.transactions + 1U;
+  _masking.lastTotalUs = _maskTxnTotalUs;
+  _masking.lastMaxUs = _maskTxnMaxUs;
+  if (_maskTxnTotalUs > _masking.peakTotalUs) {
+    _masking.peakTotalUs = _maskTxnTotalUs;
+  }
+  _maskTxnTotalUs = 0;
+  _maskTxnMaxUs = 0;
+}
+
+AT21CS_IRAM void Driver::_enterCritical() {
+#if defined(ARDUINO_ARCH_ESP32)
+  // _SAFE variants: the timer PHY also masks from its alarm handler.
+  portENTER_CRITICAL_SAFE(&_timingMux);
+  _maskStartCycles = esp_cpu_get_cycle_count();
+#endif
+  _maskSleptUs = 0;
+  _masked = true;
+}
+
+AT21CS_IRAM void Driver::_exitCritical() {
+#if defined(ARDUINO_ARCH_ESP32)
+  const uint32_t windowUs = (esp_cpu_get_cycle_count() - _maskStartCycles) / _cyclesPerUs;
+  portEXIT_CRITICAL_SAFE(&_timingMux);
+#else
+  const uint32_t windowUs = _maskSleptUs;
+#endif
+  _masked = false;
+
+  _maskTxnTotalUs = saturatedAdd(_maskTxnTotalUs, windowUs);
+  _masking.totalUs = saturatedAdd(_masking.totalUs, windowUs);
+  if (windowUs > _maskTxnMaxUs) {
+    _maskTxnMaxUs = windowUs;
+  }
+  if (windowUs > _masking.peakWindowUs) {
+    _masking.peakWindowUs = windowUs;
+  }
+}
+
+AT21CS_IRAM void Driver::_beginTransactionMask() {
+  if (_config.criticalSection == CriticalSection::PER_TRANSACTION && !_transactionMasked) {
+    _transactionMasked = true;
+    _enterCritical();
+  }
+}
+
+AT21CS_IRAM void Driver::_endTransactionMask() {
+  if (_transactionMasked) {
+    _transactionMasked = false;
+    _exitCritical();
+  }
+}
+
+uint8_t Driver::_deviceAddress(uint8_t opcode, bool read) const {
+  return cmd::deviceAddress(opcode, _config.addressBits, read);
+}
+
+Status Driver::_activateDevice() {
+  if (_sessionUsable()) {
+    return Status::Ok();
+  }
+
+  const SpeedMode desiredSpeed = _requestedSpeed;
+  Status st = Status::Error(Err::DISCOVERY_FAILED, "Discovery failed");
+  const uint16_t attempts = retryAttempts(_config.discoveryRetries);
+  for (uint16_t attempt = 0; attempt < attempts; ++attempt) {
+    st = _resetAndDiscoverRaw();
+    if (st.ok()) {
+      break;
+    }
+  }
+  if (!st.ok()) {
+    return st;
+  }
+
+  if (desiredSpeed == SpeedMode::STANDARD_SPEED) {
+    if (_detectedPart == PartType::AT21CS11) {
+      return Status::Error(Err::UNSUPPORTED_COMMAND, "AT21CS11 does not support Standard Speed");
+    }
+
+    bool ack = false;
+    st = _addressOnlyRaw(cmd::OPCODE_STANDARD_SPEED, false, ack);
+    if (!st.ok()) {
+      return st;
+    }
+    if (!ack) {
+      return Status::Error(Err::NACK_DEVICE_ADDRESS, "Standard Speed command NACK during activation");
+    }
+    _setSpeedMode(SpeedMode::STANDARD_SPEED);
+  }
+
+  _sessionActive = _config.persistentSession;
+  _sessionLastMs = _nowMs();
+  return Status::Ok();
+}
+
+Status Driver::_asyncIssuePage() {
+  const uint8_t curAddr = static_cast<uint8_t>(_asyncAddress + _asyncOffset);
+  const uint8_t pageOffset = curAddr % cmd::PAGE_SIZE;
+  size_t chunk = cmd::PAGE_SIZE - pageOffset;
+  if (chunk > static_cast<size_t>(_asyncLen - _asyncOffset)) {
+    chunk = static_cast<size_t>(_asyncLen - _asyncOffset);
+  }
+  _asyncChunk = static_cast<uint8_t>(chunk);
+
+  Status st = _activateDevice();
+  if (st.ok()) {
+    st = _writeRaw(cmd::OPCODE_EEPROM, curAddr, &_asyncData[_asyncOffset], chunk);
+  }
+  if (!st.ok()) {
+    _updateShadow(cmd::OPCODE_EEPROM, curAddr, &_asyncData[_asyncOffset], chunk, false);
+    _asyncFinish(st);
+    return _asyncStatus;
+  }
+
+  _driverState = DriverState::BUSY;
+  _asyncPageStartMs = _nowMs();
+  _asyncStatus = Status::Error(Err::IN_PROGRESS, "EEPROM write in progress");
+  return _asyncStatus;
+}
+
+void Driver::_asyncPoll() {
+  if (_config.presencePin >= 0 && !_presencePinReportsPresent()) {
+    _asyncFinish(Status::Error(Err::NOT_PRESENT, "Presence pin indicates device absent"));
+    return;
+  }
+
+  // Skip bus polls until most of the learned t_WR has passed.
+  const uint32_t headUs = _writeCycleHeadUs();
+  if (headUs > 0U && (_nowMs() - _asyncPageStartMs) * 1000U < headUs) {
+    return;
+  }
+
+  const uint8_t curAddr = static_cast<uint8_t>(_asyncAddress + _asyncOffset);
+  bool ack = false;
+  (void)_addressOnlyRaw(cmd::OPCODE_EEPROM, false, ack);
+  if (!ack) {
+    if ((_nowMs() - _asyncPageStartMs) >= _config.writeTimeoutMs) {
+      _updateShadow(cmd::OPCODE_EEPROM, curAddr, &_asyncData[_asyncOffset], _asyncChunk, false);
+      _asyncFinish(
+          Status::Error(Err::BUSY_TIMEOUT, "Timed out waiting for write cycle completion"));
+    }
+    return;
+  }
+
+  // The ACK is seen at the first tick() after t_WR, on a millisecond clock, so
+  // this is only an upper bound: it may pull the learned estimate down but
+  // never raises or seeds it.
+  if (_writeCycle.samples != 0U) {
+    const uint32_t boundUs = (_nowMs() - _asyncPageStartMs + 1U) * 1000U;
+    _recordWriteCycle((boundUs < _writeCycle.p90Us) ? boundUs : _writeCycle.p90Us);
+  }
+  _updateShadow(cmd::OPCODE_EEPROM, curAddr, &_asyncData[_asyncOffset], _asyncChunk, true);
+  _asyncOffset = static_cast<uint8_t>(_asyncOffset + _asyncChunk);
+  if (_asyncOffset >= _asyncLen) {
+    _asyncFinish(Status::Ok());
+    return;
+  }
+  (void)_asyncIssuePage();
+}
+
+void Driver::_asyncFinish(const Status& st) {
+  _asyncActive = false;
+  _asyncStatus = _trackIo(st);
+}
+
+Status Driver::_waitWriteCycle() {
+  return _trackIo(_waitReadyRaw(_config.writeTimeoutMs, true));
+}
+
+Status Driver::_waitReadyRaw(uint32_t timeoutMs, bool afterWrite) {
+  if (_config.presencePin >= 0 && !_presencePinReportsPresent()) {
+    return Status::Error(Err::NOT_PRESENT, "Presence pin indicates device absent");
+  }
+
+  _driverState = DriverState::BUSY;
+  const bool adaptive = afterWrite && _config.adaptiveWritePolling;
+  const uint32_t timeoutUs = timeoutMs * 1000U;
+  const uint32_t pollUs = (2U * _timing.htssNs + 9U * _timing.bitNs) / 1000U;
+  const uint32_t startMs = _nowMs();
+  uint32_t lastObservedMs = startMs;
+  uint32_t stalledPolls = 0;
+  const uint32_t maxStalledPolls = waitReadyStallGuardIterations(timeoutMs);
+
+  // Bus-time accounting since the write's Stop. It never exceeds real time, so
+  // it doubles as a stalled-clock guard and as the t_WR measurement.
+  uint32_t elapsedUs = 0;
+  uint32_t intervalUs = READY_POLL_INTERVAL_US;
+  if (adaptive) {
+    intervalUs = ADAPTIVE_POLL_MIN_US;
+    const uint32_t headUs = _writeCycleHeadUs();
+    if (headUs > 0U) {
+      elapsedUs = (headUs < timeoutUs) ? headUs : timeoutUs;
+      _yieldUs(elapsedUs);
+    }
+  }
+
+  while (true) {
+    if (_config.presencePin >= 0 && !_presencePinReportsPresent()) {
+      return Status::Error(Err::NOT_PRESENT, "Presence pin indicates device absent");
+    }
+
+    bool ack = false;
+    Status st = _addressOnlyRaw(cmd::OPCODE_EEPROM, false, ack);
+    if (!st.ok()) {
+      return st;
+    }
+    elapsedUs = saturatedAdd(elapsedUs, pollUs);
+    if (ack) {
+      if (afterWrite) {
+        _recordWriteCycle(elapsedUs);
+      }
+      return Status::Ok();
+    }
+
+    const uint32_t elapsedMs = _nowMs() - startMs;
+    if (elapsedMs >= timeoutMs || elapsedUs >= timeoutUs) {
+      return Status::Error(Err::BUSY_TIMEOUT, "Timed out waiting for write cycle completion");
+    }
+    const uint32_t observedMs = _nowMs();
+    if (observedMs == lastObservedMs) {
+      if (++stalledPolls >= maxStalledPolls) {
+        return Status::Error(Err::BUSY_TIMEOUT, "Timed out waiting for write cycle completion");
+      }
+    } else {
+      lastObservedMs = observedMs;
+      stalledPolls = 0;
+    }
+
+    _sleepUs(intervalUs);
+    elapsedUs = saturatedAdd(elapsedUs, intervalUs);
+    if (adaptive && intervalUs < ADAPTIVE_POLL_MAX_US) {
+      intervalUs *= 2U;
+    }
+  }
+}
+
+void Driver::_recordWriteCycle(uint32_t elapsedUs) {
+  WriteCycleStats& stats = _writeCycle;
+  incrementWrap(stats.samples);
+  stats.lastUs = elapsedUs;
+  if (stats.samples == 1U) {
+    stats.minUs = elapsedUs;
+    stats.maxUs = elapsedUs;
+    stats.p90Us = elapsedUs;
+    return;
+  }
+  if (elapsedUs < stats.minUs) {
+    stats.minUs = elapsedUs;
+  }
+  if (elapsedUs > stats.maxUs) {
+    stats.maxUs = elapsedUs;
+  }
+
+  // Frugal streaming quantile: up-steps nine times larger than down-steps settle
+  // where 10% of samples lie above the estimate.
+  uint32_t unit = stats.p90Us / 64U;
+  if (unit < 4U) {
+    unit = 4U;
+  }
+  if (elapsedUs > stats.p90Us) {
+    stats.p90Us = saturatedAdd(stats.p90Us, 9U * unit);
+  } else if (elapsedUs < stats.p90Us) {
+    stats.p90Us = (stats.p90Us > unit) ? (stats.p90Us - unit) : 0U;
+  }
+}
+
+uint32_t Driver::_writeCycleHeadUs() const {
+  if (!_config.adaptiveWritePolling || _writeCycle.samples == 0U) {
+    return 0;
+  }
+  // Sleep through three quarters of the expected t_WR before the first poll.
+  return _writeCycle.p90Us - (_writeCycle.p90Us / 4U);
+}
+
+bool Driver::_sessionUsable() {
+  if (!_config.persistentSession || !_sessionActive) {
+    return false;
+  }
+  if (_config.presencePin >= 0 && !_presencePinReportsPresent()) {
+    _sessionActive = false;
+    return false;
+  }
+  if (_config.sessionIdleTimeoutMs != 0U &&
+      (_nowMs() - _sessionLastMs) >= _config.sessionIdleTimeoutMs) {
+    _sessionActive = false;
+    return false;
+  }
+  return true;
+}
+
+Status Driver::_resetAndDiscoverRaw() {
+  // A reset returns the device to High-Speed standby; any held session is gone
+  // and the address pointer is no longer known.
+  _sessionActive = false;
+  _addressPointerValid = false;
+  _endTransactionMask();
+
+  driveLow(DISCHARGE_LOW_US);
+  releaseLine();
+  _sleepUs(RESET_RECOVERY_US);
+
+  _enterCritical();
+
+  _lineLow();
+  _sleepUs(DISCOVERY_REQUEST_US);
+  _releaseLine();
+
+  _sleepUs(DISCOVERY_STROBE_DELAY_US);
+
   _lineLow();
-  _sleepUs(_timing.low1Us);
+  _sleepUs(DISCOVERY_STROBE_US);
   _releaseLine();
 
-  if (_timing.bitUs > _timing.low1Us) {
-    _sleepUs(static_cast<uint32_t>(_timing.bitUs - _timing.low1Us));
+  _sleepUs(DISCOVERY_SAMPLE_DELAY_US);
+  const bool present = !_readLine();
+
+  _exitCritical();
+
+  _sleepUs(HIGH_SPEED_TIMING.htssNs / 1000U);
+
+  if (!present) {
+    return Status::Error(Err::DISCOVERY_FAILED, "Discovery response not detected");
+  }
+
+  _setSpeedMode(SpeedMode::HIGH_SPEED);
+  return Status::Ok();
+}
+
+Status Driver::_addressOnlyRaw(uint8_t opcode, bool read, bool& ack) {
+  _sendStart();
+  ack = txByte(_deviceAddress(opcode, read));
+  _sendStop();
+  return Status::Ok();
+}
+
+Status Driver::_readRandomRaw(uint8_t opcode, uint8_t address, uint8_t* data, size_t len,
+                              ByteSinkFn sink, void* user) {
+  _addressPointerValid = false;
+  _sendStart();
+  if (!txByte(_deviceAddress(opcode, false))) {
+    _sendStop();
+    return Status::Error(Err::NACK_DEVICE_ADDRESS, "Device address NACK");
+  }
+
+  if (!txByte(address)) {
+    _sendStop();
+    return Status::Error(Err::NACK_MEMORY_ADDRESS, "Memory address NACK");
+  }
+
+  _sendStart();
+  if (!txByte(_deviceAddress(opcode, true))) {
+    _sendStop();
+    return Status::Error(Err::NACK_DEVICE_ADDRESS, "Device address NACK");
+  }
+
+  _rxBytes(data, len, sink, user);
+
+  _sendStop();
+  _trackAddressPointer(opcode, static_cast<uint8_t>((address + len) % cmd::EEPROM_SIZE));
+  return Status::Ok();
+}
+
+Status Driver::_writeRaw(uint8_t opcode, uint8_t address, const uint8_t* data, size_t len) {
+  _addressPointerValid = false;
+  _sendStart();
+  if (!txByte(_deviceAddress(opcode, false))) {
+    _sendStop();
+    return Status::Error(Err::NACK_DEVICE_ADDRESS, "Device address NACK");
+  }
+
+  if (!txByte(address)) {
+    _sendStop();
+    return Status::Error(Err::NACK_MEMORY_ADDRESS, "Memory address NACK");
+  }
+
+  for (size_t i = 0; i < len; ++i) {
+    if (!txByte(data[i])) {
+      _sendStop();
+      return Status::Error(Err::NACK_DATA, "Data byte NACK", static_cast<int32_t>(i));
+    }
+  }
+
+  _sendStop();
+  // Page writes roll the pointer over within the addressed page.
+  const uint8_t pageBase = static_cast<uint8_t>(address - (address % cmd::PAGE_SIZE));
+  const uint8_t pageNext = static_cast<uint8_t>((address % cmd::PAGE_SIZE + len) % cmd::PAGE_SIZE);
+  _trackAddressPointer(opcode, static_cast<uint8_t>(pageBase + pageNext));
+  return Status::Ok();
+}
+
+// Write, ACK-poll, and read back each page with no reset in between.
+Status Driver::_writeVerifiedRaw(uint8_t opcode, uint8_t address, const uint8_t* data,
+                                 size_t len) {
+  size_t offset = 0;
+  while (offset < len) {
+    const uint8_t curAddr = static_cast<uint8_t>(address + offset);
+    const uint8_t pageOffset = curAddr % cmd::PAGE_SIZE;
+    size_t chunk = cmd::PAGE_SIZE - pageOffset;
+    if (chunk > len - offset) {
+      chunk = len - offset;
+    }
+
+    uint8_t readBack[cmd::PAGE_SIZE];
+    Status st = _writeRaw(opcode, curAddr, data + offset, chunk);
+    if (st.ok()) {
+      st = _waitReadyRaw(_config.writeTimeoutMs, true);
+    }
+    if (st.ok()) {
+      st = _readRandomRaw(opcode, curAddr, readBack, chunk);
+    }
+    if (!st.ok()) {
+      _updateShadow(opcode, curAddr, data + offset, chunk, false);
+      return st;
+    }
+
+    for (size_t i = 0; i < chunk; ++i) {
+      if (readBack[i] != data[offset + i]) {
+        _updateShadow(opcode, curAddr, data + offset, chunk, false);
+        return Status::Error(Err::VERIFY_FAILED, "Read-back differs from written data",
+                             static_cast<int32_t>(offset + i));
+      }
+    }
+    _updateShadow(opcode, curAddr, data + offset, chunk, true);
+    offset += chunk;
+  }
+  return Status::Ok();
+}
+
+// The bus exchange completed, so a read-back mismatch is not a health failure.
+Status Driver::_trackVerified(const Status& st) {
+  if (st.code == Err::VERIFY_FAILED) {
+    (void)_trackIo(Status::Ok());
+    return st;
+  }
+  return _trackIo(st);
+}
+
+Status Driver::_readManufacturerIdRaw(uint32_t& manufacturerId) {
+  _addressPointerValid = false;
+  _sendStart();
+  if (!txByte(_deviceAddress(cmd::OPCODE_MANUFACTURER_ID, true))) {
+    _sendStop();
+    return Status::Error(Err::NACK_DEVICE_ADDRESS, "Manufacturer ID command NACK");
+  }
+
+  const uint8_t b0 = rxByte(true);
+  const uint8_t b1 = rxByte(true);
+  const uint8_t b2 = rxByte(false);
+
+  _sendStop();
+
+  manufacturerId =
+      (static_cast<uint32_t>(b0) << 16U) |
+      (static_cast<uint32_t>(b1) << 8U) |
+      static_cast<uint32_t>(b2);
+
+  return Status::Ok();
+}
+
+Status Driver::_readCurrentAddressRaw(uint8_t* data, size_t len, ByteSinkFn sink, void* user) {
+  const bool pointerKnown = _addressPointerValid;
+  _addressPointerValid = false;
+  _sendStart();
+  if (!txByte(_deviceAddress(cmd::OPCODE_EEPROM, true))) {
+    _sendStop();
+    return Status::Error(Err::NACK_DEVICE_ADDRESS, "Current address read NACK");
+  }
+
+  _rxBytes(data, len, sink, user);
+  _sendStop();
+
+  if (pointerKnown) {
+    _trackAddressPointer(cmd::OPCODE_EEPROM,
+                         static_cast<uint8_t>((_addressPointer + len) % cmd::EEPROM_SIZE));
+  }
+  return Status::Ok();
+}
+
+Status Driver::_readEepromRaw(uint8_t address, uint8_t* data, size_t len, ByteSinkFn sink,
+                              void* user) {
+  // A tracked pointer already at the start address turns the random read into a
+  // current-address read: no dummy write, word address, or repeated Start.
+  if (_addressPointerValid && _addressPointer == address) {
+    return _readCurrentAddressRaw(data, len, sink, user);
+  }
+  return _readRandomRaw(cmd::OPCODE_EEPROM, address, data, len, sink, user);
+}
+
+// Receive len bytes (ACK all but the last) into data and/or a sink. The sink
+// runs in the idle gap after each byte, before the next bit slot starts.
+void Driver::_rxBytes(uint8_t* data, size_t len, ByteSinkFn sink, void* user) {
+  for (size_t i = 0; i < len; ++i) {
+    const bool ack = (i + 1U) < len;
+    const uint8_t value = rxByte(ack);
+    if (data != nullptr) {
+      data[i] = value;
+    }
+    if (sink != nullptr) {
+      sink(value, i, user);
+    }
+  }
+}
+
+Status Driver::_readShadowed(uint8_t opcode, uint8_t address, uint8_t* data, size_t len) {
+  const bool eeprom = (opcode == cmd::OPCODE_EEPROM);
+  uint8_t* shadow = eeprom ? _shadowEeprom : _shadowSecurity;
+  const uint16_t valid = eeprom ? _shadowEepromValid : _shadowSecurityValid;
+  const uint16_t wanted = pageSpanMask(address, len);
+
+  if ((valid & wanted) != wanted) {
+    Status st = _activateDevice();
+    if (st.ok()) {
+      st = _fillShadowRaw(opcode, address, len);
+    }
+    if (!st.ok()) {
+      return _trackIo(st);
+    }
+    std::memcpy(data, &shadow[address], len);
+    return _trackIo(Status::Ok());
+  }
+
+  std::memcpy(data, &shadow[address], len);
+  return Status::Ok();
+}
+
+Status Driver::_fillShadowRaw(uint8_t opcode, uint8_t address, size_t len) {
+  const bool eeprom = (opcode == cmd::OPCODE_EEPROM);
+  uint8_t* shadow = eeprom ? _shadowEeprom : _shadowSecurity;
+
+  // Fill whole pages so the next access to any byte of them is a hit.
+  const uint8_t first = static_cast<uint8_t>(address - (address % cmd::PAGE_SIZE));
+  const size_t end = static_cast<size_t>(address) + len;
+  const size_t span = ((end + cmd::PAGE_SIZE - 1U) / cmd::PAGE_SIZE) * cmd::PAGE_SIZE - first;
+  Status st = eeprom ? _readEepromRaw(first, &shadow[first], span)
+                     : _readRandomRaw(opcode, first, &shadow[first], span);
+  if (!st.ok()) {
+    return st;
+  }
+
+  const uint16_t wanted = pageSpanMask(address, len);
+  if (eeprom) {
+    _shadowEepromValid = static_cast<uint16_t>(_shadowEepromValid | wanted);
+  } else {
+    _shadowSecurityValid = static_cast<uint8_t>(_shadowSecurityValid | wanted);
+  }
+  return Status::Ok();
+}
+
+Status Driver::_validateBatchOp(const Batch& batch, uint8_t index) {
+  const Batch::Op& op = batch._ops[index];
+  switch (op.type) {
+    case Batch::OpType::READ_EEPROM:
+      if (op.in == nullptr || !rangeFits(op.address, op.len, cmd::EEPROM_SIZE)) {
+        return Status::Error(Err::INVALID_PARAM, "Batch EEPROM read is invalid", index);
+      }
+      return Status::Ok();
+    case Batch::OpType::READ_SECURITY:
+      if (op.in == nullptr || !rangeFits(op.address, op.len, cmd::SECURITY_SIZE)) {
+        return Status::Error(Err::INVALID_PARAM, "Batch Security read is invalid", index);
+      }
+      return Status::Ok();
+    case Batch::OpType::WRITE_EEPROM_PAGE:
+      if (op.out == nullptr || !rangeFits(op.address, op.len, cmd::EEPROM_SIZE) ||
+          !staysWithinPage(op.address, op.len, cmd::PAGE_SIZE)) {
+        return Status::Error(Err::INVALID_PARAM, "Batch EEPROM page write is invalid", index);
+      }
+      return Status::Ok();
+    case Batch::OpType::WRITE_SECURITY_PAGE:
+      if (op.out == nullptr || !_isSecurityUserAddressValid(op.address) ||
+          !rangeFits(op.address, op.len, cmd::SECURITY_SIZE) ||
+          !staysWithinPage(op.address, op.len, cmd::PAGE_SIZE)) {
+        return Status::Error(Err::INVALID_PARAM, "Batch Security page write is invalid", index);
+      }
+      return Status::Ok();
+    case Batch::OpType::WAIT_READY:
+      if (op.timeoutMs == 0U || op.timeoutMs > MAX_READY_TIMEOUT_MS) {
+        return Status::Error(Err::INVALID_PARAM, "Batch waitReady timeout must be 1..250", index);
+      }
+      return Status::Ok();
+    case Batch::OpType::READ_MANUFACTURER_ID:
+    case Batch::OpType::READ_SERIAL_NUMBER:
+      return Status::Ok();
+  }
+  return Status::Error(Err::INVALID_PARAM, "Unknown batch operation", index);
+}
+
+Status Driver::_runBatchOp(Batch& batch, uint8_t index, bool& active, bool& usedBus) {
+  const Batch::Op& op = batch._ops[index];
+  Status& result = batch._status[index];
+
+  // Reads fully served by the shadow need no activation.
+  const bool read = op.type == Batch::OpType::READ_EEPROM ||
+                    op.type == Batch::OpType::READ_SECURITY ||
+                    op.type == Batch::OpType::READ_SERIAL_NUMBER;
+  const bool eeprom = op.type == Batch::OpType::READ_EEPROM;
+  const uint8_t readOpcode = eeprom ? cmd::OPCODE_EEPROM : cmd::OPCODE_SECURITY;
+  uint8_t* readData = (op.type == Batch::OpType::READ_SERIAL_NUMBER) ? op.serial->bytes : op.in;
+  const uint8_t readAddress =
+      (op.type == Batch::OpType::READ_SERIAL_NUMBER) ? cmd::SECURITY_SERIAL_START : op.address;
+  const size_t readLen =
+      (op.type == Batch::OpType::READ_SERIAL_NUMBER) ? cmd::SECURITY_SERIAL_SIZE : op.len;
+  bool shadowHit = false;
+  if (read && _config.shadowCache) {
+    const uint16_t valid = eeprom ? _shadowEepromValid : _shadowSecurityValid;
+    const uint16_t wanted = pageSpanMask(readAddress, readLen);
+    shadowHit = (valid & wanted) == wanted;
+  }
+
+  // Cached identity reads need no bus I/O either.
+  if (op.type == Batch::OpType::READ_MANUFACTURER_ID && _manufacturerIdCached) {
+    usedBus = false;
+    *op.id = _cachedManufacturerId;
+    result = Status::Ok();
+    return result;
+  }
+  if (op.type == Batch::OpType::READ_SERIAL_NUMBER && _serialCached) {
+    usedBus = false;
+    std::memcpy(op.serial->bytes, _cachedSerial, sizeof(_cachedSerial));
+    result = _checkSerialNumber(*op.serial);
+    return Status::Ok();
+  }
+
+  usedBus = !shadowHit;
+  Status st = Status::Ok();
+  if (!active && !shadowHit && op.type != Batch::OpType::WAIT_READY) {
+    st = _activateDevice();
+    if (!st.ok()) {
+      result = st;
+      return st;
+    }
+    active = true;
+  }
+
+  switch (op.type) {
+    case Batch::OpType::READ_EEPROM:
+    case Batch::OpType::READ_SECURITY:
+    case Batch::OpType::READ_SERIAL_NUMBER:
+      if (_config.shadowCache) {
+        if (!shadowHit) {
+          st = _fillShadowRaw(readOpcode, readAddress, readLen);
+        }
+        if (st.ok()) {
+          std::memcpy(readData, eeprom ? &_shadowEeprom[readAddress] : &_shadowSecurity[readAddress],
+                      readLen);
+        }
+      } else if (eeprom) {
+        st = _readEepromRaw(readAddress, readData, readLen);
+      } else {
+        st = _readRandomRaw(readOpcode, readAddress, readData, readLen);
+      }
+      result = st;
+      if (st.ok() && op.type == Batch::OpType::READ_SERIAL_NUMBER) {
+        // Validation failures are reported per operation but are not bus faults.
+        result = _checkSerialNumber(*op.serial);
+        _cacheSerial(*op.serial);
+      }
+      return st;
+    case Batch::OpType::WRITE_EEPROM_PAGE:
+    case Batch::OpType::WRITE_SECURITY_PAGE: {
+      const uint8_t opcode = (op.type == Batch::OpType::WRITE_EEPROM_PAGE) ? cmd::OPCODE_EEPROM
+                                                                             : cmd::OPCODE_SECURITY;
+      if (opcode == cmd::OPCODE_EEPROM && _config.romZoneGuard) {
+        if (!_romZoneMaskValid) {
+          st = _readRomZoneMaskRaw();
+          if (!st.ok()) {
+            result = st;
+            return st;
+          }
+        }
+        const int8_t zone = _protectedZone(op.address, op.len);
+        if (zone >= 0) {
+          // Rejected without touching the device; not a bus fault.
+          result = Status::Error(Err::WRITE_PROTECTED, "EEPROM write targets a ROM zone", zone);
+          return Status::Ok();
+        }
+      }
+      st = _writeRaw(opcode, op.address, op.out, op.len);
+      if (st.ok()) {
+        st = _waitReadyRaw(_config.writeTimeoutMs, true);
+      }
+      _updateShadow(opcode, op.address, op.out, op.len, st.ok());
+      result = st;
+      return st;
+    }
+    case Batch::OpType::WAIT_READY:
+      st = _waitReadyRaw(op.timeoutMs, false);
+      result = st;
+      return st;
+    case Batch::OpType::READ_MANUFACTURER_ID:
+      st = _readManufacturerIdRaw(*op.id);
+      result = st;
+      return st;
+  }
+  result = Status::Error(Err::INVALID_PARAM, "Unknown batch operation", index);
+  return result;
+}
+
+Status Driver::_checkSerialNumber(SerialNumberInfo& serial) {
+  serial.productIdOk = (serial.bytes[0] == cmd::SECURITY_PRODUCT_ID);
+  const uint8_t crc = crc8_31(serial.bytes, cmd::SECURITY_SERIAL_SIZE - 1U);
+  serial.crcOk = (crc == serial.bytes[cmd::SECURITY_SERIAL_SIZE - 1U]);
+
+  if (!serial.productIdOk) {
+    return Status::Error(Err::PART_MISMATCH, "Serial product ID is not 0xA0");
+  }
+  if (!serial.crcOk) {
+    return Status::Error(Err::CRC_MISMATCH, "Serial number CRC check failed");
+  }
+  return Status::Ok();
+}
+
+void Driver::_cacheManufacturerId(uint32_t manufacturerId) {
+  if (!_config.identityCache) {
+    return;
+  }
+  _cachedManufacturerId = manufacturerId;
+  _manufacturerIdCached = true;
+}
+
+void Driver::_cacheSerial(const SerialNumberInfo& serial) {
+  if (!_config.identityCache || !serial.productIdOk || !serial.crcOk) {
+    return;
+  }
+  std::memcpy(_cachedSerial, serial.bytes, sizeof(_cachedSerial));
+  _serialCached = true;
+}
+
+// After re-discovery: keep the cache only when the same device answers. The
+// serial is re-read when one was cached, since a swapped module of the same
+// part type reports the same manufacturer ID.
+Status Driver::_revalidateIdentityCache(uint32_t manufacturerId) {
+  if (!_config.identityCache) {
+    return Status::Ok();
+  }
+  if (_manufacturerIdCached && _cachedManufacturerId != manufacturerId) {
+    invalidateIdentityCache();
+  }
+  if (_serialCached) {
+    uint8_t serial[cmd::SECURITY_SERIAL_SIZE];
+    const Status st =
+        _readRandomRaw(cmd::OPCODE_SECURITY, cmd::SECURITY_SERIAL_START, serial, sizeof(serial));
+    if (!st.ok()) {
+      invalidateIdentityCache();
+      return st;
+    }
+    if (std::memcmp(serial, _cachedSerial, sizeof(serial)) != 0) {
+      invalidateIdentityCache();
+    }
   }
+  _cacheManufacturerId(manufacturerId);
+  return Status::Ok();
 }
 
-AT21CS_IRAM bool Driver::rxBit() {
-  _lineLow();
-  _sleepUs(_timing.readLowUs);
-  _releaseLine();
-
-  if (_timing.readSampleUs > 0) {
-    _sleepUs(_timing.readSampleUs);
+Status Driver::_readRomZoneMaskRaw() {
+  uint8_t mask = 0;
+  for (uint8_t zone = 0; zone < cmd::ROM_ZONE_REGISTER_COUNT; ++zone) {
+    uint8_t value = 0;
+    const Status st =
+        _readRandomRaw(cmd::OPCODE_ROM_ZONE, cmd::ROM_ZONE_REGISTERS[zone], &value, 1);
+    if (!st.ok()) {
+      return st;
+    }
+    if (value == cmd::ROM_ZONE_ROM_VALUE) {
+      mask = static_cast<uint8_t>(mask | (1U << zone));
+    }
   }
+  _romZoneMask = mask;
+  _romZoneMaskValid = true;
+  return Status::Ok();
+}
 
-  const bool bit = _readLine();
-  const uint16_t elapsed = static_cast<uint16_t>(_timing.readLowUs + _timing.readSampleUs);
-  if (_timing.bitUs > elapsed) {
-    _sleepUs(static_cast<uint32_t>(_timing.bitUs - elapsed));
+int8_t Driver::_protectedZone(uint8_t address, size_t len) const {
+  const size_t first = address / cmd::ROM_ZONE_SIZE;
+  const size_t last = (static_cast<size_t>(address) + len - 1U) / cmd::ROM_ZONE_SIZE;
+  for (size_t zone = first; zone <= last; ++zone) {
+    if ((_romZoneMask & (1U << zone)) != 0U) {
+      return static_cast<int8_t>(zone);
+    }
   }
-
-  return bit;
+  return -1;
 }
 
-AT21CS_IRAM bool Driver::txByte(uint8_t value) {
-#if defined(ARDUINO_ARCH_ESP32)
-  portENTER_CRITICAL(&_timingMux);
-#endif
-
-  for (int8_t bit = 7; bit >= 0; --bit) {
-    const bool one = ((value >> bit) & 0x01U) != 0U;
-    if (one) {
-      txBit1();
-    } else {
-      txBit0();
+// Reject EEPROM writes into ROM zones before any write traffic. The first
+// guarded write after begin()/recover() loads the zone registers.
+Status Driver::_guardRomZones(uint8_t address, size_t len) {
+  if (!_config.romZoneGuard) {
+    return Status::Ok();
+  }
+  if (!_romZoneMaskValid) {
+    Status st = _activateDevice();
+    if (st.ok()) {
+      st = _readRomZoneMaskRaw();
+    }
+    if (!st.ok()) {
+      return _trackIo(st);
     }
   }
-
-  const bool ack = !rxBit();
-
-#if defined(ARDUINO_ARCH_ESP32)
-  portEXIT_CRITICAL(&_timingMux);
-#endif
-
-  return ack;
+  const int8_t zone = _protectedZone(address, len);
+  if (zone >= 0) {
+    return Status::Error(Err::WRITE_PROTECTED, "EEPROM write targets a ROM zone", zone);
+  }
+  return Status::Ok();
 }
 
-AT21CS_IRAM uint8_t Driver::rxByte(bool ack) {
-#if defined(ARDUINO_ARCH_ESP32)
-  portENTER_CRITICAL(&_timingMux);
-#endif
+void Driver::_updateShadow(uint8_t opcode, uint8_t address, const uint8_t* data, size_t len,
+                           bool ok) {
+  if (!_config.shadowCache) {
+    return;
+  }
+  const bool eeprom = (opcode == cmd::OPCODE_EEPROM);
+  uint8_t* shadow = eeprom ? _shadowEeprom : _shadowSecurity;
+  uint16_t valid = eeprom ? _shadowEepromValid : _shadowSecurityValid;
+  const uint16_t page = pageSpanMask(address, len);
 
-  uint8_t value = 0;
-  for (int8_t bit = 7; bit >= 0; --bit) {
-    if (rxBit()) {
-      value = static_cast<uint8_t>(value | static_cast<uint8_t>(1U << bit));
+  if (!ok) {
+    // The write may or may not have landed; reread the page next time.
+    valid = static_cast<uint16_t>(valid & ~page);
+  } else {
+    std::memcpy(&shadow[address], data, len);
+    if (len == cmd::PAGE_SIZE) {
+      valid = static_cast<uint16_t>(valid | page);
     }
   }
 
-  if (ack) {
-    txBit0();
+  if (eeprom) {
+    _shadowEepromValid = valid;
   } else {
-    txBit1();
+    _shadowSecurityValid = static_cast<uint8_t>(valid);
   }
+}
 
-#if defined(ARDUINO_ARCH_ESP32)
-  portEXIT_CRITICAL(&_timingMux);
-#endif
+void Driver::_trackAddressPointer(uint8_t opcode, uint8_t next) {
+  // Security, ROM-zone, and lock accesses share the pointer but leave it in a
+  // region the EEPROM current-address read cannot use.
+  _addressPointerValid = (opcode == cmd::OPCODE_EEPROM);
+  _addressPointer = next;
+}
 
-  return value;
+bool Driver::_isZoneIndexValid(uint8_t zoneIndex) {
+  return zoneIndex < cmd::ROM_ZONE_REGISTER_COUNT;
 }
 
-AT21CS_IRAM void Driver::_sendStart() {
-  _releaseLine();
-  _sleepUs(_timing.htssUs);
+bool Driver::_isSecurityUserAddressValid(uint8_t address) {
+  return address >= cmd::SECURITY_USER_MIN && address <= cmd::SECURITY_USER_MAX;
 }
 
-AT21CS_IRAM void Driver::_sendStop() {
-  _releaseLine();
-  _sleepUs(_timing.htssUs);
+void Driver::_setSpeedMode(SpeedMode mode) {
+  _speedMode = mode;
+  _timing = _profileFor(mode);
+  _updateSegments();
 }
 
-uint8_t Driver::_deviceAddress(uint8_t opcode, bool read) const {
-  const uint8_t rw = read ? 0x01U : 0x00U;
-  return static_cast<uint8_t>((opcode << 4U) | ((_config.addressBits & 0x07U) << 1U) | rw);
+const TimingProfile& Driver::_profileFor(SpeedMode mode) const {
+  return (mode == SpeedMode::STANDARD_SPEED) ? _config.standardSpeedTiming
+                                             : _config.highSpeedTiming;
 }
 
-Status Driver::_activateDevice() {
-  const SpeedMode desiredSpeed = _speedMode;
-  Status st = Status::Error(Err::DISCOVERY_FAILED, "Discovery failed");
-  const uint16_t attempts = retryAttempts(_config.discoveryRetries);
-  for (uint16_t attempt = 0; attempt < attempts; ++attempt) {
-    st = _resetAndDiscoverRaw();
-    if (st.ok()) {
-      break;
+Status Driver::_timingTrial(const TimingProfile& candidate, const uint8_t* reference,
+                            uint8_t trials, bool& passed) {
+  passed = true;
+  for (uint8_t trial = 0; trial < trials && passed; ++trial) {
+    // Activate with the configured profile so a failed candidate can never
+    // leave the device out of step for the next one.
+    _sessionActive = false;
+    const Status st = _activateDevice();
+    if (!st.ok()) {
+      return st;
     }
-  }
-  if (!st.ok()) {
-    return st;
-  }
 
-  if (desiredSpeed == SpeedMode::STANDARD_SPEED) {
-    if (_detectedPart == PartType::AT21CS11) {
-      return Status::Error(Err::UNSUPPORTED_COMMAND, "AT21CS11 does not support Standard Speed");
+    uint8_t pattern[TIMING_SCAN_PATTERN_BYTES] = {};
+    _timing = candidate;
+    _updateSegments();
+    Status rd = _readRandomRaw(cmd::OPCODE_SECURITY, 0, pattern, cmd::SECURITY_SERIAL_SIZE);
+    if (rd.ok()) {
+      rd = _readRandomRaw(cmd::OPCODE_EEPROM, 0, pattern + cmd::SECURITY_SERIAL_SIZE,
+                          TIMING_SCAN_EEPROM_BYTES);
     }
+    _setSpeedMode(_speedMode);
+    passed = rd.ok() && std::memcmp(pattern, reference, sizeof(pattern)) == 0;
+  }
+  return Status::Ok();
+}
 
-    bool ack = false;
-    st = _addressOnlyRaw(cmd::OPCODE_STANDARD_SPEED, false, ack);
+Status Driver::_scanTimingWindow(uint32_t TimingProfile::*field, uint32_t fromNs, uint32_t toNs,
+                                 const TimingScanConfig& scan, const uint8_t* reference,
+                                 TimingWindow& window, uint32_t& candidates) {
+  // Step outward from the active value, which already reproduced the reference.
+  TimingProfile candidate = _timing;
+  const uint32_t start = candidate.*field;
+  window.minNs = start;
+  window.maxNs = start;
+
+  bool passed = true;
+  for (uint32_t value = start; passed && value >= fromNs + scan.stepNs;) {
+    value -= scan.stepNs;
+    candidate.*field = value;
+    ++candidates;
+    const Status st = _timingTrial(candidate, reference, scan.trials, passed);
     if (!st.ok()) {
       return st;
     }
-    if (!ack) {
-      return Status::Error(Err::NACK_DEVICE_ADDRESS, "Standard Speed command NACK during activation");
+    if (passed) {
+      window.minNs = value;
     }
-    _setSpeedMode(SpeedMode::STANDARD_SPEED);
   }
 
+  passed = true;
+  for (uint32_t value = start + scan.stepNs; passed && value <= toNs; value += scan.stepNs) {
+    candidate.*field = value;
+    ++candidates;
+    const Status st = _timingTrial(candidate, reference, scan.trials, passed);
+    if (!st.ok()) {
+      return st;
+    }
+    if (passed) {
+      window.maxNs = value;
+    }
+  }
   return Status::Ok();
 }
 
-Status Driver::_resetAndDiscoverRaw() {
-  driveLow(DISCHARGE_LOW_US);
-  releaseLine();
-  _sleepUs(RESET_RECOVERY_US);
+void Driver::_updateSegments() {
+  // The microsecond table reproduces the integer profile exactly, so sleep
+  // hooks and the simulator see the same slot lengths at any resolution.
+  const uint32_t bitUs = _timing.bitNs / 1000U;
+  const uint32_t low0Us = _timing.low0Ns / 1000U;
+  const uint32_t low1Us = _timing.low1Ns / 1000U;
+  const uint32_t readLowUs = _timing.readLowNs / 1000U;
+  const uint32_t readSampleUs = _timing.readSampleNs / 1000U;
+  _segmentUs[SEG_LOW0] = low0Us;
+  _segmentUs[SEG_HIGH0] = (bitUs > low0Us) ? bitUs - low0Us : 0U;
+  _segmentUs[SEG_LOW1] = low1Us;
+  _segmentUs[SEG_HIGH1] = (bitUs > low1Us) ? bitUs - low1Us : 0U;
+  _segmentUs[SEG_READ_LOW] = readLowUs;
+  _segmentUs[SEG_READ_SAMPLE] = readSampleUs;
+  _segmentUs[SEG_READ_REST] =
+      (bitUs > readLowUs + readSampleUs) ? bitUs - readLowUs - readSampleUs : 0U;
+  _segmentUs[SEG_HTSS] = _timing.htssNs / 1000U;
 
 #if defined(ARDUINO_ARCH_ESP32)
-  portENTER_CRITICAL(&_timingMux);
+  const uint32_t readNs = _timing.readLowNs + _timing.readSampleNs;
+  uint32_t segmentNs[SEG_COUNT] = {};
+  segmentNs[SEG_LOW0] = _timing.low0Ns;
+  segmentNs[SEG_HIGH0] = (_timing.bitNs > _timing.low0Ns) ? _timing.bitNs - _timing.low0Ns : 0U;
+  segmentNs[SEG_LOW1] = _timing.low1Ns;
+  segmentNs[SEG_HIGH1] = (_timing.bitNs > _timing.low1Ns) ? _timing.bitNs - _timing.low1Ns : 0U;
+  segmentNs[SEG_READ_LOW] = _timing.readLowNs;
+  segmentNs[SEG_READ_SAMPLE] = _timing.readSampleNs;
+  segmentNs[SEG_READ_REST] = (_timing.bitNs > readNs) ? _timing.bitNs - readNs : 0U;
+  segmentNs[SEG_HTSS] = _timing.htssNs;
+  for (uint8_t i = 0; i < SEG_COUNT; ++i) {
+    const uint32_t cycles =
+        static_cast<uint32_t>((static_cast<uint64_t>(segmentNs[i]) * _cyclesPerUs) / 1000U);
+    _segmentCycles[i] = (cycles > _edgeOverheadCycles) ? cycles - _edgeOverheadCycles : 0U;
+  }
 #endif
+}
 
-  _lineLow();
-  _sleepUs(DISCOVERY_REQUEST_US);
-  _releaseLine();
-
-  _sleepUs(DISCOVERY_STROBE_DELAY_US);
-
-  _lineLow();
-  _sleepUs(DISCOVERY_STROBE_US);
-  _releaseLine();
-
-  _sleepUs(DISCOVERY_SAMPLE_DELAY_US);
-  const bool present = !_readLine();
-
+AT21CS_IRAM void Driver::_waitSegment(BitSegment segment) const {
 #if defined(ARDUINO_ARCH_ESP32)
-  portEXIT_CRITICAL(&_timingMux);
+  if (_cycleTimed) {
+    const uint32_t target = _segmentCycles[segment];
+    const uint32_t start = esp_cpu_get_cycle_count();
+    while ((esp_cpu_get_cycle_count() - start) < target) {}
+    return;
+  }
 #endif
+  _sleepUs(_segmentUs[segment]);
+}
 
-  _sleepUs(HIGH_SPEED_TIMING.htssUs);
-
-  if (!present) {
-    return Status::Error(Err::DISCOVERY_FAILED, "Discovery response not detected");
+Status Driver::_checkWaveform(const Waveform& wave) const {
+  if (wave._tickNs == 0U || wave._count == 0U) {
+    return Status::Error(Err::INVALID_PARAM, "Waveform is empty");
+  }
+  if (wave._overflow) {
+    return Status::Error(Err::INVALID_PARAM, "Waveform overflowed its buffer");
+  }
+  if (wave._speedCommand) {
+    return Status::Error(Err::INVALID_PARAM,
+                         "Waveform changes speed mode; use setHighSpeed()/setStandardSpeed()");
+  }
+  if (wave._mode != _speedMode || !sameProfile(wave._timing, _timing)) {
+    return Status::Error(Err::INVALID_STATE, "Waveform encoded for another speed or profile");
+  }
+  if (wave._writes && _config.romZoneGuard) {
+    return Status::Error(Err::WRITE_PROTECTED, "Waveform writes bypass the ROM-zone guard");
   }
-
-  _setSpeedMode(SpeedMode::HIGH_SPEED);
   return Status::Ok();
 }
 
-Status Driver::_addressOnlyRaw(uint8_t opcode, bool read, bool& ack) {
-  _sendStart();
-  ack = txByte(_deviceAddress(opcode, read));
-  _sendStop();
-  return Status::Ok();
+void Driver::_prepareWaveform(Waveform& wave) {
+  _addressPointerValid = false;
+  if (wave._writes) {
+    invalidateShadowCache();
+    invalidateIdentityCache();
+    _romZoneMaskValid = false;
+  }
+  std::memset(wave._samples, 0, sizeof(wave._samples));
+#if defined(ARDUINO_ARCH_ESP32)
+  // Q8 cycles per tick: one multiply and shift per symbol.
+  _waveCyclesPerTickQ8 = (wave._tickNs * _cyclesPerUs * 256U) / 1000U;
+#endif
 }
 
-Status Driver::_readRandomRaw(uint8_t opcode, uint8_t address, uint8_t* data, size_t len) {
-  _sendStart();
-  if (!txByte(_deviceAddress(opcode, false))) {
-    _sendStop();
-    return Status::Error(Err::NACK_DEVICE_ADDRESS, "Device address NACK");
+AT21CS_IRAM void Driver::_replayWaveform(Waveform& wave) {
+  size_t sample = 0;
+  bool low = false;
+  bool masked = false;
+  for (size_t i = 0; i < wave._count; ++i) {
+    const WaveSymbol symbol = wave._symbols[i];
+    // A bit slot runs from its falling edge to the end of its trailing high.
+    if (!symbol.high() && !masked) {
+      _enterCritical();
+      masked = true;
+    }
+    low = _waveEdge(symbol.high(), low);
+    _waitTicks(symbol.ticks(), wave._tickNs);
+
+    if (symbol.sample()) {
+      _storeWaveSample(wave, sample++);
+    } else if (symbol.high() && masked) {
+      _exitCritical();
+      masked = false;
+    }
   }
-
-  if (!txByte(address)) {
-    _sendStop();
-    return Status::Error(Err::NACK_MEMORY_ADDRESS, "Memory address NACK");
+  if (low) {
+    _releaseLine();
   }
+  if (masked) {
+    _exitCritical();
+  }
+}
+
+// Runs symbols from _phyIndex until one is long enough for an alarm. Short
+// segments are spun with interrupts masked, and the edge that starts the long
+// segment is driven and its alarm armed before the mask is dropped, so
+// preemption cannot stretch a t_LOW1 or move a sample point.
+AT21CS_IRAM void Driver::_phyRun() {
+  Waveform& wave = *_phyWave;
+  _enterCritical();
+  while (_phyIndex < wave._count) {
+    const WaveSymbol symbol = wave._symbols[_phyIndex];
+    _phyLow = _waveEdge(symbol.high(), _phyLow);
+    const uint32_t us = (symbol.ticks() * wave._tickNs) / 1000U;
+    if (us >= _config.timerMinUs) {
+      if (_config.alarmStart != nullptr) {
+        _config.alarmStart(us, _config.alarmUser);
+      }
+#if AT21CS_HAS_GPTIMER
+      else {
+        gptimer_handle_t timer = static_cast<gptimer_handle_t>(_phyTimer);
+        uint64_t now = 0;
+        (void)gptimer_get_raw_count(timer, &now);
+        gptimer_alarm_config_t alarm = {};
+        alarm.alarm_count = now + us;
+        (void)gptimer_set_alarm_action(timer, &alarm);
+      }
+#endif
+      _exitCritical();
+      return;
+    }
 
-  _sendStart();
-  if (!txByte(_deviceAddress(opcode, true))) {
-    _sendStop();
-    return Status::Error(Err::NACK_DEVICE_ADDRESS, "Device address NACK");
+    _waitTicks(symbol.ticks(), wave._tickNs);
+    if (symbol.sample()) {
+      _storeWaveSample(wave, _phySample++);
+    }
+    ++_phyIndex;
   }
 
-  for (size_t i = 0; i < len; ++i) {
-    const bool ack = (i + 1U) < len;
-    data[i] = rxByte(ack);
+  if (_phyLow) {
+    _releaseLine();
+    _phyLow = false;
   }
+  // Cleared inside the mux: _phyFinished() then sees the stored samples too.
+  _phyActive = false;
+  _exitCritical();
+}
 
-  _sendStop();
-  return Status::Ok();
+bool Driver::_phyFinished() const {
+#if defined(ARDUINO_ARCH_ESP32)
+  portENTER_CRITICAL(&_timingMux);
+  const bool finished = !_phyActive;
+  portEXIT_CRITICAL(&_timingMux);
+  return finished;
+#else
+  return !_phyActive;
+#endif
 }
 
-Status Driver::_writeRaw(uint8_t opcode, uint8_t address, const uint8_t* data, size_t len) {
-  _sendStart();
-  if (!txByte(_deviceAddress(opcode, false))) {
-    _sendStop();
-    return Status::Error(Err::NACK_DEVICE_ADDRESS, "Device address NACK");
+// Drives the line only when the level changes; returns the new low state.
+AT21CS_IRAM bool Driver::_waveEdge(bool high, bool low) {
+  if (!high && !low) {
+    _lineLow();
+    return true;
   }
-
-  if (!txByte(address)) {
-    _sendStop();
-    return Status::Error(Err::NACK_MEMORY_ADDRESS, "Memory address NACK");
+  if (high && low) {
+    _releaseLine();
+    return false;
   }
+  return low;
+}
 
-  for (size_t i = 0; i < len; ++i) {
-    if (!txByte(data[i])) {
-      _sendStop();
-      return Status::Error(Err::NACK_DATA, "Data byte NACK", static_cast<int32_t>(i));
-    }
+AT21CS_IRAM void Driver::_storeWaveSample(Waveform& wave, size_t index) const {
+  if (_readLine()) {
+    wave._samples[index / 8U] =
+        static_cast<uint8_t>(wave._samples[index / 8U] | (0x80U >> (index % 8U)));
   }
-
-  _sendStop();
-  return Status::Ok();
 }
 
-Status Driver::_readManufacturerIdRaw(uint32_t& manufacturerId) {
-  _sendStart();
-  if (!txByte(_deviceAddress(cmd::OPCODE_MANUFACTURER_ID, true))) {
-    _sendStop();
-    return Status::Error(Err::NACK_DEVICE_ADDRESS, "Manufacturer ID command NACK");
+AT21CS_IRAM void Driver::_waitTicks(uint32_t ticks, uint32_t tickNs) const {
+#if defined(ARDUINO_ARCH_ESP32)
+  if (_cycleTimed) {
+    const uint32_t cycles = (ticks * _waveCyclesPerTickQ8) >> 8U;
+    const uint32_t target = (cycles > _edgeOverheadCycles) ? cycles - _edgeOverheadCycles : 0U;
+    const uint32_t start = esp_cpu_get_cycle_count();
+    while ((esp_cpu_get_cycle_count() - start) < target) {}
+    return;
   }
+#endif
+  _sleepUs((ticks * tickNs) / 1000U);
+}
 
-  const uint8_t b0 = rxByte(true);
-  const uint8_t b1 = rxByte(true);
-  const uint8_t b2 = rxByte(false);
-
-  _sendStop();
-
-  manufacturerId =
-      (static_cast<uint32_t>(b0) << 16U) |
-      (static_cast<uint32_t>(b1) << 8U) |
-      static_cast<uint32_t>(b2);
+#if AT21CS_HAS_GPTIMER
+namespace {
 
-  return Status::Ok();
+bool IRAM_ATTR onGptimerAlarm(gptimer_handle_t, const gptimer_alarm_event_data_t*, void* user) {
+  static_cast<Driver*>(user)->onTimerAlarm();
+  return false;
 }
 
-Status Driver::_readCurrentAddressRaw(uint8_t& value) {
-  _sendStart();
-  if (!txByte(_deviceAddress(cmd::OPCODE_EEPROM, true))) {
-    _sendStop();
-    return Status::Error(Err::NACK_DEVICE_ADDRESS, "Current address read NACK");
-  }
+}  // namespace
+#endif
 
-  value = rxByte(false);
-  _sendStop();
+Status Driver::_setupTimerPhy() {
+  _releaseTimerPhy();
+  if (!_config.timerPhy || _config.alarmStart != nullptr) {
+    return Status::Ok();
+  }
+#if AT21CS_HAS_GPTIMER
+  // Free-running 1 MHz counter; each alarm is armed relative to its count.
+  gptimer_config_t timerCfg = {};
+  timerCfg.clk_src = GPTIMER_CLK_SRC_DEFAULT;
+  timerCfg.direction = GPTIMER_COUNT_UP;
+  timerCfg.resolution_hz = 1000000;
+  gptimer_handle_t timer = nullptr;
+  if (gptimer_new_timer(&timerCfg, &timer) != ESP_OK) {
+    return Status::Error(Err::IO_ERROR, "gptimer allocation failed");
+  }
+  gptimer_event_callbacks_t callbacks = {};
+  callbacks.on_alarm = onGptimerAlarm;
+  if (gptimer_register_event_callbacks(timer, &callbacks, this) != ESP_OK ||
+      gptimer_enable(timer) != ESP_OK || gptimer_start(timer) != ESP_OK) {
+    (void)gptimer_del_timer(timer);
+    return Status::Error(Err::IO_ERROR, "gptimer start failed");
+  }
+  _phyTimer = timer;
+#endif
   return Status::Ok();
 }
 
-bool Driver::_isZoneIndexValid(uint8_t zoneIndex) {
-  return zoneIndex < cmd::ROM_ZONE_REGISTER_COUNT;
-}
-
-bool Driver::_isSecurityUserAddressValid(uint8_t address) {
-  return address >= cmd::SECURITY_USER_MIN && address <= cmd::SECURITY_USER_MAX;
+void Driver::_releaseTimerPhy() {
+  _phyActive = false;
+#if AT21CS_HAS_GPTIMER
+  if (_phyTimer != nullptr) {
+    gptimer_handle_t timer = static_cast<gptimer_handle_t>(_phyTimer);
+    (void)gptimer_stop(timer);
+    (void)gptimer_disable(timer);
+    (void)gptimer_del_timer(timer);
+    _phyTimer = nullptr;
+  }
+#endif
 }
 
-void Driver::_setSpeedMode(SpeedMode mode) {
-  _speedMode = mode;
-  _timing = (mode == SpeedMode::STANDARD_SPEED) ? STANDARD_SPEED_TIMING : HIGH_SPEED_TIMING;
+#if defined(ARDUINO_ARCH_ESP32)
+void Driver::_measureEdgeOverhead() {
+  // Time a release of the already-released line followed by a zero-length
+  // segment: one register store, one call and two CCOUNT reads, which is what
+  // every programmed delay adds on the wire. The minimum filters interrupts
+  // and the first cache fill.
+  static constexpr uint8_t SAMPLES = 16;
+  const uint32_t saved = _segmentCycles[SEG_HTSS];
+  _segmentCycles[SEG_HTSS] = 0;
+  uint32_t best = UINT32_MAX;
+  for (uint8_t i = 0; i < SAMPLES; ++i) {
+    const uint32_t start = esp_cpu_get_cycle_count();
+    _releaseLine();
+    _waitSegment(SEG_HTSS);
+    const uint32_t cost = esp_cpu_get_cycle_count() - start;
+    if (cost < best) {
+      best = cost;
+    }
+  }
+  _segmentCycles[SEG_HTSS] = saved;
+  _edgeOverheadCycles = best;
 }
+#endif
 
 uint32_t Driver::_nowMs() const {
   if (_config.nowMs != nullptr) {
@@ -1484,6 +3248,9 @@ AT21CS_IRAM void Driver::_sleepUs(uint32_t us) const {
   if (us == 0U) {
     return;
   }
+  if (_masked) {
+    _maskSleptUs += us;
+  }
   if (_config.sleepUs != nullptr) {
     _config.sleepUs(us, _config.timeUser);
     return;
@@ -1500,6 +3267,27 @@ AT21CS_IRAM void Driver::_sleepUs(uint32_t us) const {
 #endif
 }
 
+// Long waits outside the bit slots: other tasks run while the whole ticks pass.
+void Driver::_yieldUs(uint32_t us) const {
+  if (_config.sleepUs != nullptr) {
+    _sleepUs(us);
+    return;
+  }
+#if defined(ARDUINO_ARCH_ESP32)
+  // vTaskDelay() never blocks longer than its ticks, so the remainder is spun
+  // against esp_timer and the wait is at least us.
+  const int64_t endUs = esp_timer_get_time() + us;
+  const TickType_t ticks = pdMS_TO_TICKS(us / 1000U);
+  if (ticks > 0) {
+    vTaskDelay(ticks);
+  }
+  while (esp_timer_get_time() < endUs) {}
+#else
+  delay(us / 1000U);
+  _sleepUs(us % 1000U);
+#endif
+}
+
 void Driver::_resetHealth() {
   _lastOkMs = 0;
   _lastErrorMs = 0;
@@ -0,0 +1,84 @@
+/// @file Batch.cpp
+/// @brief Operation recording for Driver::runBatch().
+
+#include "AT21CS/Batch.h"
+
+namespace AT21CS {
+
+namespace {
+
+constexpr Status notRun() {
+  return Status::Error(Err::INVALID_STATE, "Batch operation not run");
+}
+
+}  // namespace
+
+Status Batch::readEeprom(uint8_t address, uint8_t* data, size_t len) {
+  if (len > cmd::EEPROM_SIZE) {
+    return Status::Error(Err::INVALID_PARAM, "EEPROM read range out of bounds");
+  }
+  return _add(Op{OpType::READ_EEPROM, address, static_cast<uint8_t>(len), 0, data, nullptr,
+                 nullptr, nullptr});
+}
+
+Status Batch::readSecurity(uint8_t address, uint8_t* data, size_t len) {
+  if (len > cmd::SECURITY_SIZE) {
+    return Status::Error(Err::INVALID_PARAM, "Security read range out of bounds");
+  }
+  return _add(Op{OpType::READ_SECURITY, address, static_cast<uint8_t>(len), 0, data, nullptr,
+                 nullptr, nullptr});
+}
+
+Status Batch::writeEepromPage(uint8_t address, const uint8_t* data, size_t len) {
+  if (len > cmd::PAGE_SIZE) {
+    return Status::Error(Err::INVALID_PARAM, "EEPROM page write length must be 1..8");
+  }
+  return _add(Op{OpType::WRITE_EEPROM_PAGE, address, static_cast<uint8_t>(len), 0, nullptr, data,
+                 nullptr, nullptr});
+}
+
+Status Batch::writeSecurityUserPage(uint8_t address, const uint8_t* data, size_t len) {
+  if (len > cmd::PAGE_SIZE) {
+    return Status::Error(Err::INVALID_PARAM, "Security page write length must be 1..8");
+  }
+  return _add(Op{OpType::WRITE_SECURITY_PAGE, address, static_cast<uint8_t>(len), 0, nullptr,
+                 data, nullptr, nullptr});
+}
+
+Status Batch::waitReady(uint32_t timeoutMs) {
+  return _add(Op{OpType::WAIT_READY, 0, 0, timeoutMs, nullptr, nullptr, nullptr, nullptr});
+}
+
+Status Batch::readManufacturerId(uint32_t& manufacturerId) {
+  return _add(
+      Op{OpType::READ_MANUFACTURER_ID, 0, 0, 0, nullptr, nullptr, &manufacturerId, nullptr});
+}
+
+Status Batch::readSerialNumber(SerialNumberInfo& serial) {
+  return _add(Op{OpType::READ_SERIAL_NUMBER, 0, 0, 0, nullptr, nullptr, nullptr, &serial});
+}
+
+void Batch::clear() {
+  _count = 0;
+  _failedOps = 0;
+  _firstFailed = -1;
+}
+
+Status Batch::status(uint8_t index) const {
+  if (index >= _count) {
+    return Status::Error(Err::INVALID_PARAM, "Batch operation index out of range", index);
+  }
+  return _status[index];
+}
+
+Status Batch::_add(const Op& op) {
+  if (_count >= BATCH_MAX_OPS) {
+    return Status::Error(Err::INVALID_STATE, "Batch is full");
+  }
+  _ops[_count] = op;
+  _status[_count] = notRun();
+  ++_count;
+  return Status::Ok();
+}
+
+}  // namespace AT21CS
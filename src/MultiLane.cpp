@@ -0,0 +1,580 @@
+/// @file MultiLane.cpp
+/// @brief Implementation of the parallel multi-lane AT21CS reader/writer.
+
+#include "AT21CS/MultiLane.h"
+
+#include <Arduino.h>
+
+#include <cstring>
+
+#include "AT21CS/AT21CS.h"
+
+#if defined(ARDUINO_ARCH_ESP32)
+#include <driver/gpio.h>
+#endif
+
+namespace {
+
+// High-Speed bit timing, the whole-microsecond view of Driver::HIGH_SPEED_TIMING
+// (lanes share one spin loop, so edges are not cycle-placed). Lanes never
+// switch to Standard Speed, so reset/discovery always leaves them here.
+static constexpr uint32_t BIT_US = 12;
+static constexpr uint32_t LOW0_US = 8;
+static constexpr uint32_t LOW1_US = 1;
+static constexpr uint32_t READ_LOW_US = 1;
+static constexpr uint32_t READ_SAMPLE_US = 1;
+static constexpr uint32_t HTSS_US = 150;
+
+static constexpr uint32_t DISCHARGE_LOW_US = 150;
+static constexpr uint32_t RESET_RECOVERY_US = 10;
+static constexpr uint32_t DISCOVERY_REQUEST_US = 1;
+static constexpr uint32_t DISCOVERY_STROBE_DELAY_US = 2;
+static constexpr uint32_t DISCOVERY_STROBE_US = 2;
+static constexpr uint32_t DISCOVERY_SAMPLE_DELAY_US = 1;
+
+static constexpr uint32_t MAX_WRITE_TIMEOUT_MS = 250;
+static constexpr uint32_t READY_POLL_INTERVAL_US = 100;
+
+inline bool rangeFits(uint8_t startAddress, size_t len, size_t totalSize) {
+  if (len == 0 || static_cast<size_t>(startAddress) >= totalSize) {
+    return false;
+  }
+  return len <= totalSize - static_cast<size_t>(startAddress);
+}
+
+}  // namespace
+
+namespace AT21CS {
+
+Status LaneGroup::begin(const LaneGroupConfig& config) {
+  if (_initialized) {
+    end();
+  }
+
+  if (config.laneCount == 0 || config.laneCount > MAX_LANES) {
+    return Status::Error(Err::INVALID_CONFIG, "laneCount must be 1..8", config.laneCount);
+  }
+  if (config.writeTimeoutMs == 0 || config.writeTimeoutMs > MAX_WRITE_TIMEOUT_MS) {
+    return Status::Error(Err::INVALID_CONFIG, "writeTimeoutMs must be 1..250",
+                         static_cast<int32_t>(config.writeTimeoutMs));
+  }
+  if ((config.lineWrite == nullptr) != (config.lineRead == nullptr)) {
+    return Status::Error(Err::INVALID_CONFIG, "lineWrite and lineRead must be set together");
+  }
+
+  const bool upperBank = config.sioPins[0] >= 32;
+  for (uint8_t lane = 0; lane < config.laneCount; ++lane) {
+    const int pin = config.sioPins[lane];
+    if (pin < 0 || pin > 63) {
+      return Status::Error(Err::INVALID_CONFIG, "Invalid lane sioPin", lane);
+    }
+    if ((pin >= 32) != upperBank) {
+      return Status::Error(Err::INVALID_CONFIG, "Lane pins must share one GPIO bank", lane);
+    }
+    if (config.addressBits[lane] > 7) {
+      return Status::Error(Err::INVALID_CONFIG, "Lane addressBits must be 0..7", lane);
+    }
+    for (uint8_t other = 0; other < lane; ++other) {
+      if (config.sioPins[other] == pin) {
+        return Status::Error(Err::INVALID_CONFIG, "Duplicate lane sioPin", lane);
+      }
+    }
+  }
+
+  _config = config;
+  _allLanes = static_cast<uint8_t>((1U << config.laneCount) - 1U);
+
+  if (_config.lineWrite != nullptr) {
+    // Hooked lanes use the lane mask itself as the line word.
+#if defined(ARDUINO_ARCH_ESP32)
+    for (uint8_t lane = 0; lane < _config.laneCount; ++lane) {
+      _laneBits[lane] = 1U << lane;
+    }
+#endif
+    _releaseLine(_lineWord(_allLanes));
+    _initialized = true;
+    _presentMask = _discover();
+    return Status::Ok();
+  }
+
+#if defined(ARDUINO_ARCH_ESP32)
+  uint64_t pinMask = 0;
+  for (uint8_t lane = 0; lane < _config.laneCount; ++lane) {
+    pinMask |= (1ULL << static_cast<uint8_t>(_config.sioPins[lane]));
+  }
+  gpio_config_t sioCfg{};
+  sioCfg.pin_bit_mask = pinMask;
+  sioCfg.mode = GPIO_MODE_INPUT_OUTPUT_OD;
+  sioCfg.pull_up_en = GPIO_PULLUP_DISABLE;
+  sioCfg.pull_down_en = GPIO_PULLDOWN_DISABLE;
+  sioCfg.intr_type = GPIO_INTR_DISABLE;
+  if (gpio_config(&sioCfg) != ESP_OK) {
+    return Status::Error(Err::INVALID_CONFIG, "Failed to configure lane pins");
+  }
+
+  // One register write drives every lane edge.
+  if (!upperBank) {
+    _gpioSetReg = reinterpret_cast<volatile uint32_t*>(GPIO_OUT_W1TS_REG);
+    _gpioClrReg = reinterpret_cast<volatile uint32_t*>(GPIO_OUT_W1TC_REG);
+    _gpioInReg  = reinterpret_cast<volatile uint32_t*>(GPIO_IN_REG);
+  } else {
+    _gpioSetReg = reinterpret_cast<volatile uint32_t*>(GPIO_OUT1_W1TS_REG);
+    _gpioClrReg = reinterpret_cast<volatile uint32_t*>(GPIO_OUT1_W1TC_REG);
+    _gpioInReg  = reinterpret_cast<volatile uint32_t*>(GPIO_IN1_REG);
+  }
+  for (uint8_t lane = 0; lane < _config.laneCount; ++lane) {
+    _laneBits[lane] = 1U << (static_cast<uint8_t>(_config.sioPins[lane]) & 0x1FU);
+  }
+  _cyclesPerUs = static_cast<uint32_t>(getCpuFrequencyMhz());
+#else
+  for (uint8_t lane = 0; lane < _config.laneCount; ++lane) {
+    pinMode(static_cast<uint8_t>(_config.sioPins[lane]), OUTPUT_OPEN_DRAIN);
+  }
+#endif
+
+  _releaseLine(_lineWord(_allLanes));
+  _initialized = true;
+  _presentMask = _discover();
+  return Status::Ok();
+}
+
+void LaneGroup::end() {
+  if (_initialized) {
+    _releaseLine(_lineWord(_allLanes));
+  }
+#if defined(ARDUINO_ARCH_ESP32)
+  _gpioSetReg = nullptr;
+  _gpioClrReg = nullptr;
+  _gpioInReg = nullptr;
+#endif
+  _initialized = false;
+  _presentMask = 0;
+  _allLanes = 0;
+}
+
+Status LaneGroup::resetAndDiscover(uint8_t& presentMask) {
+  presentMask = 0;
+  Status st = _checkInitialized();
+  if (!st.ok()) {
+    return st;
+  }
+  _presentMask = _discover();
+  presentMask = _presentMask;
+  return _laneResult(_allLanes, presentMask);
+}
+
+Status LaneGroup::readEeprom(uint8_t address, uint8_t* data, size_t len, uint8_t& okMask) {
+  okMask = 0;
+  Status st = _checkInitialized();
+  if (!st.ok()) {
+    return st;
+  }
+  if (data == nullptr || !rangeFits(address, len, cmd::EEPROM_SIZE)) {
+    return Status::Error(Err::INVALID_PARAM, "Invalid EEPROM range");
+  }
+  return _readRandom(cmd::OPCODE_EEPROM, address, data, len, okMask);
+}
+
+Status LaneGroup::readSecurity(uint8_t address, uint8_t* data, size_t len, uint8_t& okMask) {
+  okMask = 0;
+  Status st = _checkInitialized();
+  if (!st.ok()) {
+    return st;
+  }
+  if (data == nullptr || !rangeFits(address, len, cmd::SECURITY_SIZE)) {
+    return Status::Error(Err::INVALID_PARAM, "Invalid Security register range");
+  }
+  return _readRandom(cmd::OPCODE_SECURITY, address, data, len, okMask);
+}
+
+Status LaneGroup::readManufacturerId(uint32_t* ids, uint8_t& okMask) {
+  okMask = 0;
+  Status st = _checkInitialized();
+  if (!st.ok()) {
+    return st;
+  }
+  if (ids == nullptr) {
+    return Status::Error(Err::INVALID_PARAM, "ids is null");
+  }
+
+  uint8_t lanes = _discover();
+  _presentMask = lanes;
+  lanes &= _txDeviceAddress(cmd::OPCODE_MANUFACTURER_ID, true, lanes);
+
+  uint8_t raw[3][MAX_LANES] = {};
+  for (uint8_t i = 0; i < 3U; ++i) {
+    _rxBytes(raw[i], lanes, i < 2U);
+  }
+  _sendStartStop();
+
+  for (uint8_t lane = 0; lane < _config.laneCount; ++lane) {
+    ids[lane] = (static_cast<uint32_t>(raw[0][lane]) << 16) |
+                (static_cast<uint32_t>(raw[1][lane]) << 8) |
+                static_cast<uint32_t>(raw[2][lane]);
+  }
+  okMask = lanes;
+  return _laneResult(_allLanes, okMask);
+}
+
+Status LaneGroup::writeEepromPage(uint8_t address, const uint8_t* data, size_t len,
+                                  size_t laneStride, uint8_t& okMask) {
+  okMask = 0;
+  Status st = _checkInitialized();
+  if (!st.ok()) {
+    return st;
+  }
+  if (data == nullptr || !rangeFits(address, len, cmd::EEPROM_SIZE) ||
+      len > cmd::PAGE_SIZE - (address % cmd::PAGE_SIZE)) {
+    return Status::Error(Err::INVALID_PARAM, "Write must stay within one page");
+  }
+  if (laneStride != 0 && laneStride < len) {
+    return Status::Error(Err::INVALID_PARAM, "laneStride shorter than len");
+  }
+
+  uint8_t lanes = _discover();
+  _presentMask = lanes;
+  lanes &= _txDeviceAddress(cmd::OPCODE_EEPROM, false, lanes);
+  lanes &= _txSame(address, lanes);
+
+  uint8_t column[MAX_LANES] = {};
+  for (size_t i = 0; i < len && lanes != 0; ++i) {
+    for (uint8_t lane = 0; lane < _config.laneCount; ++lane) {
+      column[lane] = data[static_cast<size_t>(lane) * laneStride + i];
+    }
+    lanes &= _txBytes(column, lanes);
+  }
+  _sendStartStop();
+
+  okMask = _waitReady(lanes);
+  return _laneResult(_allLanes, okMask);
+}
+
+Status LaneGroup::_checkInitialized() const {
+  if (!_initialized) {
+    return Status::Error(Err::NOT_INITIALIZED, "begin() not called");
+  }
+  return Status::Ok();
+}
+
+Status LaneGroup::_laneResult(uint8_t requested, uint8_t okMask) const {
+  const uint8_t failed = static_cast<uint8_t>(requested & ~okMask);
+  if (failed != 0) {
+    return Status::Error(Err::IO_ERROR, "One or more lanes failed", failed);
+  }
+  return Status::Ok();
+}
+
+Status LaneGroup::_readRandom(uint8_t opcode, uint8_t address, uint8_t* data, size_t len,
+                              uint8_t& okMask) {
+  uint8_t lanes = _discover();
+  _presentMask = lanes;
+  lanes &= _txDeviceAddress(opcode, false, lanes);
+  lanes &= _txSame(address, lanes);
+  _releaseLine(_lineWord(_allLanes));
+  _sleepUs(HTSS_US);
+  lanes &= _txDeviceAddress(opcode, true, lanes);
+
+  uint8_t column[MAX_LANES] = {};
+  for (size_t i = 0; i < len; ++i) {
+    _rxBytes(column, lanes, (i + 1U) < len);
+    for (uint8_t lane = 0; lane < _config.laneCount; ++lane) {
+      data[static_cast<size_t>(lane) * len + i] = column[lane];
+    }
+  }
+  _sendStartStop();
+
+  okMask = lanes;
+  return _laneResult(_allLanes, okMask);
+}
+
+uint8_t LaneGroup::_discover() {
+  const uint32_t allWord = _lineWord(_allLanes);
+  _lineLow(allWord);
+  _sleepUs(DISCHARGE_LOW_US);
+  _releaseLine(allWord);
+  _sleepUs(RESET_RECOVERY_US);
+
+#if defined(ARDUINO_ARCH_ESP32)
+  portENTER_CRITICAL(&_timingMux);
+#endif
+
+  _lineLow(allWord);
+  _sleepUs(DISCOVERY_REQUEST_US);
+  _releaseLine(allWord);
+
+  _sleepUs(DISCOVERY_STROBE_DELAY_US);
+
+  _lineLow(allWord);
+  _sleepUs(DISCOVERY_STROBE_US);
+  _releaseLine(allWord);
+
+  _sleepUs(DISCOVERY_SAMPLE_DELAY_US);
+  const uint32_t level = _readLines();
+
+#if defined(ARDUINO_ARCH_ESP32)
+  portEXIT_CRITICAL(&_timingMux);
+#endif
+
+  _sleepUs(HTSS_US);
+  return static_cast<uint8_t>(_allLanes & ~_lanesFromWord(level));
+}
+
+uint8_t LaneGroup::_waitReady(uint8_t lanes) {
+  // Lanes leave the pending set as soon as they ACK; the rest are polled
+  // together until every write cycle has finished or the timeout expires.
+  uint8_t pending = lanes;
+  uint8_t ready = 0;
+  const uint32_t startMs = _nowMs();
+  uint32_t elapsedUs = 0;
+  const uint32_t timeoutUs = _config.writeTimeoutMs * 1000U;
+  while (pending != 0) {
+    _sleepUs(HTSS_US);
+    const uint8_t ack = _txDeviceAddress(cmd::OPCODE_EEPROM, false, pending);
+    _sleepUs(HTSS_US);
+    ready |= ack;
+    pending &= static_cast<uint8_t>(~ack);
+    if (pending == 0) {
+      break;
+    }
+    elapsedUs += 2U * HTSS_US + 9U * BIT_US + READY_POLL_INTERVAL_US;
+    if (elapsedUs >= timeoutUs || (_nowMs() - startMs) >= _config.writeTimeoutMs) {
+      break;
+    }
+    _sleepUs(READY_POLL_INTERVAL_US);
+  }
+  return ready;
+}
+
+uint32_t LaneGroup::_lineWord(uint8_t lanes) const {
+#if defined(ARDUINO_ARCH_ESP32)
+  uint32_t bits = 0;
+  for (uint8_t lane = 0; lane < _config.laneCount; ++lane) {
+    if ((lanes & (1U << lane)) != 0U) {
+      bits |= _laneBits[lane];
+    }
+  }
+  return bits;
+#else
+  return lanes;
+#endif
+}
+
+uint8_t LaneGroup::_lanesFromWord(uint32_t word) const {
+#if defined(ARDUINO_ARCH_ESP32)
+  uint8_t lanes = 0;
+  for (uint8_t lane = 0; lane < _config.laneCount; ++lane) {
+    if ((word & _laneBits[lane]) != 0U) {
+      lanes = static_cast<uint8_t>(lanes | (1U << lane));
+    }
+  }
+  return lanes;
+#else
+  return static_cast<uint8_t>(word);
+#endif
+}
+
+AT21CS_IRAM void LaneGroup::_lineLow(uint32_t word) {
+  if (_config.lineWrite != nullptr) {
+    _hookLines(word, true);
+    return;
+  }
+#if defined(ARDUINO_ARCH_ESP32)
+  if (_gpioClrReg == nullptr) {
+    return;
+  }
+  *_gpioClrReg = word;
+#else
+  for (uint8_t lane = 0; lane < _config.laneCount; ++lane) {
+    if ((word & (1U << lane)) != 0U) {
+      digitalWrite(static_cast<uint8_t>(_config.sioPins[lane]), LOW);
+    }
+  }
+#endif
+}
+
+AT21CS_IRAM void LaneGroup::_releaseLine(uint32_t word) {
+  if (_config.lineWrite != nullptr) {
+    _hookLines(word, false);
+    return;
+  }
+#if defined(ARDUINO_ARCH_ESP32)
+  if (_gpioSetReg == nullptr) {
+    return;
+  }
+  *_gpioSetReg = word;
+#else
+  for (uint8_t lane = 0; lane < _config.laneCount; ++lane) {
+    if ((word & (1U << lane)) != 0U) {
+      digitalWrite(static_cast<uint8_t>(_config.sioPins[lane]), HIGH);
+    }
+  }
+#endif
+}
+
+AT21CS_IRAM uint32_t LaneGroup::_readLines() const {
+  if (_config.lineRead != nullptr) {
+    uint32_t word = 0;
+    for (uint8_t lane = 0; lane < _config.laneCount; ++lane) {
+      if (_config.lineRead(_config.lineUser[lane])) {
+        word |= (1U << lane);
+      }
+    }
+    return word;
+  }
+#if defined(ARDUINO_ARCH_ESP32)
+  if (_gpioInReg == nullptr) {
+    return UINT32_MAX;
+  }
+  // Single register read: every lane is sampled in the same instant.
+  return *_gpioInReg;
+#else
+  uint32_t word = 0;
+  for (uint8_t lane = 0; lane < _config.laneCount; ++lane) {
+    if (digitalRead(static_cast<uint8_t>(_config.sioPins[lane])) != 0) {
+      word |= (1U << lane);
+    }
+  }
+  return word;
+#endif
+}
+
+AT21CS_IRAM void LaneGroup::_hookLines(uint32_t word, bool low) {
+  for (uint8_t lane = 0; lane < _config.laneCount; ++lane) {
+    if ((word & (1U << lane)) != 0U) {
+      _config.lineWrite(low, _config.lineUser[lane]);
+    }
+  }
+}
+
+AT21CS_IRAM uint8_t LaneGroup::_txBytes(const uint8_t* values, uint8_t lanes) {
+  if (lanes == 0) {
+    return 0;
+  }
+
+  // Transpose per-lane bytes into per-bit line words before entering the
+  // timed section so each edge costs a single register write.
+  const uint32_t laneWord = _lineWord(lanes);
+  uint32_t oneWords[8] = {};
+  uint32_t zeroWords[8] = {};
+  for (uint8_t bit = 0; bit < 8U; ++bit) {
+    uint8_t oneLanes = 0;
+    for (uint8_t lane = 0; lane < _config.laneCount; ++lane) {
+      if (((values[lane] >> (7U - bit)) & 0x01U) != 0U) {
+        oneLanes = static_cast<uint8_t>(oneLanes | (1U << lane));
+      }
+    }
+    oneWords[bit] = _lineWord(static_cast<uint8_t>(oneLanes & lanes));
+    zeroWords[bit] = laneWord & ~oneWords[bit];
+  }
+
+#if defined(ARDUINO_ARCH_ESP32)
+  portENTER_CRITICAL(&_timingMux);
+#endif
+
+  for (uint8_t bit = 0; bit < 8U; ++bit) {
+    _lineLow(laneWord);
+    _sleepUs(LOW1_US);
+    _releaseLine(oneWords[bit]);
+    _sleepUs(LOW0_US - LOW1_US);
+    _releaseLine(zeroWords[bit]);
+    _sleepUs(BIT_US - LOW0_US);
+  }
+
+  _lineLow(laneWord);
+  _sleepUs(READ_LOW_US);
+  _releaseLine(laneWord);
+  _sleepUs(READ_SAMPLE_US);
+  const uint32_t level = _readLines();
+  _sleepUs(BIT_US - READ_LOW_US - READ_SAMPLE_US);
+
+#if defined(ARDUINO_ARCH_ESP32)
+  portEXIT_CRITICAL(&_timingMux);
+#endif
+
+  return static_cast<uint8_t>(lanes & ~_lanesFromWord(level));
+}
+
+uint8_t LaneGroup::_txSame(uint8_t value, uint8_t lanes) {
+  uint8_t values[MAX_LANES];
+  memset(values, value, sizeof(values));
+  return _txBytes(values, lanes);
+}
+
+AT21CS_IRAM void LaneGroup::_rxBytes(uint8_t* values, uint8_t lanes, bool ack) {
+  memset(values, 0, MAX_LANES);
+  if (lanes == 0) {
+    return;
+  }
+
+  const uint32_t laneWord = _lineWord(lanes);
+  const uint32_t ackLowUs = ack ? LOW0_US : LOW1_US;
+  uint32_t samples[8] = {};
+
+#if defined(ARDUINO_ARCH_ESP32)
+  portENTER_CRITICAL(&_timingMux);
+#endif
+
+  for (uint8_t bit = 0; bit < 8U; ++bit) {
+    _lineLow(laneWord);
+    _sleepUs(READ_LOW_US);
+    _releaseLine(laneWord);
+    _sleepUs(READ_SAMPLE_US);
+    samples[bit] = _readLines();
+    _sleepUs(BIT_US - READ_LOW_US - READ_SAMPLE_US);
+  }
+
+  _lineLow(laneWord);
+  _sleepUs(ackLowUs);
+  _releaseLine(laneWord);
+  _sleepUs(BIT_US - ackLowUs);
+
+#if defined(ARDUINO_ARCH_ESP32)
+  portEXIT_CRITICAL(&_timingMux);
+#endif
+
+  for (uint8_t bit = 0; bit < 8U; ++bit) {
+    const uint8_t high = static_cast<uint8_t>(_lanesFromWord(samples[bit]) & lanes);
+    for (uint8_t lane = 0; lane < _config.laneCount; ++lane) {
+      values[lane] = static_cast<uint8_t>((values[lane] << 1) | ((high >> lane) & 0x01U));
+    }
+  }
+}
+
+uint8_t LaneGroup::_txDeviceAddress(uint8_t opcode, bool read, uint8_t lanes) {
+  uint8_t values[MAX_LANES] = {};
+  for (uint8_t lane = 0; lane < _config.laneCount; ++lane) {
+    values[lane] = cmd::deviceAddress(opcode, _config.addressBits[lane], read);
+  }
+  return _txBytes(values, lanes);
+}
+
+void LaneGroup::_sendStartStop() {
+  _releaseLine(_lineWord(_allLanes));
+  _sleepUs(HTSS_US);
+}
+
+uint32_t LaneGroup::_nowMs() const {
+  if (_config.nowMs != nullptr) {
+    return _config.nowMs(_config.timeUser);
+  }
+  return millis();
+}
+
+AT21CS_IRAM void LaneGroup::_sleepUs(uint32_t us) const {
+  if (us == 0U) {
+    return;
+  }
+  if (_config.sleepUs != nullptr) {
+    _config.sleepUs(us, _config.timeUser);
+    return;
+  }
+#if defined(ARDUINO_ARCH_ESP32)
+  const uint32_t target = us * _cyclesPerUs;
+  const uint32_t start = esp_cpu_get_cycle_count();
+  while ((esp_cpu_get_cycle_count() - start) < target) {}
+#else
+  delayMicroseconds(us);
+#endif
+}
+
+}  // namespace AT21CS
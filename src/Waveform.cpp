@@ -0,0 +1,244 @@
+/// @file Waveform.cpp
+/// @brief Symbol encoding for pre-built bus transactions.
+
+#include "AT21CS/Waveform.h"
+
+#include <cstring>
+
+namespace AT21CS {
+
+namespace {
+
+inline void setBit(uint8_t* mask, size_t index) {
+  mask[index / 8U] = static_cast<uint8_t>(mask[index / 8U] | (0x80U >> (index % 8U)));
+}
+
+inline bool testBit(const uint8_t* mask, size_t index) {
+  return (mask[index / 8U] & (0x80U >> (index % 8U))) != 0U;
+}
+
+}  // namespace
+
+Status Waveform::begin(const TimingProfile& timing, SpeedMode mode, uint8_t addressBits,
+                       uint32_t tickNs) {
+  if (tickNs == 0U || tickNs > 1000U) {
+    return Status::Error(Err::INVALID_PARAM, "Waveform tick must be 1..1000 ns");
+  }
+  if (addressBits > 7U) {
+    return Status::Error(Err::INVALID_PARAM, "addressBits must be 0..7");
+  }
+  const Status st = Driver::validateTimingProfile(timing, mode);
+  if (!st.ok()) {
+    return st;
+  }
+
+  _timing = timing;
+  _mode = mode;
+  _addressBits = addressBits;
+  _tickNs = tickNs;
+
+  // Same truncation as Driver::_updateSegments(), one tick per microsecond there.
+  const uint32_t bit = timing.bitNs / tickNs;
+  _low0 = timing.low0Ns / tickNs;
+  _high0 = (bit > _low0) ? bit - _low0 : 0U;
+  _low1 = timing.low1Ns / tickNs;
+  _high1 = (bit > _low1) ? bit - _low1 : 0U;
+  _readLow = timing.readLowNs / tickNs;
+  _readSample = timing.readSampleNs / tickNs;
+  _readRest = (bit > _readLow + _readSample) ? bit - _readLow - _readSample : 0U;
+  _htss = timing.htssNs / tickNs;
+
+  clear();
+  return Status::Ok();
+}
+
+void Waveform::clear() {
+  _count = 0;
+  _sampleCount = 0;
+  _totalTicks = 0;
+  std::memset(_samples, 0, sizeof(_samples));
+  std::memset(_ackMask, 0, sizeof(_ackMask));
+  std::memset(_addressAckMask, 0, sizeof(_addressAckMask));
+  _frameBytes = 0;
+  _frameWrites = false;
+  _writes = false;
+  _speedCommand = false;
+  _overflow = false;
+}
+
+void Waveform::start() {
+  _append(true, _htss, false);
+  _frameBytes = 0;
+}
+
+void Waveform::stop() {
+  _append(true, _htss, false);
+  _frameBytes = 0;
+}
+
+size_t Waveform::txByte(uint8_t value) {
+  for (int8_t bit = 7; bit >= 0; --bit) {
+    _txBit(((value >> bit) & 0x01U) != 0U);
+  }
+
+  const size_t ack = _sampleCount;
+  if (ack < WAVEFORM_MAX_SAMPLES) {
+    setBit(_ackMask, ack);
+    if (_frameBytes == 0U) {
+      setBit(_addressAckMask, ack);
+    }
+  }
+  _rxBit();
+
+  // The first byte after Start is the device address: it decides whether the
+  // frame writes (address plus data) or switches the speed mode.
+  if (_frameBytes == 0U) {
+    const uint8_t opcode = static_cast<uint8_t>(value >> 4U);
+    _frameWrites = (value & 0x01U) == 0U;
+    if (_frameWrites &&
+        (opcode == cmd::OPCODE_STANDARD_SPEED || opcode == cmd::OPCODE_HIGH_SPEED)) {
+      _speedCommand = true;
+    }
+  } else if (_frameBytes >= 2U && _frameWrites) {
+    _writes = true;
+  }
+  if (_frameBytes < UINT8_MAX) {
+    ++_frameBytes;
+  }
+  return ack;
+}
+
+size_t Waveform::rxByte(bool ack) {
+  const size_t first = _sampleCount;
+  for (uint8_t bit = 0; bit < 8U; ++bit) {
+    _rxBit();
+  }
+  // The master answers with a '0' to acknowledge and a '1' to end the read.
+  _txBit(!ack);
+  return first;
+}
+
+Status Waveform::encodeRandomRead(uint8_t opcode, uint8_t address, size_t len) {
+  if (_tickNs == 0U) {
+    return Status::Error(Err::NOT_INITIALIZED, "Waveform::begin() must succeed first");
+  }
+  if (len == 0U) {
+    return Status::Error(Err::INVALID_PARAM, "Waveform read length must be at least 1");
+  }
+  clear();
+  start();
+  (void)txByte(cmd::deviceAddress(opcode, _addressBits, false));
+  (void)txByte(address);
+  start();
+  (void)txByte(cmd::deviceAddress(opcode, _addressBits, true));
+  for (size_t i = 0; i < len; ++i) {
+    (void)rxByte((i + 1U) < len);
+  }
+  stop();
+  if (_overflow) {
+    return Status::Error(Err::INVALID_PARAM, "Waveform buffer too small for read");
+  }
+  return Status::Ok();
+}
+
+Status Waveform::encodeWrite(uint8_t opcode, uint8_t address, const uint8_t* data, size_t len) {
+  if (_tickNs == 0U) {
+    return Status::Error(Err::NOT_INITIALIZED, "Waveform::begin() must succeed first");
+  }
+  if (data == nullptr || len == 0U) {
+    return Status::Error(Err::INVALID_PARAM, "Waveform write needs at least one byte");
+  }
+  clear();
+  start();
+  (void)txByte(cmd::deviceAddress(opcode, _addressBits, false));
+  (void)txByte(address);
+  for (size_t i = 0; i < len; ++i) {
+    (void)txByte(data[i]);
+  }
+  stop();
+  if (_overflow) {
+    return Status::Error(Err::INVALID_PARAM, "Waveform buffer too small for write");
+  }
+  return Status::Ok();
+}
+
+bool Waveform::sample(size_t index) const {
+  return index < _sampleCount && testBit(_samples, index);
+}
+
+uint8_t Waveform::sampleByte(size_t first) const {
+  uint8_t value = 0;
+  for (uint8_t bit = 0; bit < 8U; ++bit) {
+    value = static_cast<uint8_t>((value << 1U) | (sample(first + bit) ? 1U : 0U));
+  }
+  return value;
+}
+
+void Waveform::storeSample(size_t index, bool high) {
+  if (index >= _sampleCount) {
+    return;
+  }
+  const uint8_t bit = static_cast<uint8_t>(0x80U >> (index % 8U));
+  _samples[index / 8U] = high ? static_cast<uint8_t>(_samples[index / 8U] | bit)
+                              : static_cast<uint8_t>(_samples[index / 8U] & ~bit);
+}
+
+Status Waveform::ackStatus() const {
+  uint8_t frameByte = 0;
+  for (size_t i = 0; i < _sampleCount; ++i) {
+    if (!testBit(_ackMask, i)) {
+      continue;
+    }
+    frameByte = testBit(_addressAckMask, i) ? 0U : static_cast<uint8_t>(frameByte + 1U);
+    if (!testBit(_samples, i)) {
+      continue;
+    }
+    if (frameByte == 0U) {
+      return Status::Error(Err::NACK_DEVICE_ADDRESS, "Device address NACK");
+    }
+    if (frameByte == 1U) {
+      return Status::Error(Err::NACK_MEMORY_ADDRESS, "Memory address NACK");
+    }
+    return Status::Error(Err::NACK_DATA, "Data byte NACK", frameByte - 2);
+  }
+  return Status::Ok();
+}
+
+void Waveform::_append(bool high, uint32_t ticks, bool sample) {
+  // Zero-length segments produce no symbol; a sample point always does.
+  if (ticks == 0U && !sample) {
+    return;
+  }
+  if (sample && _sampleCount >= WAVEFORM_MAX_SAMPLES) {
+    _overflow = true;
+    return;
+  }
+  _totalTicks += ticks;
+  const uint16_t level = high ? WaveSymbol::HIGH_BIT : 0U;
+  do {
+    if (_count >= WAVEFORM_MAX_SYMBOLS) {
+      _overflow = true;
+      return;
+    }
+    const uint32_t chunk = (ticks > WaveSymbol::TICKS_MASK) ? WaveSymbol::TICKS_MASK : ticks;
+    ticks -= chunk;
+    const uint16_t mark = (sample && ticks == 0U) ? WaveSymbol::SAMPLE_BIT : 0U;
+    _symbols[_count++] = WaveSymbol{static_cast<uint16_t>(level | mark | chunk)};
+  } while (ticks != 0U);
+  if (sample) {
+    ++_sampleCount;
+  }
+}
+
+void Waveform::_txBit(bool one) {
+  _append(false, one ? _low1 : _low0, false);
+  _append(true, one ? _high1 : _high0, false);
+}
+
+void Waveform::_rxBit() {
+  _append(false, _readLow, false);
+  _append(true, _readSample, true);
+  _append(true, _readRest, false);
+}
+
+}  // namespace AT21CS
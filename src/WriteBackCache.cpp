@@ -0,0 +1,308 @@
+/// @file WriteBackCache.cpp
+/// @brief Implementation of the write-combining EEPROM page cache.
+
+#include "AT21CS/WriteBackCache.h"
+
+#include <cstring>
+
+namespace AT21CS {
+
+namespace {
+
+// Upper bound on consecutive tick() calls without the driver clock moving
+// while draining an in-flight page, so a stalled timebase cannot hang flush().
+static constexpr uint32_t MAX_STALLED_DRAIN_TICKS = 100000;
+
+inline uint8_t popCount(uint8_t value) {
+  uint8_t count = 0;
+  while (value != 0U) {
+    value = static_cast<uint8_t>(value & (value - 1U));
+    ++count;
+  }
+  return count;
+}
+
+}  // namespace
+
+Status WriteBackCache::begin(Driver* driver, const WriteBackConfig& config) {
+  if (driver == nullptr) {
+    return Status::Error(Err::INVALID_PARAM, "driver is null");
+  }
+  if (config.maxDirtyPages > WRITE_BACK_PAGES) {
+    return Status::Error(Err::INVALID_PARAM, "maxDirtyPages must be 0..16");
+  }
+  _driver = driver;
+  _config = config;
+  discard();
+  _stats = WriteBackStats{};
+  _lastError = Status::Ok();
+  return Status::Ok();
+}
+
+Status WriteBackCache::end() {
+  if (_driver == nullptr) {
+    return Status::Ok();
+  }
+  const Status st = flush();
+  _driver = nullptr;
+  return st;
+}
+
+Status WriteBackCache::readEeprom(uint8_t address, uint8_t* data, size_t len) {
+  Status st = _checkAttached();
+  if (!st.ok()) {
+    return st;
+  }
+  if (data == nullptr) {
+    return Status::Error(Err::INVALID_PARAM, "EEPROM read buffer is null");
+  }
+  if (len == 0 || static_cast<size_t>(address) >= cmd::EEPROM_SIZE ||
+      len > cmd::EEPROM_SIZE - static_cast<size_t>(address)) {
+    return Status::Error(Err::INVALID_PARAM, "EEPROM read range out of bounds");
+  }
+
+  bool allDirty = true;
+  for (size_t i = 0; i < len && allDirty; ++i) {
+    const size_t addr = static_cast<size_t>(address) + i;
+    allDirty = (_dirty[addr / cmd::PAGE_SIZE] & (1U << (addr % cmd::PAGE_SIZE))) != 0U;
+  }
+  if (!allDirty) {
+    // The driver rejects reads while an asynchronous write is running.
+    st = _drainInflight();
+    if (!st.ok()) {
+      return st;
+    }
+    st = _driver->readEeprom(address, data, len);
+    if (!st.ok()) {
+      return st;
+    }
+  }
+
+  for (size_t i = 0; i < len; ++i) {
+    const size_t addr = static_cast<size_t>(address) + i;
+    if ((_dirty[addr / cmd::PAGE_SIZE] & (1U << (addr % cmd::PAGE_SIZE))) != 0U) {
+      data[i] = _data[addr];
+    }
+  }
+  return Status::Ok();
+}
+
+Status WriteBackCache::writeEepromByte(uint8_t address, uint8_t value) {
+  return writeEeprom(address, &value, 1);
+}
+
+Status WriteBackCache::writeEeprom(uint8_t address, const uint8_t* data, size_t len) {
+  const Status st = _checkAttached();
+  if (!st.ok()) {
+    return st;
+  }
+  if (data == nullptr) {
+    return Status::Error(Err::INVALID_PARAM, "EEPROM write buffer is null");
+  }
+  if (len == 0 || static_cast<size_t>(address) >= cmd::EEPROM_SIZE ||
+      len > cmd::EEPROM_SIZE - static_cast<size_t>(address)) {
+    return Status::Error(Err::INVALID_PARAM, "EEPROM write range out of bounds");
+  }
+
+  for (size_t i = 0; i < len; ++i) {
+    const size_t addr = static_cast<size_t>(address) + i;
+    const size_t page = addr / cmd::PAGE_SIZE;
+    if (_dirty[page] == 0U) {
+      _dirtySinceMs[page] = _nowMs;
+    }
+    _data[addr] = data[i];
+    _dirty[page] = static_cast<uint8_t>(_dirty[page] | (1U << (addr % cmd::PAGE_SIZE)));
+  }
+  ++_stats.stagedWrites;
+  _stats.bytesStaged += static_cast<uint32_t>(len);
+  return Status::Ok();
+}
+
+void WriteBackCache::tick(uint32_t nowMs) {
+  if (_driver == nullptr) {
+    return;
+  }
+  _nowMs = nowMs;
+
+  if (_inflightPage >= 0) {
+    _driver->tick(nowMs);
+    if (_driver->writeInProgress()) {
+      return;
+    }
+    _finishInflight(_driver->writeStatus());
+  }
+  if (_driver->writeInProgress()) {
+    return;
+  }
+
+  const int8_t oldest = _oldestDirtyPage();
+  if (oldest < 0) {
+    return;
+  }
+  const bool tooMany = _config.maxDirtyPages != 0U && dirtyPages() >= _config.maxDirtyPages;
+  const bool tooOld = _config.maxAgeMs != 0U &&
+                      (nowMs - _dirtySinceMs[static_cast<uint8_t>(oldest)]) >= _config.maxAgeMs;
+  if (tooMany || tooOld) {
+    (void)_writePage(static_cast<uint8_t>(oldest), true);
+  }
+}
+
+Status WriteBackCache::flush() {
+  Status st = _checkAttached();
+  if (!st.ok()) {
+    return st;
+  }
+  Status first = _drainInflight();
+  for (uint8_t page = 0; page < WRITE_BACK_PAGES; ++page) {
+    if (_dirty[page] == 0U) {
+      continue;
+    }
+    st = _writePage(page, false);
+    if (!st.ok() && first.ok()) {
+      first = st;
+    }
+  }
+  return first;
+}
+
+void WriteBackCache::discard() {
+  std::memset(_dirty, 0, sizeof(_dirty));
+  _inflightMask = 0;
+  // An in-flight page keeps running in the driver; its result is ignored.
+  _inflightPage = -1;
+}
+
+uint16_t WriteBackCache::dirtyMask() const {
+  uint16_t mask = 0;
+  for (uint8_t page = 0; page < WRITE_BACK_PAGES; ++page) {
+    if (_dirty[page] != 0U || page == _inflightPage) {
+      mask = static_cast<uint16_t>(mask | (1U << page));
+    }
+  }
+  return mask;
+}
+
+uint8_t WriteBackCache::dirtyPages() const {
+  const uint16_t mask = dirtyMask();
+  return static_cast<uint8_t>(popCount(static_cast<uint8_t>(mask & 0xFFU)) +
+                              popCount(static_cast<uint8_t>(mask >> 8U)));
+}
+
+Status WriteBackCache::_checkAttached() const {
+  if (_driver == nullptr) {
+    return Status::Error(Err::NOT_INITIALIZED, "WriteBackCache::begin() must succeed first");
+  }
+  return Status::Ok();
+}
+
+Status WriteBackCache::_writePage(uint8_t page, bool async) {
+  const uint8_t mask = _dirty[page];
+  uint8_t first = 0;
+  while ((mask & (1U << first)) == 0U) {
+    ++first;
+  }
+  uint8_t last = cmd::PAGE_SIZE - 1U;
+  while ((mask & (1U << last)) == 0U) {
+    --last;
+  }
+  const uint8_t start = static_cast<uint8_t>(page * cmd::PAGE_SIZE + first);
+  const uint8_t len = static_cast<uint8_t>(last - first + 1U);
+  const uint8_t span = static_cast<uint8_t>(((1U << len) - 1U) << first);
+
+  Status st = Status::Ok();
+  if ((span & ~mask) != 0U) {
+    // Clean bytes between dirty ones must be rewritten with their stored value.
+    uint8_t current[cmd::PAGE_SIZE] = {};
+    st = _driver->readEeprom(start, current, len);
+    if (!st.ok()) {
+      ++_stats.failedFlushes;
+      _lastError = st;
+      return st;
+    }
+    ++_stats.fillReads;
+    for (uint8_t i = 0; i < len; ++i) {
+      if ((mask & (1U << (first + i))) == 0U) {
+        _data[start + i] = current[i];
+      }
+    }
+  }
+
+  if (async) {
+    st = _driver->startWriteEeprom(start, &_data[start], len);
+    if (st.inProgress()) {
+      ++_stats.pageWrites;
+      _inflightPage = static_cast<int8_t>(page);
+      _inflightMask = mask;
+      _dirty[page] = 0;
+      return st;
+    }
+  } else {
+    st = _driver->writeEepromPage(start, &_data[start], len);
+    if (st.ok()) {
+      ++_stats.pageWrites;
+      _dirty[page] = 0;
+      return st;
+    }
+  }
+
+  ++_stats.failedFlushes;
+  _lastError = st;
+  return st;
+}
+
+Status WriteBackCache::_drainInflight() {
+  // Bounded by time, not tick count: tick() returns at once while the
+  // adaptive head of t_WR is still pending.
+  const uint32_t timeoutMs = _driver->getSettings().config.writeTimeoutMs;
+  const uint32_t startMs = _driver->nowMs();
+  uint32_t lastMs = startMs;
+  uint32_t stalledTicks = 0;
+  while (_inflightPage >= 0 && _driver->writeInProgress()) {
+    const uint32_t nowMs = _driver->nowMs();
+    if (nowMs - startMs > timeoutMs) {
+      return Status::Error(Err::BUSY_TIMEOUT, "Write-back page write did not complete");
+    }
+    if (nowMs != lastMs) {
+      lastMs = nowMs;
+      stalledTicks = 0;
+    } else if (++stalledTicks > MAX_STALLED_DRAIN_TICKS) {
+      return Status::Error(Err::BUSY_TIMEOUT, "Driver clock stalled while draining");
+    }
+    _driver->tick(nowMs);
+  }
+  if (_inflightPage >= 0) {
+    _finishInflight(_driver->writeStatus());
+  }
+  return Status::Ok();
+}
+
+void WriteBackCache::_finishInflight(const Status& result) {
+  const uint8_t page = static_cast<uint8_t>(_inflightPage);
+  _inflightPage = -1;
+  if (result.ok()) {
+    return;
+  }
+  // Keep the bytes dirty so a later tick() or flush() retries them.
+  if (_dirty[page] == 0U) {
+    _dirtySinceMs[page] = _nowMs;
+  }
+  _dirty[page] = static_cast<uint8_t>(_dirty[page] | _inflightMask);
+  ++_stats.failedFlushes;
+  _lastError = result;
+}
+
+int8_t WriteBackCache::_oldestDirtyPage() const {
+  int8_t oldest = -1;
+  for (uint8_t page = 0; page < WRITE_BACK_PAGES; ++page) {
+    if (_dirty[page] == 0U) {
+      continue;
+    }
+    if (oldest < 0 ||
+        (_nowMs - _dirtySinceMs[page]) > (_nowMs - _dirtySinceMs[static_cast<uint8_t>(oldest)])) {
+      oldest = static_cast<int8_t>(page);
+    }
+  }
+  return oldest;
+}
+
+}  // namespace AT21CS
@@ -0,0 +1,135 @@
+/// @file WriteScheduler.cpp
+/// @brief Implementation of the interleaved multi-device write scheduler.
+
+#include "AT21CS/WriteScheduler.h"
+
+namespace AT21CS {
+
+Status WriteScheduler::addDevice(Driver* device, uint8_t& deviceIndex) {
+  if (device == nullptr) {
+    return Status::Error(Err::INVALID_PARAM, "device is null");
+  }
+  for (uint8_t i = 0; i < _deviceCount; ++i) {
+    if (_devices[i] == device) {
+      return Status::Error(Err::INVALID_PARAM, "device already registered", i);
+    }
+  }
+  if (_deviceCount >= SCHEDULER_MAX_DEVICES) {
+    return Status::Error(Err::INVALID_STATE, "Scheduler device table full");
+  }
+  deviceIndex = _deviceCount;
+  _devices[_deviceCount] = device;
+  _running[_deviceCount] = false;
+  ++_deviceCount;
+  return Status::Ok();
+}
+
+Status WriteScheduler::submit(uint8_t deviceIndex, uint8_t address, const uint8_t* data,
+                              size_t len) {
+  if (deviceIndex >= _deviceCount) {
+    return Status::Error(Err::INVALID_PARAM, "Unknown device index", deviceIndex);
+  }
+  if (data == nullptr) {
+    return Status::Error(Err::INVALID_PARAM, "EEPROM write buffer is null");
+  }
+  if (len == 0 || static_cast<size_t>(address) >= cmd::EEPROM_SIZE ||
+      len > cmd::EEPROM_SIZE - static_cast<size_t>(address)) {
+    return Status::Error(Err::INVALID_PARAM, "EEPROM write range out of bounds");
+  }
+  if (_jobCount >= SCHEDULER_MAX_JOBS) {
+    return Status::Error(Err::INVALID_STATE, "Scheduler job queue full");
+  }
+
+  _jobs[_jobCount] = Job{deviceIndex, address, data, static_cast<uint8_t>(len)};
+  ++_jobCount;
+  return Status::Ok();
+}
+
+void WriteScheduler::tick(uint32_t nowMs) {
+  // Advance in-flight writes first so lines freed this tick can be reused.
+  for (uint8_t i = 0; i < _deviceCount; ++i) {
+    if (!_running[i]) {
+      continue;
+    }
+    _devices[i]->tick(nowMs);
+    if (!_devices[i]->writeInProgress()) {
+      _finish(i, _devices[i]->writeStatus());
+    }
+  }
+
+  uint8_t slot = 0;
+  while (slot < _jobCount) {
+    const Job job = _jobs[slot];
+    Driver* device = _devices[job.device];
+    if (_pinBusy(device->getConfig().sioPin)) {
+      ++slot;
+      continue;
+    }
+
+    _removeJob(slot);
+    _runningAddress[job.device] = job.address;
+    const Status st = device->startWriteEeprom(job.address, job.data, job.len);
+    if (st.inProgress()) {
+      _running[job.device] = true;
+    } else {
+      _finish(job.device, st);
+    }
+  }
+}
+
+void WriteScheduler::setJobDoneCallback(JobDoneFn callback, void* user) {
+  _jobDone = callback;
+  _jobDoneUser = user;
+}
+
+bool WriteScheduler::lineBusy(uint8_t deviceIndex) const {
+  if (deviceIndex >= _deviceCount) {
+    return false;
+  }
+  return _pinBusy(_devices[deviceIndex]->getConfig().sioPin);
+}
+
+bool WriteScheduler::idle() const {
+  if (_jobCount != 0) {
+    return false;
+  }
+  for (uint8_t i = 0; i < _deviceCount; ++i) {
+    if (_running[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool WriteScheduler::_pinBusy(int sioPin) const {
+  // Also honours writes started directly on a driver, outside the scheduler.
+  for (uint8_t i = 0; i < _deviceCount; ++i) {
+    if (_devices[i]->getConfig().sioPin == sioPin &&
+        (_running[i] || _devices[i]->writeInProgress())) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void WriteScheduler::_finish(uint8_t deviceIndex, const Status& result) {
+  _running[deviceIndex] = false;
+  if (result.ok()) {
+    ++_completedJobs;
+  } else {
+    ++_failedJobs;
+    _lastError = result;
+  }
+  if (_jobDone != nullptr) {
+    _jobDone(deviceIndex, _runningAddress[deviceIndex], result, _jobDoneUser);
+  }
+}
+
+void WriteScheduler::_removeJob(uint8_t slot) {
+  for (uint8_t i = slot; (i + 1U) < _jobCount; ++i) {
+    _jobs[i] = _jobs[i + 1U];
+  }
+  --_jobCount;
+}
+
+}  // namespace AT21CS
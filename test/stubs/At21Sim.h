@@ -0,0 +1,514 @@
+/// @file At21Sim.h
+/// @brief Bit-accurate host simulation of an AT21CS01/AT21CS11 on a virtual clock.
+///
+/// Attach to a Driver through Config::lineWrite/lineRead/sleepUs/nowMs. Every
+/// sleep advances a virtual microsecond clock; the model decodes host edges by
+/// their low time exactly like the device (reset, discovery, bit '0'/'1', read
+/// strobes, start/stop by tHTSS idle time) and drives the line low for ACKs,
+/// '0' data bits, and the discovery response.
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#include "AT21CS/Config.h"
+
+namespace at21sim {
+
+enum class Part : uint8_t { AT21CS01, AT21CS11 };
+
+/// @brief Bus-level counters, useful for regression tests and benchmarks.
+struct Stats {
+  uint32_t resets = 0;           ///< Reset pulses (low >= RESET_LOW_US).
+  uint32_t discoveries = 0;      ///< Discovery responses driven.
+  uint32_t frames = 0;           ///< Start conditions (idle >= STOP_GAP_US, then low).
+  uint32_t bytesIn = 0;          ///< Bytes shifted in from the host.
+  uint32_t bytesOut = 0;         ///< Bytes shifted out to the host.
+  uint32_t nacks = 0;            ///< Bytes NACKed (including busy NACKs).
+  uint32_t busyNacks = 0;        ///< Device-address NACKs during t_WR.
+  uint32_t writeCycles = 0;      ///< Committed write cycles.
+  uint32_t timingViolations = 0; ///< Bit low times outside t_LOW0/t_LOW1, samples after t_MRS.
+};
+
+class Device {
+ public:
+  static constexpr uint32_t STOP_GAP_US = 100;
+  static constexpr uint32_t RESET_LOW_US = 96;
+  static constexpr uint32_t DISCOVERY_HOLD_US = 4;
+
+  Device() { powerOn(); }
+
+  /// @brief Restore factory contents and power-up state.
+  void powerOn() {
+    std::memset(_eeprom, 0xFF, sizeof(_eeprom));
+    std::memset(_security, 0xFF, sizeof(_security));
+    _security[0] = 0xA0;
+    for (uint8_t i = 1; i < 7; ++i) {
+      _security[i] = static_cast<uint8_t>(0x10 + i);
+    }
+    _security[7] = crc8(_security, 7);
+    _romZones = 0;
+    _frozen = false;
+    _locked = false;
+    _highSpeed = true;
+    _discovered = false;
+    _phase = Phase::IDLE;
+    _busyUntil = 0;
+    _frameOpen = false;
+    stats = Stats{};
+  }
+
+  /// @brief Route a driver's PHY and timing through this model.
+  void attach(AT21CS::Config& cfg) {
+    cfg.lineWrite = &Device::lineWrite;
+    cfg.lineRead = &Device::lineRead;
+    cfg.lineUser = this;
+    cfg.sleepUs = &Device::sleepUs;
+    cfg.nowMs = &Device::nowMs;
+    cfg.timeUser = this;
+    if (cfg.sioPin < 0) {
+      cfg.sioPin = 0;
+    }
+  }
+
+  static void lineWrite(bool low, void* user) { static_cast<Device*>(user)->_drive(low); }
+  static bool lineRead(void* user) { return static_cast<Device*>(user)->_sample(); }
+  static void sleepUs(uint32_t us, void* user) { static_cast<Device*>(user)->advance(us); }
+  static uint32_t nowMs(void* user) {
+    return static_cast<uint32_t>(static_cast<Device*>(user)->_now / 1000U);
+  }
+
+  /// @brief Advance the virtual clock.
+  void advance(uint32_t us) {
+    _now += us;
+    _pollStop();
+  }
+
+  /// @return Current line level (true = HIGH).
+  bool level() const { return !_hostLow && _now >= _deviceLowUntil; }
+
+  uint64_t nowUs() const { return _now; }
+  bool busy() const { return _now < _busyUntil; }
+  bool highSpeed() const { return _highSpeed; }
+
+  uint8_t* eeprom() { return _eeprom; }
+  uint8_t* security() { return _security; }
+  bool zoneRom(uint8_t zone) const { return (_romZones & (1U << zone)) != 0U; }
+  bool locked() const { return _locked; }
+  bool frozen() const { return _frozen; }
+
+  Part part = Part::AT21CS01;
+  uint8_t addressBits = 0;
+  uint32_t writeCycleUs = 3000;
+  bool present = true;
+  int16_t wornAddress = -1;   ///< EEPROM byte with worn cells, or -1.
+  uint8_t stuckHighBits = 0;  ///< Bits of wornAddress that stay 1 after a write.
+  Stats stats;
+
+  static uint8_t crc8(const uint8_t* data, size_t len) {
+    uint8_t crc = 0;
+    for (size_t i = 0; i < len; ++i) {
+      crc ^= data[i];
+      for (uint8_t bit = 0; bit < 8; ++bit) {
+        crc = (crc & 0x01U) ? static_cast<uint8_t>((crc >> 1) ^ 0x8CU)
+                            : static_cast<uint8_t>(crc >> 1);
+      }
+    }
+    return crc;
+  }
+
+ private:
+  enum class Phase : uint8_t { IDLE, AWAIT_DISCOVERY, RX, TX, IGNORE };
+  enum class Pending : uint8_t { NONE, DATA, ROM_ZONE, FREEZE, LOCK, STANDARD, HIGH };
+
+  // A '0' or ACK is held for the shortest t_HLD0 the datasheet allows, which
+  // is also t_MRS: a host sampling later than that reads a '1'.
+  uint32_t _holdUs() const { return _highSpeed ? 2U : 8U; }
+
+  void _holdLow() {
+    // The line is still low when sampled exactly at the end of the hold.
+    _deviceLowUntil = _now + _holdUs() + 1U;
+  }
+
+  bool _sample() {
+    if (_readSlot && !_hostLow) {
+      _readSlot = false;
+      if (_now - _lastFall > _holdUs()) {
+        ++stats.timingViolations;
+      }
+    }
+    return level();
+  }
+
+  void _drive(bool low) {
+    if (low == _hostLow) {
+      return;
+    }
+    _hostLow = low;
+    if (low) {
+      const uint64_t idle = _now - _lastRise;
+      _lastFall = _now;
+      _readSlot = false;
+      if (present) {
+        _onFall(idle);
+      }
+    } else {
+      _lastRise = _now;
+      if (present) {
+        _onRise(static_cast<uint32_t>(_now - _lastFall));
+      }
+    }
+  }
+
+  void _pollStop() {
+    if (_frameOpen && !_hostLow && (_now - _lastRise) >= STOP_GAP_US) {
+      _endFrame(_lastRise + STOP_GAP_US);
+    }
+  }
+
+  void _onFall(uint64_t idleUs) {
+    if (_phase == Phase::AWAIT_DISCOVERY) {
+      if (++_discoveryPulses == 2U) {
+        _deviceLowUntil = _now + DISCOVERY_HOLD_US;
+        _discovered = true;
+        _phase = Phase::IDLE;
+        ++stats.discoveries;
+      }
+      return;
+    }
+
+    if (idleUs >= STOP_GAP_US) {
+      if (_frameOpen) {
+        _endFrame(_lastRise + STOP_GAP_US);
+      }
+      ++stats.frames;
+      _frameOpen = true;
+      _pending = Pending::NONE;
+      _pendingCount = 0;
+      _byteIndex = 0;
+      _slot = 0;
+      _shift = 0;
+      _phase = _discovered ? Phase::RX : Phase::IGNORE;
+    }
+
+    if (_phase == Phase::RX && _slot == 8U) {
+      const bool ack = _onByte(_shift);
+      ++stats.bytesIn;
+      _readSlot = true;
+      if (ack) {
+        _holdLow();
+      } else {
+        ++stats.nacks;
+      }
+    } else if (_phase == Phase::TX && _slot < 8U) {
+      _readSlot = true;
+      if (((_txByte >> (7U - _slot)) & 0x01U) == 0U) {
+        _holdLow();
+      }
+    }
+  }
+
+  void _onRise(uint32_t lowUs) {
+    if (lowUs >= RESET_LOW_US) {
+      // Reset aborts any frame without committing it.
+      ++stats.resets;
+      _frameOpen = false;
+      _highSpeed = true;
+      _discoveryPulses = 0;
+      _phase = Phase::AWAIT_DISCOVERY;
+      return;
+    }
+
+    switch (_phase) {
+      case Phase::RX:
+        if (_slot < 8U) {
+          _shift = static_cast<uint8_t>((_shift << 1) | (_classify(lowUs) ? 1U : 0U));
+          ++_slot;
+        } else {
+          _slot = 0;
+          _shift = 0;
+          ++_byteIndex;
+          if (_afterAck != Phase::RX) {
+            _phase = _afterAck;
+            if (_phase == Phase::TX) {
+              _loadTx();
+            }
+          }
+        }
+        break;
+      case Phase::TX:
+        if (_slot < 8U) {
+          ++_slot;
+        } else if (!_classify(lowUs)) {
+          _loadTx();
+        } else {
+          _phase = Phase::IGNORE;
+        }
+        break;
+      default:
+        break;
+    }
+  }
+
+  bool _classify(uint32_t lowUs) {
+    const uint32_t max1 = _highSpeed ? 2U : 8U;
+    const uint32_t min0 = _highSpeed ? 6U : 24U;
+    if (lowUs > max1 && lowUs < min0) {
+      ++stats.timingViolations;
+    }
+    return lowUs < (_highSpeed ? 4U : 16U);
+  }
+
+  bool _nack() {
+    _afterAck = Phase::IGNORE;
+    return false;
+  }
+
+  bool _ackThen(Phase next) {
+    _afterAck = next;
+    return true;
+  }
+
+  bool _onByte(uint8_t value) {
+    if (_byteIndex == 0U) {
+      _opcode = static_cast<uint8_t>(value >> 4);
+      const bool read = (value & 0x01U) != 0U;
+      if (((value >> 1) & 0x07U) != addressBits) {
+        return _nack();
+      }
+      if (busy()) {
+        ++stats.busyNacks;
+        return _nack();
+      }
+      switch (_opcode) {
+        case 0x0A:
+        case 0x0B:
+        case 0x07:
+          return _ackThen(read ? Phase::TX : Phase::RX);
+        case 0x0C:
+          _mfrIndex = 0;
+          return read ? _ackThen(Phase::TX) : _nack();
+        case 0x0D:
+          if (part == Part::AT21CS11) {
+            return _nack();
+          }
+          if (read) {
+            return _highSpeed ? _nack() : _ackThen(Phase::IGNORE);
+          }
+          _pending = Pending::STANDARD;
+          return _ackThen(Phase::IGNORE);
+        case 0x0E:
+          if (read) {
+            return _highSpeed ? _ackThen(Phase::IGNORE) : _nack();
+          }
+          _pending = Pending::HIGH;
+          return _ackThen(Phase::IGNORE);
+        case 0x01:
+          if (read) {
+            return _frozen ? _nack() : _ackThen(Phase::IGNORE);
+          }
+          return _frozen ? _nack() : _ackThen(Phase::RX);
+        case 0x02:
+          if (read) {
+            return _locked ? _nack() : _ackThen(Phase::IGNORE);
+          }
+          return _locked ? _nack() : _ackThen(Phase::RX);
+        default:
+          return _nack();
+      }
+    }
+
+    if (_byteIndex == 1U) {
+      switch (_opcode) {
+        case 0x0A:
+          _pointer = static_cast<uint8_t>(value & 0x7FU);
+          return _ackThen(Phase::RX);
+        case 0x0B:
+          _pointer = static_cast<uint8_t>(value & 0x1FU);
+          return _ackThen(Phase::RX);
+        case 0x07:
+          if (value != 0x01 && value != 0x02 && value != 0x04 && value != 0x08) {
+            return _nack();
+          }
+          _romRegister = value;
+          return _frozen ? _ackThen(Phase::IGNORE) : _ackThen(Phase::RX);
+        case 0x01:
+          return (value == 0x55) ? _ackThen(Phase::RX) : _nack();
+        case 0x02:
+          return (value == 0x60) ? _ackThen(Phase::RX) : _nack();
+        default:
+          return _nack();
+      }
+    }
+
+    switch (_opcode) {
+      case 0x0A:
+        if (zoneRom(static_cast<uint8_t>(_pointer / 32U))) {
+          return _nack();
+        }
+        _bufferData(value);
+        return _ackThen(Phase::RX);
+      case 0x0B:
+        if (_locked || _pointer < 0x10U) {
+          return _nack();
+        }
+        _bufferData(value);
+        return _ackThen(Phase::RX);
+      case 0x07:
+        if (_byteIndex != 2U || value != 0xFF) {
+          return _nack();
+        }
+        _pending = Pending::ROM_ZONE;
+        return _ackThen(Phase::IGNORE);
+      case 0x01:
+        if (_byteIndex != 2U || value != 0xAA) {
+          return _nack();
+        }
+        _pending = Pending::FREEZE;
+        return _ackThen(Phase::IGNORE);
+      case 0x02:
+        if (_byteIndex != 2U) {
+          return _nack();
+        }
+        _pending = Pending::LOCK;
+        return _ackThen(Phase::IGNORE);
+      default:
+        return _nack();
+    }
+  }
+
+  void _bufferData(uint8_t value) {
+    // Page writes roll over within the addressed 8-byte page.
+    if (_pending != Pending::DATA) {
+      _pending = Pending::DATA;
+      _pendingBase = static_cast<uint8_t>(_pointer & ~0x07U);
+      _pendingOffset = static_cast<uint8_t>(_pointer & 0x07U);
+      _pendingCount = 0;
+      _pendingMask = 0;
+    }
+    const uint8_t slot = static_cast<uint8_t>((_pendingOffset + _pendingCount) & 0x07U);
+    _pendingData[slot] = value;
+    _pendingMask = static_cast<uint8_t>(_pendingMask | (1U << slot));
+    ++_pendingCount;
+    _pointer = static_cast<uint8_t>(_pendingBase + ((slot + 1U) & 0x07U));
+  }
+
+  void _loadTx() {
+    ++stats.bytesOut;
+    _slot = 0;
+    switch (_opcode) {
+      case 0x0A:
+        _txByte = _eeprom[_pointer & 0x7FU];
+        _pointer = static_cast<uint8_t>((_pointer + 1U) & 0x7FU);
+        break;
+      case 0x0B:
+        _txByte = _security[_pointer & 0x1FU];
+        _pointer = static_cast<uint8_t>((_pointer + 1U) & 0x1FU);
+        break;
+      case 0x07: {
+        uint8_t zone = 0;
+        while (zone < 4U && (1U << zone) != _romRegister) {
+          ++zone;
+        }
+        _txByte = (zone < 4U && zoneRom(zone)) ? 0xFF : 0x00;
+        break;
+      }
+      case 0x0C: {
+        const uint32_t id = (part == Part::AT21CS11) ? 0x00D380U : 0x00D200U;
+        _txByte = static_cast<uint8_t>(id >> (8U * (2U - (_mfrIndex % 3U))));
+        ++_mfrIndex;
+        break;
+      }
+      default:
+        _txByte = 0xFF;
+        break;
+    }
+  }
+
+  void _endFrame(uint64_t stopUs) {
+    _frameOpen = false;
+    _phase = Phase::IDLE;
+    bool cycle = true;
+    switch (_pending) {
+      case Pending::DATA: {
+        uint8_t* mem = (_opcode == 0x0A) ? _eeprom : _security;
+        for (uint8_t slot = 0; slot < 8U; ++slot) {
+          if ((_pendingMask & (1U << slot)) != 0U) {
+            mem[_pendingBase + slot] = _pendingData[slot];
+            if (mem == _eeprom && _pendingBase + slot == wornAddress) {
+              mem[_pendingBase + slot] = static_cast<uint8_t>(_pendingData[slot] | stuckHighBits);
+            }
+          }
+        }
+        break;
+      }
+      case Pending::ROM_ZONE:
+        for (uint8_t zone = 0; zone < 4U; ++zone) {
+          if ((1U << zone) == _romRegister) {
+            _romZones = static_cast<uint8_t>(_romZones | (1U << zone));
+          }
+        }
+        break;
+      case Pending::FREEZE:
+        _frozen = true;
+        break;
+      case Pending::LOCK:
+        _locked = true;
+        break;
+      case Pending::STANDARD:
+        _highSpeed = false;
+        cycle = false;
+        break;
+      case Pending::HIGH:
+        _highSpeed = true;
+        cycle = false;
+        break;
+      case Pending::NONE:
+        cycle = false;
+        break;
+    }
+    _pending = Pending::NONE;
+    if (cycle) {
+      _busyUntil = stopUs + writeCycleUs;
+      ++stats.writeCycles;
+    }
+  }
+
+  uint8_t _eeprom[128] = {};
+  uint8_t _security[32] = {};
+  uint8_t _romZones = 0;
+  bool _frozen = false;
+  bool _locked = false;
+  bool _highSpeed = true;
+  bool _discovered = false;
+
+  uint64_t _now = 0;
+  uint64_t _lastFall = 0;
+  uint64_t _lastRise = 0;
+  uint64_t _deviceLowUntil = 0;
+  uint64_t _busyUntil = 0;
+  bool _hostLow = false;
+  bool _readSlot = false;  // Current slot is an ACK or data bit the host samples.
+
+  Phase _phase = Phase::IDLE;
+  Phase _afterAck = Phase::IGNORE;
+  bool _frameOpen = false;
+  uint8_t _discoveryPulses = 0;
+  uint8_t _slot = 0;
+  uint8_t _shift = 0;
+  uint8_t _byteIndex = 0;
+  uint8_t _opcode = 0;
+  uint8_t _txByte = 0;
+  uint8_t _mfrIndex = 0;
+  uint8_t _pointer = 0;
+  uint8_t _romRegister = 0;
+
+  Pending _pending = Pending::NONE;
+  uint8_t _pendingData[8] = {};
+  uint8_t _pendingBase = 0;
+  uint8_t _pendingOffset = 0;
+  uint8_t _pendingCount = 0;
+  uint8_t _pendingMask = 0;
+};
+
+}  // namespace at21sim
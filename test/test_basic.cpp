@@ -1,5 +1,5 @@
 /// @file test_basic.cpp
-/// @brief Native contract tests for AT21CS lifecycle and validation behavior.
+/// @brief Native contract tests for AT21CS lifecycle, validation, and protocol behavior.
 
 #include <unity.h>
 
@@ -10,8 +10,17 @@ SerialClass Serial;
 TwoWire Wire;
 
 #include "AT21CS/AT21CS.h"
+#include "AT21CS/BasicDriver.h"
+#include "AT21CS/Batch.h"
 #include "AT21CS/Config.h"
+#include "AT21CS/Crc.h"
+#include "AT21CS/MultiLane.h"
 #include "AT21CS/Status.h"
+#include "AT21CS/Waveform.h"
+#include "AT21CS/WriteBackCache.h"
+#include "AT21CS/WriteScheduler.h"
+#include "At21Sim.h"
+#include "common/LoadCellMap.h"
 
 using namespace AT21CS;
 
@@ -32,12 +41,41 @@ void test_status_error() {
   TEST_ASSERT_EQUAL_INT32(7, st.detail);
 }
 
+void test_status_in_progress() {
+  Status st = Status::Error(Err::IN_PROGRESS, "running");
+  TEST_ASSERT_FALSE(st.ok());
+  TEST_ASSERT_TRUE(st.inProgress());
+  TEST_ASSERT_FALSE(Status::Ok().inProgress());
+}
+
+void test_crc_engines_match_check_values() {
+  static const uint8_t check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+  TEST_ASSERT_EQUAL_HEX32(0xCBF43926u, AT21CS::crc::crc32(check, sizeof(check)));
+  TEST_ASSERT_EQUAL_UINT16(0x29B1U, AT21CS::crc::crc16Ccitt(check, sizeof(check)));
+  TEST_ASSERT_EQUAL_HEX8(0xA1U, AT21CS::crc::crc8_31(check, sizeof(check)));
+  TEST_ASSERT_EQUAL_HEX8(0xA1U, Driver::crc8_31(check, sizeof(check)));
+
+  // Incremental updates across an unaligned split match one pass.
+  uint32_t state = AT21CS::crc::crc32Update(AT21CS::crc::CRC32_INIT, check, 3);
+  state = AT21CS::crc::crc32Update(state, &check[3], sizeof(check) - 3U);
+  TEST_ASSERT_EQUAL_HEX32(0xCBF43926u, AT21CS::crc::crc32Final(state));
+  TEST_ASSERT_EQUAL_HEX32(
+      AT21CS::crc::crc32UpdateBitwise(AT21CS::crc::CRC32_INIT, &check[1], 8),
+      AT21CS::crc::crc32UpdateSlice4(AT21CS::crc::CRC32_INIT, &check[1], 8));
+}
+
 void test_config_defaults() {
   Config cfg;
   TEST_ASSERT_EQUAL_INT16(-1, cfg.sioPin);
   TEST_ASSERT_EQUAL_INT16(-1, cfg.presencePin);
   TEST_ASSERT_EQUAL_UINT8(0, cfg.addressBits);
   TEST_ASSERT_EQUAL_UINT8(5, cfg.offlineThreshold);
+  TEST_ASSERT_FALSE(cfg.persistentSession);
+  TEST_ASSERT_EQUAL_UINT32(1000u, cfg.sessionIdleTimeoutMs);
+  TEST_ASSERT_FALSE(cfg.shadowCache);
+  TEST_ASSERT_FALSE(cfg.adaptiveWritePolling);
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(AT21CS::CriticalSection::PER_BYTE),
+                          static_cast<uint8_t>(cfg.criticalSection));
 }
 
 void test_begin_rejects_missing_sio_pin() {
@@ -149,6 +187,1568 @@ void test_multi_page_write_helpers_check_initialization_first() {
   st = dev.writeSecurityUser(0x10, &data, 0);
   TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(Err::NOT_INITIALIZED),
                           static_cast<uint8_t>(st.code));
+
+  uint8_t skipped = 0xFF;
+  st = dev.writeEepromIfChanged(0, nullptr, 1, skipped);
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(Err::NOT_INITIALIZED),
+                          static_cast<uint8_t>(st.code));
+  TEST_ASSERT_EQUAL_UINT8(0u, skipped);
+}
+
+void test_failed_begin_leaves_no_session() {
+  Driver dev;
+  Config cfg;
+  cfg.sioPin = 6;
+  cfg.persistentSession = true;
+  Status st = dev.begin(cfg);
+  TEST_ASSERT_FALSE(st.ok());
+  TEST_ASSERT_FALSE(dev.sessionActive());
+  TEST_ASSERT_FALSE(dev.getSettings().sessionActive);
+}
+
+void test_fill_shadow_cache_requires_begin() {
+  Driver dev;
+  Status st = dev.fillShadowCache();
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(Err::NOT_INITIALIZED),
+                          static_cast<uint8_t>(st.code));
+  TEST_ASSERT_EQUAL_UINT16(0u, dev.getSettings().shadowEepromValid);
+  TEST_ASSERT_EQUAL_UINT8(0u, dev.getSettings().shadowSecurityValid);
+}
+
+void test_start_write_requires_begin() {
+  Driver dev;
+  uint8_t data[4] = {1, 2, 3, 4};
+  Status st = dev.startWriteEeprom(0, data, sizeof(data));
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(Err::NOT_INITIALIZED),
+                          static_cast<uint8_t>(st.code));
+  TEST_ASSERT_FALSE(dev.writeInProgress());
+  TEST_ASSERT_TRUE(dev.writeStatus().ok());
+}
+
+void test_lane_group_validates_config() {
+  LaneGroup group;
+  LaneGroupConfig cfg;
+  Status st = group.begin(cfg);
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(Err::INVALID_CONFIG),
+                          static_cast<uint8_t>(st.code));
+
+  cfg.laneCount = 2;
+  cfg.sioPins[0] = 6;
+  cfg.sioPins[1] = 40;
+  st = group.begin(cfg);
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(Err::INVALID_CONFIG),
+                          static_cast<uint8_t>(st.code));
+  TEST_ASSERT_EQUAL_INT32(1, st.detail);
+
+  cfg.sioPins[1] = 6;
+  st = group.begin(cfg);
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(Err::INVALID_CONFIG),
+                          static_cast<uint8_t>(st.code));
+  TEST_ASSERT_FALSE(group.isInitialized());
+
+  uint8_t data[2] = {};
+  uint8_t okMask = 0xFF;
+  st = group.readEeprom(0, data, 1, okMask);
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(Err::NOT_INITIALIZED),
+                          static_cast<uint8_t>(st.code));
+  TEST_ASSERT_EQUAL_UINT8(0u, okMask);
+}
+
+void test_lane_group_reports_absent_lanes() {
+  LaneGroup group;
+  LaneGroupConfig cfg;
+  cfg.laneCount = 2;
+  cfg.sioPins[0] = 6;
+  cfg.sioPins[1] = 10;
+  TEST_ASSERT_TRUE(group.begin(cfg).ok());
+  TEST_ASSERT_EQUAL_UINT8(0u, group.presentMask());
+
+  uint8_t data[2 * 4] = {};
+  uint8_t okMask = 0xFF;
+  Status st = group.readEeprom(0x7E, data, 4, okMask);
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(Err::INVALID_PARAM),
+                          static_cast<uint8_t>(st.code));
+
+  st = group.readEeprom(0, data, 4, okMask);
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(Err::IO_ERROR),
+                          static_cast<uint8_t>(st.code));
+  TEST_ASSERT_EQUAL_INT32(0x03, st.detail);
+  TEST_ASSERT_EQUAL_UINT8(0u, okMask);
+
+  st = group.writeEepromPage(6, data, 4, 0, okMask);
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(Err::INVALID_PARAM),
+                          static_cast<uint8_t>(st.code));
+  group.end();
+  TEST_ASSERT_FALSE(group.isInitialized());
+}
+
+// Two simulated lanes on one virtual clock: every sleep advances both.
+struct SimLanes {
+  at21sim::Device lane[2];
+
+  static void sleepUs(uint32_t us, void* user) {
+    SimLanes* lanes = static_cast<SimLanes*>(user);
+    lanes->lane[0].advance(us);
+    lanes->lane[1].advance(us);
+  }
+
+  static uint32_t nowMs(void* user) {
+    return at21sim::Device::nowMs(&static_cast<SimLanes*>(user)->lane[0]);
+  }
+
+  void attach(LaneGroupConfig& cfg) {
+    cfg.laneCount = 2;
+    cfg.sioPins[0] = 6;
+    cfg.sioPins[1] = 10;
+    cfg.addressBits[0] = lane[0].addressBits;
+    cfg.addressBits[1] = lane[1].addressBits;
+    cfg.lineWrite = &at21sim::Device::lineWrite;
+    cfg.lineRead = &at21sim::Device::lineRead;
+    cfg.lineUser[0] = &lane[0];
+    cfg.lineUser[1] = &lane[1];
+    cfg.sleepUs = &SimLanes::sleepUs;
+    cfg.nowMs = &SimLanes::nowMs;
+    cfg.timeUser = this;
+  }
+};
+
+void test_lane_group_sim_parallel_read_write() {
+  SimLanes sim;
+  sim.lane[1].addressBits = 3;
+  sim.lane[1].part = at21sim::Part::AT21CS11;
+  for (uint8_t i = 0; i < 8U; ++i) {
+    sim.lane[0].eeprom()[0x10 + i] = static_cast<uint8_t>(0xA0 + i);
+    sim.lane[1].eeprom()[0x10 + i] = static_cast<uint8_t>(0x35 ^ (i * 0x11U));
+  }
+
+  LaneGroupConfig cfg;
+  sim.attach(cfg);
+  cfg.lineRead = nullptr;
+  LaneGroup group;
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(Err::INVALID_CONFIG),
+                          static_cast<uint8_t>(group.begin(cfg).code));
+  sim.attach(cfg);
+  TEST_ASSERT_TRUE(group.begin(cfg).ok());
+  TEST_ASSERT_EQUAL_UINT8(0x03u, group.presentMask());
+
+  // Parallel read: distinct bytes per lane land lane-major.
+  uint8_t data[2 * 5] = {};
+  uint8_t okMask = 0;
+  TEST_ASSERT_TRUE(group.readEeprom(0x11, data, 5, okMask).ok());
+  TEST_ASSERT_EQUAL_UINT8(0x03u, okMask);
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(sim.lane[0].eeprom() + 0x11, data, 5);
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(sim.lane[1].eeprom() + 0x11, data + 5, 5);
+
+  uint32_t ids[MAX_LANES] = {};
+  TEST_ASSERT_TRUE(group.readManufacturerId(ids, okMask).ok());
+  TEST_ASSERT_EQUAL_HEX32(0x00D200u, ids[0]);
+  TEST_ASSERT_EQUAL_HEX32(0x00D380u, ids[1]);
+
+  // Transposed page write: each lane gets its own bytes, both cycles in one poll.
+  const uint8_t page[2 * 4] = {0x01, 0x80, 0x7F, 0xFE, 0x55, 0xAA, 0x00, 0xC3};
+  TEST_ASSERT_TRUE(group.writeEepromPage(0x22, page, 4, 4, okMask).ok());
+  TEST_ASSERT_EQUAL_UINT8(0x03u, okMask);
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(page, sim.lane[0].eeprom() + 0x22, 4);
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(page + 4, sim.lane[1].eeprom() + 0x22, 4);
+  TEST_ASSERT_EQUAL_UINT32(1u, sim.lane[0].stats.writeCycles);
+  TEST_ASSERT_EQUAL_UINT32(1u, sim.lane[1].stats.writeCycles);
+  TEST_ASSERT_FALSE(sim.lane[0].busy());
+  TEST_ASSERT_FALSE(sim.lane[1].busy());
+
+  TEST_ASSERT_EQUAL_UINT32(0u, sim.lane[0].stats.timingViolations);
+  TEST_ASSERT_EQUAL_UINT32(0u, sim.lane[1].stats.timingViolations);
+}
+
+void test_lane_group_sim_per_lane_ack_masks() {
+  SimLanes sim;
+  sim.lane[0].eeprom()[0x40] = 0x5A;
+  LaneGroupConfig cfg;
+  sim.attach(cfg);
+  LaneGroup group;
+  TEST_ASSERT_TRUE(group.begin(cfg).ok());
+
+  // Lane 1 answers discovery but NACKs its device address.
+  sim.lane[1].addressBits = 5;
+  uint8_t data[2] = {0xEE, 0xEE};
+  uint8_t okMask = 0;
+  Status st = group.readEeprom(0x40, data, 1, okMask);
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(Err::IO_ERROR),
+                          static_cast<uint8_t>(st.code));
+  TEST_ASSERT_EQUAL_INT32(0x02, st.detail);
+  TEST_ASSERT_EQUAL_UINT8(0x01u, okMask);
+  TEST_ASSERT_EQUAL_UINT8(0x03u, group.presentMask());
+  TEST_ASSERT_EQUAL_HEX8(0x5A, data[0]);
+  TEST_ASSERT_EQUAL_UINT32(1u, sim.lane[1].stats.nacks);
+
+  // A dropped lane is left alone for the rest of the write.
+  const uint8_t value = 0x42;
+  st = group.writeEepromPage(0x08, &value, 1, 0, okMask);
+  TEST_ASSERT_EQUAL_INT32(0x02, st.detail);
+  TEST_ASSERT_EQUAL_UINT8(0x01u, okMask);
+  TEST_ASSERT_EQUAL_HEX8(0x42, sim.lane[0].eeprom()[0x08]);
+  TEST_ASSERT_EQUAL_HEX8(0xFF, sim.lane[1].eeprom()[0x08]);
+  TEST_ASSERT_EQUAL_UINT32(0u, sim.lane[1].stats.writeCycles);
+
+  // An absent lane misses discovery and drops out of presentMask.
+  sim.lane[1].addressBits = 0;
+  sim.lane[1].present = false;
+  uint8_t present = 0;
+  st = group.resetAndDiscover(present);
+  TEST_ASSERT_EQUAL_INT32(0x02, st.detail);
+  TEST_ASSERT_EQUAL_UINT8(0x01u, present);
+}
+
+static uint8_t g_jobDoneCount = 0;
+static Err g_jobDoneCode = Err::OK;
+
+static void recordJobDone(uint8_t, uint8_t, const Status& result, void*) {
+  ++g_jobDoneCount;
+  g_jobDoneCode = result.code;
+}
+
+void test_write_scheduler_reports_failed_jobs() {
+  WriteScheduler sched;
+  Driver devA;
+  Driver devB;
+  uint8_t a = 0xFF;
+  uint8_t b = 0xFF;
+  uint8_t data[10] = {};
+
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(Err::INVALID_PARAM),
+                          static_cast<uint8_t>(sched.addDevice(nullptr, a).code));
+  TEST_ASSERT_TRUE(sched.addDevice(&devA, a).ok());
+  TEST_ASSERT_TRUE(sched.addDevice(&devB, b).ok());
+  TEST_ASSERT_EQUAL_UINT8(1u, b);
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(Err::INVALID_PARAM),
+                          static_cast<uint8_t>(sched.submit(2, 0, data, 1).code));
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(Err::INVALID_PARAM),
+                          static_cast<uint8_t>(sched.submit(a, 0x7A, data, 10).code));
+
+  g_jobDoneCount = 0;
+  sched.setJobDoneCallback(recordJobDone, nullptr);
+  TEST_ASSERT_TRUE(sched.submit(a, 0x00, data, sizeof(data)).ok());
+  TEST_ASSERT_TRUE(sched.submit(b, 0x08, data, 4).ok());
+  TEST_ASSERT_EQUAL_UINT8(2u, sched.pendingJobs());
+  TEST_ASSERT_FALSE(sched.idle());
+
+  sched.tick(0);
+  TEST_ASSERT_TRUE(sched.idle());
+  TEST_ASSERT_EQUAL_UINT8(2u, g_jobDoneCount);
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(Err::NOT_INITIALIZED),
+                          static_cast<uint8_t>(g_jobDoneCode));
+  TEST_ASSERT_EQUAL_UINT32(2u, sched.failedJobs());
+  TEST_ASSERT_EQUAL_UINT32(0u, sched.completedJobs());
+}
+
+// One open-drain SI/O line shared by both simulated devices (wired-AND).
+struct SharedLine {
+  at21sim::Device* dev[2];
+
+  static void lineWrite(bool low, void* user) {
+    SharedLine* line = static_cast<SharedLine*>(user);
+    at21sim::Device::lineWrite(low, line->dev[0]);
+    at21sim::Device::lineWrite(low, line->dev[1]);
+  }
+
+  static bool lineRead(void* user) {
+    SharedLine* line = static_cast<SharedLine*>(user);
+    const bool first = at21sim::Device::lineRead(line->dev[0]);
+    const bool second = at21sim::Device::lineRead(line->dev[1]);
+    return first && second;
+  }
+};
+
+// Drivers for both lanes of sim on one virtual clock; sharedLine puts both on one pin.
+static void beginSimPair(Driver& devA, Driver& devB, SimLanes& sim, SharedLine* sharedLine) {
+  Config cfg[2];
+  for (uint8_t i = 0; i < 2U; ++i) {
+    sim.lane[i].attach(cfg[i]);
+    cfg[i].sioPin = (sharedLine != nullptr) ? 4 : 4 + i;
+    cfg[i].addressBits = sim.lane[i].addressBits;
+    cfg[i].sleepUs = &SimLanes::sleepUs;
+    cfg[i].nowMs = &SimLanes::nowMs;
+    cfg[i].timeUser = &sim;
+    if (sharedLine != nullptr) {
+      cfg[i].lineWrite = &SharedLine::lineWrite;
+      cfg[i].lineRead = &SharedLine::lineRead;
+      cfg[i].lineUser = sharedLine;
+    }
+  }
+  TEST_ASSERT_TRUE(devA.begin(cfg[0]).ok());
+  TEST_ASSERT_TRUE(devB.begin(cfg[1]).ok());
+}
+
+void test_write_scheduler_sim_overlaps_separate_lines() {
+  SimLanes sim;
+  // Long cycles, so page bus time (about 1.7 ms each) does not hide the overlap.
+  sim.lane[0].writeCycleUs = 10000;
+  sim.lane[1].writeCycleUs = 10000;
+  Driver devA;
+  Driver devB;
+  beginSimPair(devA, devB, sim, nullptr);
+  WriteScheduler sched;
+  uint8_t a = 0;
+  uint8_t b = 0;
+  TEST_ASSERT_TRUE(sched.addDevice(&devA, a).ok());
+  TEST_ASSERT_TRUE(sched.addDevice(&devB, b).ok());
+
+  uint8_t dataA[16];
+  uint8_t dataB[16];
+  for (uint8_t i = 0; i < 16U; ++i) {
+    dataA[i] = static_cast<uint8_t>(0x10 + i);
+    dataB[i] = static_cast<uint8_t>(0xE0 - i);
+  }
+  TEST_ASSERT_TRUE(sched.submit(a, 0x20, dataA, sizeof(dataA)).ok());
+  TEST_ASSERT_TRUE(sched.submit(b, 0x20, dataB, sizeof(dataB)).ok());
+
+  // Both first pages go out on the first tick: the write cycles run together.
+  const uint64_t startUs = sim.lane[0].nowUs();
+  sched.tick(SimLanes::nowMs(&sim));
+  TEST_ASSERT_EQUAL_UINT8(0u, sched.pendingJobs());
+  TEST_ASSERT_TRUE(sim.lane[0].busy());
+  TEST_ASSERT_TRUE(sim.lane[1].busy());
+  TEST_ASSERT_TRUE(sched.lineBusy(a));
+  TEST_ASSERT_TRUE(sched.lineBusy(b));
+
+  for (uint32_t i = 0; i < 1000U && !sched.idle(); ++i) {
+    SimLanes::sleepUs(100, &sim);
+    sched.tick(SimLanes::nowMs(&sim));
+  }
+  TEST_ASSERT_TRUE(sched.idle());
+
+  // Four page cycles in little more than the time of two (serial: over four).
+  const uint64_t elapsedUs = sim.lane[0].nowUs() - startUs;
+  const uint32_t cycleUs = sim.lane[0].writeCycleUs;
+  TEST_ASSERT_TRUE(elapsedUs < 3U * cycleUs);
+  TEST_ASSERT_EQUAL_UINT32(2u, sched.completedJobs());
+  TEST_ASSERT_EQUAL_UINT32(2u, sim.lane[0].stats.writeCycles);
+  TEST_ASSERT_EQUAL_UINT32(2u, sim.lane[1].stats.writeCycles);
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(dataA, sim.lane[0].eeprom() + 0x20, sizeof(dataA));
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(dataB, sim.lane[1].eeprom() + 0x20, sizeof(dataB));
+}
+
+void test_write_scheduler_sim_serializes_shared_line() {
+  SimLanes sim;
+  sim.lane[1].addressBits = 2;
+  SharedLine line{{&sim.lane[0], &sim.lane[1]}};
+  Driver devA;
+  Driver devB;
+  beginSimPair(devA, devB, sim, &line);
+  WriteScheduler sched;
+  uint8_t a = 0;
+  uint8_t b = 0;
+  TEST_ASSERT_TRUE(sched.addDevice(&devA, a).ok());
+  TEST_ASSERT_TRUE(sched.addDevice(&devB, b).ok());
+
+  const uint8_t dataA[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+  const uint8_t dataB[8] = {9, 10, 11, 12, 13, 14, 15, 16};
+  TEST_ASSERT_TRUE(sched.submit(a, 0x40, dataA, sizeof(dataA)).ok());
+  TEST_ASSERT_TRUE(sched.submit(b, 0x40, dataB, sizeof(dataB)).ok());
+
+  // Only the first device is addressed; the second waits for the line.
+  sched.tick(SimLanes::nowMs(&sim));
+  TEST_ASSERT_EQUAL_UINT8(1u, sched.pendingJobs());
+  TEST_ASSERT_TRUE(sim.lane[0].busy());
+  TEST_ASSERT_EQUAL_UINT32(0u, sim.lane[1].stats.writeCycles);
+  TEST_ASSERT_TRUE(sched.lineBusy(b));
+
+  bool overlapped = false;
+  for (uint32_t i = 0; i < 1000U && !sched.idle(); ++i) {
+    SimLanes::sleepUs(100, &sim);
+    sched.tick(SimLanes::nowMs(&sim));
+    overlapped = overlapped || (sim.lane[0].busy() && sim.lane[1].busy());
+  }
+  TEST_ASSERT_TRUE(sched.idle());
+  TEST_ASSERT_FALSE(overlapped);
+  TEST_ASSERT_EQUAL_UINT32(2u, sched.completedJobs());
+  TEST_ASSERT_EQUAL_UINT32(1u, sim.lane[0].stats.writeCycles);
+  TEST_ASSERT_EQUAL_UINT32(1u, sim.lane[1].stats.writeCycles);
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(dataA, sim.lane[0].eeprom() + 0x40, sizeof(dataA));
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(dataB, sim.lane[1].eeprom() + 0x40, sizeof(dataB));
+  TEST_ASSERT_EQUAL_UINT32(0u, sim.lane[0].stats.timingViolations);
+  TEST_ASSERT_EQUAL_UINT32(0u, sim.lane[1].stats.timingViolations);
+}
+
+static Status beginSim(Driver& dev, at21sim::Device& sim, Config cfg = Config{}) {
+  sim.attach(cfg);
+  return dev.begin(cfg);
+}
+
+void test_begin_rejects_partial_line_backend() {
+  Driver dev;
+  Config cfg;
+  cfg.sioPin = 6;
+  cfg.lineWrite = at21sim::Device::lineWrite;
+  Status st = dev.begin(cfg);
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(Err::INVALID_CONFIG),
+                          static_cast<uint8_t>(st.code));
+}
+
+void test_sim_begin_detects_part_and_serial() {
+  at21sim::Device sim;
+  sim.part = at21sim::Part::AT21CS11;
+  sim.addressBits = 3;
+  Driver dev;
+  Config cfg;
+  cfg.addressBits = 3;
+  TEST_ASSERT_TRUE(beginSim(dev, sim, cfg).ok());
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(PartType::AT21CS11),
+                          static_cast<uint8_t>(dev.getSettings().detectedPart));
+
+  SerialNumberInfo serial;
+  TEST_ASSERT_TRUE(dev.readSerialNumber(serial).ok());
+  TEST_ASSERT_TRUE(serial.crcOk);
+  TEST_ASSERT_EQUAL_UINT32(0u, sim.stats.timingViolations);
+
+  at21sim::Device absent;
+  absent.present = false;
+  Driver missing;
+  Status st = beginSim(missing, absent);
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(Err::NOT_PRESENT),
+                          static_cast<uint8_t>(st.code));
+}
+
+void test_sim_eeprom_round_trip_and_busy_nacks() {
+  at21sim::Device sim;
+  Driver dev;
+  TEST_ASSERT_TRUE(beginSim(dev, sim).ok());
+
+  uint8_t data[13];
+  for (uint8_t i = 0; i < sizeof(data); ++i) {
+    data[i] = static_cast<uint8_t>(0xA0 + i);
+  }
+  TEST_ASSERT_TRUE(dev.writeEeprom(0x05, data, sizeof(data)).ok());
+  TEST_ASSERT_EQUAL_MEMORY(data, sim.eeprom() + 0x05, sizeof(data));
+  TEST_ASSERT_EQUAL_UINT32(3u, sim.stats.writeCycles);
+  TEST_ASSERT_TRUE(sim.stats.busyNacks > 0u);
+
+  const WriteCycleStats wc = dev.getSettings().writeCycle;
+  TEST_ASSERT_EQUAL_UINT32(3u, wc.samples);
+  TEST_ASSERT_TRUE(wc.lastUs >= sim.writeCycleUs);
+
+  uint8_t back[sizeof(data)] = {};
+  TEST_ASSERT_TRUE(dev.readEeprom(0x05, back, sizeof(back)).ok());
+  TEST_ASSERT_EQUAL_MEMORY(data, back, sizeof(data));
+
+  // The device pointer now sits after the last byte read.
+  uint8_t next = 0;
+  sim.eeprom()[0x12] = 0x5A;
+  TEST_ASSERT_TRUE(dev.readCurrentAddress(next).ok());
+  TEST_ASSERT_EQUAL_HEX8(0x5A, next);
+  TEST_ASSERT_EQUAL_UINT32(0u, sim.stats.timingViolations);
+}
+
+void test_sim_sequential_reads_use_current_address() {
+  at21sim::Device sim;
+  for (uint8_t i = 0; i < 128U; ++i) {
+    sim.eeprom()[i] = static_cast<uint8_t>(i ^ 0x5AU);
+  }
+  Driver dev;
+  Config cfg;
+  cfg.persistentSession = true;
+  cfg.sessionIdleTimeoutMs = 0;
+  TEST_ASSERT_TRUE(beginSim(dev, sim, cfg).ok());
+
+  // Random read: dummy write frame plus read frame, three address bytes.
+  uint8_t buf[4] = {};
+  uint32_t frames = sim.stats.frames;
+  uint32_t bytesIn = sim.stats.bytesIn;
+  TEST_ASSERT_TRUE(dev.readEeprom(0x10, buf, sizeof(buf)).ok());
+  TEST_ASSERT_EQUAL_UINT32(frames + 2U, sim.stats.frames);
+  TEST_ASSERT_EQUAL_UINT32(bytesIn + 3U, sim.stats.bytesIn);
+
+  // Starting at the tracked pointer: one frame, device address only.
+  frames = sim.stats.frames;
+  bytesIn = sim.stats.bytesIn;
+  TEST_ASSERT_TRUE(dev.readEeprom(0x14, buf, sizeof(buf)).ok());
+  TEST_ASSERT_EQUAL_UINT32(frames + 1U, sim.stats.frames);
+  TEST_ASSERT_EQUAL_UINT32(bytesIn + 1U, sim.stats.bytesIn);
+  TEST_ASSERT_EQUAL_MEMORY(sim.eeprom() + 0x14, buf, sizeof(buf));
+
+  // The pointer wraps 0x7F -> 0x00.
+  TEST_ASSERT_TRUE(dev.readEeprom(0x7E, buf, 2).ok());
+  frames = sim.stats.frames;
+  TEST_ASSERT_TRUE(dev.readEeprom(0x00, buf, 2).ok());
+  TEST_ASSERT_EQUAL_UINT32(frames + 1U, sim.stats.frames);
+  TEST_ASSERT_EQUAL_MEMORY(sim.eeprom(), buf, 2);
+
+  // A write ending on the page boundary rolls the pointer back to the page
+  // start, so the next address needs a random read again.
+  TEST_ASSERT_TRUE(dev.writeEepromByte(0x47, 0xC4).ok());
+  frames = sim.stats.frames;
+  bytesIn = sim.stats.bytesIn;
+  TEST_ASSERT_TRUE(dev.readEeprom(0x48, buf, 1).ok());
+  TEST_ASSERT_EQUAL_UINT32(frames + 2U, sim.stats.frames);
+  TEST_ASSERT_EQUAL_UINT32(bytesIn + 3U, sim.stats.bytesIn);
+  TEST_ASSERT_EQUAL_HEX8(0x48 ^ 0x5A, buf[0]);
+  TEST_ASSERT_TRUE(dev.writeEepromByte(0x47, 0xC5).ok());
+  frames = sim.stats.frames;
+  TEST_ASSERT_TRUE(dev.readEeprom(0x40, buf, 1).ok());
+  TEST_ASSERT_EQUAL_UINT32(frames + 1U, sim.stats.frames);
+  TEST_ASSERT_EQUAL_HEX8(0x40 ^ 0x5A, buf[0]);
+
+  // A reset discards the model: the next read sends the dummy write again.
+  TEST_ASSERT_TRUE(dev.probe().ok());
+  bytesIn = sim.stats.bytesIn;
+  TEST_ASSERT_TRUE(dev.readEeprom(0x41, buf, 1).ok());
+  TEST_ASSERT_EQUAL_UINT32(bytesIn + 3U, sim.stats.bytesIn);
+  TEST_ASSERT_EQUAL_HEX8(0x41 ^ 0x5A, buf[0]);
+  TEST_ASSERT_EQUAL_UINT32(0u, sim.stats.timingViolations);
+}
+
+void test_sim_write_if_changed_skips_matching_pages() {
+  at21sim::Device sim;
+  Driver dev;
+  TEST_ASSERT_TRUE(beginSim(dev, sim).ok());
+
+  // 0x06..0x19 touches pages 0-3.
+  uint8_t data[20];
+  for (uint8_t i = 0; i < sizeof(data); ++i) {
+    data[i] = static_cast<uint8_t>(0x30 + i);
+  }
+  uint8_t skipped = 0xEE;
+  TEST_ASSERT_TRUE(dev.writeEepromIfChanged(0x06, data, sizeof(data), skipped).ok());
+  TEST_ASSERT_EQUAL_UINT8(0u, skipped);
+  TEST_ASSERT_EQUAL_UINT32(4u, sim.stats.writeCycles);
+  TEST_ASSERT_EQUAL_MEMORY(data, sim.eeprom() + 0x06, sizeof(data));
+
+  // Same data again: every page matches and no write cycle starts.
+  TEST_ASSERT_TRUE(dev.writeEepromIfChanged(0x06, data, sizeof(data), skipped).ok());
+  TEST_ASSERT_EQUAL_UINT8(4u, skipped);
+  TEST_ASSERT_EQUAL_UINT32(4u, sim.stats.writeCycles);
+
+  // One changed byte rewrites only its page.
+  data[5] = 0x00;
+  TEST_ASSERT_TRUE(dev.writeEepromIfChanged(0x06, data, sizeof(data), skipped).ok());
+  TEST_ASSERT_EQUAL_UINT8(3u, skipped);
+  TEST_ASSERT_EQUAL_UINT32(5u, sim.stats.writeCycles);
+  TEST_ASSERT_EQUAL_MEMORY(data, sim.eeprom() + 0x06, sizeof(data));
+  TEST_ASSERT_EQUAL_UINT32(0u, sim.stats.timingViolations);
+}
+
+void test_sim_adaptive_polling_skips_early_polls() {
+  // Same write sequence with fixed and adaptive polling; the learned t_WR
+  // lets the adaptive driver skip most of the busy NACKs.
+  uint32_t busyNacks[2] = {};
+  for (uint8_t adaptive = 0; adaptive < 2U; ++adaptive) {
+    at21sim::Device sim;
+    Driver dev;
+    Config cfg;
+    cfg.adaptiveWritePolling = adaptive != 0U;
+    TEST_ASSERT_TRUE(beginSim(dev, sim, cfg).ok());
+    TEST_ASSERT_TRUE(dev.writeEepromByte(0x00, 0x11).ok());
+    const uint32_t learned = sim.stats.busyNacks;
+    for (uint8_t i = 1; i <= 8U; ++i) {
+      TEST_ASSERT_TRUE(dev.writeEepromByte(static_cast<uint8_t>(i * 8U), i).ok());
+    }
+    busyNacks[adaptive] = sim.stats.busyNacks - learned;
+    TEST_ASSERT_EQUAL_UINT32(9u, dev.getSettings().writeCycle.samples);
+    TEST_ASSERT_EQUAL_UINT32(0u, sim.stats.timingViolations);
+  }
+  TEST_ASSERT_TRUE(busyNacks[1] * 2U < busyNacks[0]);
+
+  // tick()-driven writes only see t_WR to the next tick on a millisecond clock:
+  // they never seed the estimate and a slow tick cadence never raises it.
+  at21sim::Device sim;
+  Driver dev;
+  Config cfg;
+  cfg.adaptiveWritePolling = true;
+  TEST_ASSERT_TRUE(beginSim(dev, sim, cfg).ok());
+  const uint8_t data[2] = {0x12, 0x34};
+  TEST_ASSERT_TRUE(dev.startWriteEeprom(0x10, data, sizeof(data)).inProgress());
+  for (uint16_t i = 0; i < 1000 && dev.writeInProgress(); ++i) {
+    sim.advance(100);
+    dev.tick(at21sim::Device::nowMs(&sim));
+  }
+  TEST_ASSERT_TRUE(dev.writeStatus().ok());
+  TEST_ASSERT_EQUAL_UINT32(0u, dev.getSettings().writeCycle.samples);
+
+  sim.writeCycleUs = 8000;
+  TEST_ASSERT_TRUE(dev.writeEepromByte(0x20, 0x56).ok());
+  const WriteCycleStats learned = dev.getSettings().writeCycle;
+  TEST_ASSERT_EQUAL_UINT32(1u, learned.samples);
+  TEST_ASSERT_TRUE(dev.startWriteEeprom(0x18, data, sizeof(data)).inProgress());
+  for (uint16_t i = 0; i < 100 && dev.writeInProgress(); ++i) {
+    sim.advance(10000);
+    dev.tick(at21sim::Device::nowMs(&sim));
+  }
+  TEST_ASSERT_TRUE(dev.writeStatus().ok());
+  WriteCycleStats wc = dev.getSettings().writeCycle;
+  TEST_ASSERT_EQUAL_UINT32(2u, wc.samples);
+  TEST_ASSERT_EQUAL_UINT32(learned.p90Us, wc.p90Us);
+  TEST_ASSERT_EQUAL_UINT32(learned.maxUs, wc.maxUs);
+
+  // A faster device seen through tick() still pulls the estimate down.
+  sim.writeCycleUs = 2000;
+  TEST_ASSERT_TRUE(dev.startWriteEeprom(0x28, data, sizeof(data)).inProgress());
+  for (uint16_t i = 0; i < 1000 && dev.writeInProgress(); ++i) {
+    sim.advance(100);
+    dev.tick(at21sim::Device::nowMs(&sim));
+  }
+  TEST_ASSERT_TRUE(dev.writeStatus().ok());
+  wc = dev.getSettings().writeCycle;
+  TEST_ASSERT_TRUE(wc.p90Us < learned.p90Us);
+  TEST_ASSERT_EQUAL_UINT32(0u, sim.stats.timingViolations);
+}
+
+void test_sim_rom_zone_lock_and_freeze() {
+  at21sim::Device sim;
+  Driver dev;
+  TEST_ASSERT_TRUE(beginSim(dev, sim).ok());
+
+  TEST_ASSERT_TRUE(dev.setZoneRom(1).ok());
+  bool rom = false;
+  TEST_ASSERT_TRUE(dev.isZoneRom(1, rom).ok());
+  TEST_ASSERT_TRUE(rom);
+  TEST_ASSERT_TRUE(dev.isZoneRom(0, rom).ok());
+  TEST_ASSERT_FALSE(rom);
+
+  const uint8_t value = 0x11;
+  Status st = dev.writeEepromByte(0x20, value);
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(Err::NACK_DATA),
+                          static_cast<uint8_t>(st.code));
+  TEST_ASSERT_TRUE(dev.writeEepromByte(0x1F, value).ok());
+
+  TEST_ASSERT_TRUE(dev.freezeRomZones().ok());
+  bool frozen = false;
+  TEST_ASSERT_TRUE(dev.areRomZonesFrozen(frozen).ok());
+  TEST_ASSERT_TRUE(frozen);
+  TEST_ASSERT_FALSE(dev.setZoneRom(2).ok());
+  TEST_ASSERT_FALSE(sim.zoneRom(2));
+
+  const uint8_t user[3] = {1, 2, 3};
+  TEST_ASSERT_FALSE(dev.writeSecurityUser(0x1E, user, sizeof(user)).ok());
+  TEST_ASSERT_TRUE(dev.writeSecurityUserPage(0x10, user, sizeof(user)).ok());
+  TEST_ASSERT_EQUAL_MEMORY(user, sim.security() + 0x10, sizeof(user));
+  TEST_ASSERT_TRUE(dev.lockSecurityRegister().ok());
+  bool locked = false;
+  TEST_ASSERT_TRUE(dev.isSecurityLocked(locked).ok());
+  TEST_ASSERT_TRUE(locked);
+  TEST_ASSERT_FALSE(dev.writeSecurityUserByte(0x18, 0x42).ok());
+}
+
+void test_sim_rom_zone_guard_rejects_before_bus() {
+  at21sim::Device sim;
+  Driver dev;
+  Config cfg;
+  cfg.romZoneGuard = true;
+  TEST_ASSERT_TRUE(beginSim(dev, sim, cfg).ok());
+  TEST_ASSERT_TRUE(dev.setZoneRom(1).ok());
+
+  // The first guarded write loads the zone bitmap; later rejections cost nothing.
+  const uint8_t value = 0x11;
+  Status st = dev.writeEepromByte(0x20, value);
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(Err::WRITE_PROTECTED),
+                          static_cast<uint8_t>(st.code));
+  TEST_ASSERT_EQUAL_INT32(1, st.detail);
+  TEST_ASSERT_TRUE(dev.getSettings().romZoneMaskValid);
+  TEST_ASSERT_EQUAL_HEX8(0x02, dev.getSettings().romZoneMask);
+
+  const uint32_t frames = sim.stats.frames;
+  uint8_t span[16];
+  std::memset(span, 0x22, sizeof(span));
+  st = dev.writeEeprom(0x18, span, sizeof(span));
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(Err::WRITE_PROTECTED),
+                          static_cast<uint8_t>(st.code));
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(Err::WRITE_PROTECTED),
+                          static_cast<uint8_t>(dev.startWriteEeprom(0x3C, span, 4).code));
+  TEST_ASSERT_EQUAL_UINT32(frames, sim.stats.frames);
+  TEST_ASSERT_EQUAL_HEX8(0xFF, sim.eeprom()[0x18]);
+  TEST_ASSERT_EQUAL_UINT8(0u, dev.consecutiveFailures());
+  TEST_ASSERT_TRUE(dev.writeEepromByte(0x1F, value).ok());
+
+  // A fresh driver learns zones set before begin().
+  Driver other;
+  TEST_ASSERT_TRUE(beginSim(other, sim, cfg).ok());
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(Err::WRITE_PROTECTED),
+                          static_cast<uint8_t>(other.writeEepromVerified(0x30, span, 2).code));
+}
+
+void test_sim_timing_scan_suggests_faster_profile() {
+  at21sim::Device sim;
+  Driver dev;
+  TEST_ASSERT_TRUE(beginSim(dev, sim).ok());
+  const uint32_t failures = dev.totalFailures();
+
+  // The simulator resolves whole microseconds, so sweep in 1 us steps.
+  TimingScanConfig scan;
+  scan.stepNs = 1000;
+  TimingScanResult result;
+  TEST_ASSERT_TRUE(dev.characterizeTiming(result, scan).ok());
+  TEST_ASSERT_EQUAL_UINT32(4000u, result.low0.minNs);
+  // The sample point never moves past t_MRS (2 us after the fall).
+  TEST_ASSERT_EQUAL_UINT32(1000u, result.readSample.maxNs);
+  TEST_ASSERT_TRUE(result.profile.readLowNs + result.profile.readSampleNs <= 2000u);
+  TEST_ASSERT_TRUE(Driver::validateTimingProfile(result.profile, SpeedMode::HIGH_SPEED).ok());
+  TEST_ASSERT_TRUE(result.profile.bitNs < HIGH_SPEED_TIMING.bitNs);
+  TEST_ASSERT_EQUAL_UINT32(failures, dev.totalFailures());
+  TEST_ASSERT_EQUAL_UINT8(0u, dev.consecutiveFailures());
+
+  // The suggestion round-trips through Config; out-of-spec profiles do not.
+  Config cfg;
+  cfg.highSpeedTiming = result.profile;
+  Driver tuned;
+  TEST_ASSERT_TRUE(beginSim(tuned, sim, cfg).ok());
+  TEST_ASSERT_TRUE(tuned.writeEepromByte(0x05, 0x5A).ok());
+  uint8_t value = 0;
+  TEST_ASSERT_TRUE(tuned.readEeprom(0x05, &value, 1).ok());
+  TEST_ASSERT_EQUAL_HEX8(0x5A, value);
+
+  cfg.highSpeedTiming.low1Ns = 2500;
+  Driver rejected;
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(Err::INVALID_CONFIG),
+                          static_cast<uint8_t>(beginSim(rejected, sim, cfg).code));
+  TimingProfile late = HIGH_SPEED_TIMING;
+  late.readLowNs = 1500;
+  TEST_ASSERT_EQUAL_UINT8(
+      static_cast<uint8_t>(Err::INVALID_CONFIG),
+      static_cast<uint8_t>(Driver::validateTimingProfile(late, SpeedMode::HIGH_SPEED).code));
+
+  // Segments are not rewritten under a running asynchronous write.
+  const uint8_t data[2] = {0x01, 0x02};
+  TEST_ASSERT_TRUE(tuned.startWriteEeprom(0x08, data, 2).inProgress());
+  TEST_ASSERT_EQUAL_UINT8(
+      static_cast<uint8_t>(Err::INVALID_STATE),
+      static_cast<uint8_t>(tuned.setTimingProfile(SpeedMode::HIGH_SPEED, result.profile).code));
+  for (uint16_t i = 0; i < 1000 && tuned.writeInProgress(); ++i) {
+    sim.advance(100);
+    tuned.tick(at21sim::Device::nowMs(&sim));
+  }
+  TEST_ASSERT_TRUE(tuned.writeStatus().ok());
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(Err::INVALID_CONFIG),
+                          static_cast<uint8_t>(dev.setTimingProfile(SpeedMode::HIGH_SPEED,
+                                                                    cfg.highSpeedTiming)
+                                                   .code));
+}
+
+void test_sim_basic_driver_both_speeds() {
+  at21sim::Device sim;
+  HookTiming hooks;
+  hooks.lineWrite = &at21sim::Device::lineWrite;
+  hooks.lineRead = &at21sim::Device::lineRead;
+  hooks.lineUser = &sim;
+  hooks.sleepUs = &at21sim::Device::sleepUs;
+  hooks.timeUser = &sim;
+
+  BasicDriver<HighSpeedPolicy> fast(hooks);
+  TEST_ASSERT_TRUE(fast.begin().ok());
+  uint32_t id = 0;
+  TEST_ASSERT_TRUE(fast.readManufacturerId(id).ok());
+  TEST_ASSERT_EQUAL_HEX32(cmd::MANUFACTURER_ID_AT21CS01, id);
+
+  const uint8_t page[4] = {0x12, 0x34, 0x56, 0x78};
+  TEST_ASSERT_TRUE(fast.writeEepromPage(0x10, page, sizeof(page)).ok());
+  TEST_ASSERT_EQUAL_UINT32(1u, sim.stats.writeCycles);
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(page, sim.eeprom() + 0x10, sizeof(page));
+  uint8_t serial[cmd::SECURITY_SERIAL_SIZE] = {};
+  TEST_ASSERT_TRUE(fast.readSecurity(0x00, serial, sizeof(serial)).ok());
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(sim.security(), serial, sizeof(serial));
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(Err::INVALID_PARAM),
+                          static_cast<uint8_t>(fast.writeEepromPage(0x0E, page, 4).code));
+
+  BasicDriver<StandardSpeedPolicy> slow(hooks);
+  TEST_ASSERT_TRUE(slow.begin().ok());
+  TEST_ASSERT_FALSE(sim.highSpeed());
+  uint8_t back[4] = {};
+  TEST_ASSERT_TRUE(slow.readEeprom(0x10, back, sizeof(back)).ok());
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(page, back, sizeof(back));
+  TEST_ASSERT_EQUAL_UINT32(0u, sim.stats.timingViolations);
+}
+
+// Records the driver's own edges as waveform symbols while forwarding to the simulator.
+struct WaveTrace {
+  at21sim::Device* sim = nullptr;
+  bool recording = false;
+  bool low = false;
+  uint16_t raw[WAVEFORM_MAX_SYMBOLS] = {};
+  size_t count = 0;
+};
+
+static void traceLineWrite(bool low, void* user) {
+  WaveTrace* trace = static_cast<WaveTrace*>(user);
+  trace->low = low;
+  at21sim::Device::lineWrite(low, trace->sim);
+}
+
+static bool traceLineRead(void* user) {
+  WaveTrace* trace = static_cast<WaveTrace*>(user);
+  if (trace->recording && trace->count > 0U) {
+    trace->raw[trace->count - 1U] |= WaveSymbol::SAMPLE_BIT;
+  }
+  return at21sim::Device::lineRead(trace->sim);
+}
+
+static void traceSleepUs(uint32_t us, void* user) {
+  WaveTrace* trace = static_cast<WaveTrace*>(user);
+  if (trace->recording && us > 0U && trace->count < WAVEFORM_MAX_SYMBOLS) {
+    trace->raw[trace->count++] =
+        static_cast<uint16_t>((trace->low ? 0U : WaveSymbol::HIGH_BIT) | us);
+  }
+  at21sim::Device::sleepUs(us, trace->sim);
+}
+
+static uint32_t traceNowMs(void* user) {
+  return at21sim::Device::nowMs(static_cast<WaveTrace*>(user)->sim);
+}
+
+void test_sim_waveform_matches_bit_primitives() {
+  at21sim::Device sim;
+  for (uint8_t i = 0; i < 8U; ++i) {
+    sim.eeprom()[0x20 + i] = static_cast<uint8_t>(0xC3U ^ (i * 0x11U));
+  }
+  WaveTrace trace;
+  trace.sim = &sim;
+  Config cfg;
+  cfg.persistentSession = true;
+  cfg.sessionIdleTimeoutMs = 0;
+  sim.attach(cfg);
+  cfg.lineWrite = traceLineWrite;
+  cfg.lineRead = traceLineRead;
+  cfg.lineUser = &trace;
+  cfg.sleepUs = traceSleepUs;
+  cfg.nowMs = traceNowMs;
+  cfg.timeUser = &trace;
+  Driver dev;
+  TEST_ASSERT_TRUE(dev.begin(cfg).ok());
+
+  // Encoding reproduces the driver's own read and write frames symbol for symbol.
+  static Waveform wave;
+  TEST_ASSERT_TRUE(wave.begin(cfg.highSpeedTiming, SpeedMode::HIGH_SPEED, 0).ok());
+  TEST_ASSERT_TRUE(wave.encodeRandomRead(cmd::OPCODE_EEPROM, 0x20, 4).ok());
+  TEST_ASSERT_EQUAL_UINT32(WAVEFORM_READ_DATA_SAMPLE + 32U, wave.sampleCount());
+  uint8_t buf[4] = {};
+  trace.recording = true;
+  TEST_ASSERT_TRUE(dev.readEeprom(0x20, buf, sizeof(buf)).ok());
+  trace.recording = false;
+  TEST_ASSERT_EQUAL_UINT32(wave.size(), trace.count);
+  for (size_t i = 0; i < wave.size(); ++i) {
+    TEST_ASSERT_EQUAL_HEX16(trace.raw[i], wave.symbols()[i].raw);
+  }
+
+  const uint8_t page[3] = {0x5A, 0x00, 0xFF};
+  TEST_ASSERT_TRUE(wave.encodeWrite(cmd::OPCODE_EEPROM, 0x30, page, sizeof(page)).ok());
+  trace.count = 0;
+  trace.recording = true;
+  TEST_ASSERT_TRUE(dev.writeEepromPage(0x30, page, sizeof(page)).ok());
+  trace.recording = false;
+  // The driver's ACK polling follows the write frame.
+  TEST_ASSERT_TRUE(trace.count > wave.size());
+  for (size_t i = 0; i < wave.size(); ++i) {
+    TEST_ASSERT_EQUAL_HEX16(trace.raw[i], wave.symbols()[i].raw);
+  }
+
+  // Replay captures the data at the marked sample points, one bit slot masked at a time.
+  TEST_ASSERT_TRUE(wave.encodeRandomRead(cmd::OPCODE_EEPROM, 0x20, 8).ok());
+  dev.resetMaskingStats();
+  TEST_ASSERT_TRUE(dev.runWaveform(wave).ok());
+  for (size_t i = 0; i < 8U; ++i) {
+    TEST_ASSERT_EQUAL_HEX8(sim.eeprom()[0x20 + i],
+                           wave.sampleByte(WAVEFORM_READ_DATA_SAMPLE + 8U * i));
+  }
+  TEST_ASSERT_TRUE(dev.getSettings().masking.peakWindowUs <= cfg.highSpeedTiming.bitNs / 1000U);
+
+  const uint8_t update[2] = {0x81, 0x42};
+  TEST_ASSERT_TRUE(wave.encodeWrite(cmd::OPCODE_EEPROM, 0x21, update, sizeof(update)).ok());
+  const uint32_t cycles = sim.stats.writeCycles;
+  TEST_ASSERT_TRUE(dev.runWaveform(wave).ok());
+  TEST_ASSERT_TRUE(dev.waitReady(25).ok());
+  TEST_ASSERT_EQUAL_UINT32(cycles + 1U, sim.stats.writeCycles);
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(update, sim.eeprom() + 0x21, sizeof(update));
+  TEST_ASSERT_EQUAL_UINT32(0u, sim.stats.timingViolations);
+
+  // Another address answers with a NACK; a foreign profile is refused before bus I/O.
+  TEST_ASSERT_TRUE(wave.begin(cfg.highSpeedTiming, SpeedMode::HIGH_SPEED, 5).ok());
+  TEST_ASSERT_TRUE(wave.encodeRandomRead(cmd::OPCODE_EEPROM, 0x00, 1).ok());
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(Err::NACK_DEVICE_ADDRESS),
+                          static_cast<uint8_t>(dev.runWaveform(wave).code));
+  TEST_ASSERT_TRUE(wave.begin(STANDARD_SPEED_TIMING, SpeedMode::STANDARD_SPEED, 0, 25).ok());
+  wave.start();
+  TEST_ASSERT_EQUAL_UINT32(2u, wave.size());
+  TEST_ASSERT_EQUAL_UINT16(WaveSymbol::TICKS_MASK, wave.symbols()[0].ticks());
+  TEST_ASSERT_EQUAL_UINT32(STANDARD_SPEED_TIMING.htssNs / 25U, wave.totalTicks());
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(Err::INVALID_STATE),
+                          static_cast<uint8_t>(dev.runWaveform(wave).code));
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(Err::INVALID_PARAM),
+                          static_cast<uint8_t>(wave.begin(HIGH_SPEED_TIMING,
+                                                          SpeedMode::HIGH_SPEED, 0, 0)
+                                                   .code));
+}
+
+// One-shot alarm stand-in: the test advances the simulator and fires the alarm.
+struct MockTimer {
+  uint32_t pendingUs = 0;
+  bool armed = false;
+  uint32_t alarms = 0;
+};
+
+static void mockAlarmStart(uint32_t delayUs, void* user) {
+  MockTimer* timer = static_cast<MockTimer*>(user);
+  timer->pendingUs = delayUs;
+  timer->armed = true;
+  ++timer->alarms;
+}
+
+static void recordWaveformDone(const Status& result, void* user) {
+  Status* out = static_cast<Status*>(user);
+  *out = result;
+}
+
+void test_sim_timer_phy_runs_standard_speed_from_alarms() {
+  at21sim::Device sim;
+  for (uint8_t i = 0; i < 8U; ++i) {
+    sim.eeprom()[0x40 + i] = static_cast<uint8_t>(0x3CU + i * 7U);
+  }
+  MockTimer timer;
+  Config cfg;
+  cfg.startupSpeed = SpeedMode::STANDARD_SPEED;
+  cfg.persistentSession = true;
+  cfg.sessionIdleTimeoutMs = 0;
+  cfg.timerPhy = true;
+  cfg.alarmStart = mockAlarmStart;
+  cfg.alarmUser = &timer;
+  Driver dev;
+  TEST_ASSERT_TRUE(beginSim(dev, sim, cfg).ok());
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(SpeedMode::STANDARD_SPEED),
+                          static_cast<uint8_t>(dev.speedMode()));
+
+  static Waveform wave;
+  TEST_ASSERT_TRUE(
+      wave.begin(cfg.standardSpeedTiming, SpeedMode::STANDARD_SPEED, cfg.addressBits).ok());
+  TEST_ASSERT_TRUE(wave.encodeRandomRead(cmd::OPCODE_EEPROM, 0x40, 8).ok());
+
+  Status done = Status::Error(Err::INVALID_STATE, "not called");
+  dev.resetMaskingStats();
+  const uint64_t startUs = sim.nowUs();
+  Status st = dev.startWaveform(wave, recordWaveformDone, &done);
+  TEST_ASSERT_TRUE(st.inProgress());
+  TEST_ASSERT_TRUE(dev.waveformInProgress());
+  uint8_t value = 0;
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(Err::INVALID_STATE),
+                          static_cast<uint8_t>(dev.readEeprom(0x00, &value, 1).code));
+
+  // Time spent inside the driver is spinning; time between alarms is free.
+  uint64_t idleUs = 0;
+  while (timer.armed) {
+    timer.armed = false;
+    sim.advance(timer.pendingUs);
+    idleUs += timer.pendingUs;
+    dev.onTimerAlarm();
+  }
+  const uint64_t totalUs = sim.nowUs() - startUs;
+  for (size_t i = 0; i < 8U; ++i) {
+    TEST_ASSERT_EQUAL_HEX8(sim.eeprom()[0x40 + i],
+                           wave.sampleByte(WAVEFORM_READ_DATA_SAMPLE + 8U * i));
+  }
+  TEST_ASSERT_EQUAL_UINT32(0u, sim.stats.timingViolations);
+  TEST_ASSERT_TRUE(idleUs * 5U > totalUs * 4U);
+
+  // Only the short segments between alarms run masked.
+  const AT21CS::MaskingStats masking = dev.getSettings().masking;
+  TEST_ASSERT_TRUE(masking.totalUs > 0U);
+  TEST_ASSERT_TRUE(masking.peakWindowUs < cfg.timerMinUs);
+
+  // The alarm handler only drives the line; tick() decodes the result, folds
+  // it into the health counters and calls done.
+  TEST_ASSERT_TRUE(dev.waveformInProgress());
+  TEST_ASSERT_TRUE(dev.waveformStatus().inProgress());
+  TEST_ASSERT_FALSE(done.ok());
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(Err::INVALID_STATE),
+                          static_cast<uint8_t>(dev.readEeprom(0x00, &value, 1).code));
+  const uint32_t successes = dev.totalSuccess();
+  dev.tick(0);
+  TEST_ASSERT_FALSE(dev.waveformInProgress());
+  TEST_ASSERT_TRUE(done.ok());
+  TEST_ASSERT_TRUE(dev.waveformStatus().ok());
+  TEST_ASSERT_EQUAL_UINT32(successes + 1U, dev.totalSuccess());
+  TEST_ASSERT_TRUE(dev.readEeprom(0x40, &value, 1).ok());
+
+  // A timer-driven write, then High-Speed falls back to the synchronous spin replay.
+  const uint8_t page[2] = {0xE1, 0x1E};
+  TEST_ASSERT_TRUE(wave.encodeWrite(cmd::OPCODE_EEPROM, 0x48, page, sizeof(page)).ok());
+  TEST_ASSERT_TRUE(dev.startWaveform(wave).inProgress());
+  while (timer.armed) {
+    timer.armed = false;
+    sim.advance(timer.pendingUs);
+    dev.onTimerAlarm();
+  }
+  dev.tick(0);
+  TEST_ASSERT_TRUE(dev.waveformStatus().ok());
+  TEST_ASSERT_TRUE(dev.waitReady(25).ok());
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(page, sim.eeprom() + 0x48, sizeof(page));
+
+  TEST_ASSERT_TRUE(dev.setHighSpeed().ok());
+  TEST_ASSERT_TRUE(wave.begin(cfg.highSpeedTiming, SpeedMode::HIGH_SPEED, cfg.addressBits).ok());
+  TEST_ASSERT_TRUE(wave.encodeRandomRead(cmd::OPCODE_EEPROM, 0x48, 2).ok());
+  const uint32_t alarms = timer.alarms;
+  done = Status::Error(Err::INVALID_STATE, "not called");
+  TEST_ASSERT_TRUE(dev.startWaveform(wave, recordWaveformDone, &done).ok());
+  TEST_ASSERT_TRUE(done.ok());
+  TEST_ASSERT_EQUAL_UINT32(alarms, timer.alarms);
+  TEST_ASSERT_EQUAL_HEX8(0xE1, wave.sampleByte(WAVEFORM_READ_DATA_SAMPLE));
+
+  Driver bad;
+  Config noTimer;
+  noTimer.sioPin = 4;
+  noTimer.timerPhy = true;
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(Err::INVALID_CONFIG),
+                          static_cast<uint8_t>(bad.begin(noTimer).code));
+}
+
+void test_sim_standard_speed_and_session() {
+  at21sim::Device sim;
+  Driver dev;
+  Config cfg;
+  cfg.startupSpeed = SpeedMode::STANDARD_SPEED;
+  TEST_ASSERT_TRUE(beginSim(dev, sim, cfg).ok());
+  TEST_ASSERT_FALSE(sim.highSpeed());
+
+  uint8_t buf[4] = {};
+  TEST_ASSERT_TRUE(dev.readEeprom(0x00, buf, sizeof(buf)).ok());
+  bool standard = false;
+  TEST_ASSERT_TRUE(dev.isStandardSpeed(standard).ok());
+  TEST_ASSERT_TRUE(standard);
+
+  // A raw reset drops the device to High-Speed; the next operation restores Standard.
+  TEST_ASSERT_TRUE(dev.probe().ok());
+  TEST_ASSERT_TRUE(sim.highSpeed());
+  TEST_ASSERT_TRUE(dev.readEeprom(0x00, buf, sizeof(buf)).ok());
+  TEST_ASSERT_FALSE(sim.highSpeed());
+
+  at21sim::Device fast;
+  Driver held;
+  Config session;
+  session.persistentSession = true;
+  TEST_ASSERT_TRUE(beginSim(held, fast, session).ok());
+  const uint32_t resets = fast.stats.resets;
+  for (uint8_t i = 0; i < 4; ++i) {
+    TEST_ASSERT_TRUE(held.readEeprom(static_cast<uint8_t>(i * 4U), buf, sizeof(buf)).ok());
+  }
+  TEST_ASSERT_EQUAL_UINT32(resets, fast.stats.resets);
+  TEST_ASSERT_EQUAL_UINT32(0u, sim.stats.timingViolations);
+  TEST_ASSERT_EQUAL_UINT32(0u, fast.stats.timingViolations);
+
+  // A High-Speed ACK sampled 3 us after the fall is past t_MRS and the
+  // minimum t_HLD0: the device has released the line already.
+  fast.advance(at21sim::Device::STOP_GAP_US);
+  const uint8_t address = 0xA0;
+  for (int8_t bit = 7; bit >= 0; --bit) {
+    const uint32_t lowUs = ((address >> bit) & 0x01U) ? 1U : 8U;
+    at21sim::Device::lineWrite(true, &fast);
+    fast.advance(lowUs);
+    at21sim::Device::lineWrite(false, &fast);
+    fast.advance(12U - lowUs);
+  }
+  at21sim::Device::lineWrite(true, &fast);
+  fast.advance(1);
+  at21sim::Device::lineWrite(false, &fast);
+  fast.advance(2);
+  TEST_ASSERT_TRUE(at21sim::Device::lineRead(&fast));
+  TEST_ASSERT_EQUAL_UINT32(1u, fast.stats.timingViolations);
+}
+
+void test_sim_shadow_and_async_write() {
+  at21sim::Device sim;
+  Driver dev;
+  Config cfg;
+  cfg.shadowCache = true;
+  TEST_ASSERT_TRUE(beginSim(dev, sim, cfg).ok());
+
+  uint8_t buf[8] = {};
+  TEST_ASSERT_TRUE(dev.readEeprom(0x40, buf, sizeof(buf)).ok());
+  const uint32_t frames = sim.stats.frames;
+  TEST_ASSERT_TRUE(dev.readEeprom(0x42, buf, 4).ok());
+  TEST_ASSERT_EQUAL_UINT32(frames, sim.stats.frames);
+
+  uint8_t data[10];
+  std::memset(data, 0x3C, sizeof(data));
+  Status st = dev.startWriteEeprom(0x3C, data, sizeof(data));
+  TEST_ASSERT_TRUE(st.inProgress());
+  for (uint16_t i = 0; i < 1000 && dev.writeInProgress(); ++i) {
+    sim.advance(100);
+    dev.tick(at21sim::Device::nowMs(&sim));
+  }
+  TEST_ASSERT_TRUE(dev.writeStatus().ok());
+  TEST_ASSERT_EQUAL_MEMORY(data, sim.eeprom() + 0x3C, sizeof(data));
+  TEST_ASSERT_TRUE(dev.readEeprom(0x40, buf, sizeof(buf)).ok());
+  TEST_ASSERT_EQUAL_MEMORY(data + 4, buf, 6);
+}
+
+void test_sim_critical_section_granularity() {
+  uint32_t peakWindow[3] = {};
+  uint32_t totalMasked[3] = {};
+  const AT21CS::CriticalSection scopes[3] = {AT21CS::CriticalSection::PER_BIT,
+                                             AT21CS::CriticalSection::PER_BYTE,
+                                             AT21CS::CriticalSection::PER_TRANSACTION};
+  uint8_t buf[16] = {};
+  for (uint8_t i = 0; i < 3; ++i) {
+    at21sim::Device sim;
+    Driver dev;
+    Config cfg;
+    cfg.criticalSection = scopes[i];
+    TEST_ASSERT_TRUE(beginSim(dev, sim, cfg).ok());
+    dev.resetMaskingStats();
+    TEST_ASSERT_TRUE(dev.readEeprom(0x00, buf, sizeof(buf)).ok());
+    const AT21CS::MaskingStats masking = dev.getSettings().masking;
+    TEST_ASSERT_TRUE(masking.transactions > 0u);
+    TEST_ASSERT_TRUE(masking.peakTotalUs >= masking.peakWindowUs);
+    peakWindow[i] = masking.peakWindowUs;
+    totalMasked[i] = masking.totalUs;
+    TEST_ASSERT_EQUAL_UINT32(0u, sim.stats.timingViolations);
+  }
+  // Finer sections shorten the longest window; the masked total stays the same.
+  TEST_ASSERT_TRUE(peakWindow[0] < peakWindow[1]);
+  TEST_ASSERT_TRUE(peakWindow[1] < peakWindow[2]);
+  TEST_ASSERT_EQUAL_UINT32(totalMasked[1], totalMasked[0]);
+  TEST_ASSERT_EQUAL_UINT32(totalMasked[1], totalMasked[2]);
+
+  Driver bad;
+  Config cfg;
+  cfg.sioPin = 4;
+  cfg.criticalSection = static_cast<AT21CS::CriticalSection>(7);
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(Err::INVALID_CONFIG),
+                          static_cast<uint8_t>(bad.begin(cfg).code));
+}
+
+void test_sim_batch_runs_under_one_activation() {
+  at21sim::Device sim;
+  Driver dev;
+  TEST_ASSERT_TRUE(beginSim(dev, sim).ok());
+  const uint8_t page[4] = {0x11, 0x22, 0x33, 0x44};
+
+  Batch batch;
+  uint32_t id = 0;
+  SerialNumberInfo serial;
+  uint8_t identity[16] = {};
+  uint8_t records[2][32] = {};
+  TEST_ASSERT_TRUE(batch.readManufacturerId(id).ok());
+  TEST_ASSERT_TRUE(batch.readSerialNumber(serial).ok());
+  TEST_ASSERT_TRUE(batch.readSecurity(0x10, identity, sizeof(identity)).ok());
+  TEST_ASSERT_TRUE(batch.writeEepromPage(0x08, page, sizeof(page)).ok());
+  TEST_ASSERT_TRUE(batch.readEeprom(0x00, records[0], 32).ok());
+  TEST_ASSERT_TRUE(batch.readEeprom(0x20, records[1], 32).ok());
+
+  const uint32_t resets = sim.stats.resets;
+  const uint32_t success = dev.totalSuccess();
+  TEST_ASSERT_TRUE(dev.runBatch(batch).ok());
+  TEST_ASSERT_EQUAL_UINT32(resets + 1u, sim.stats.resets);
+  TEST_ASSERT_EQUAL_UINT32(success + 1u, dev.totalSuccess());
+  TEST_ASSERT_EQUAL_UINT32(1u, sim.stats.writeCycles);
+  TEST_ASSERT_EQUAL_HEX32(0x00D200u, id);
+  TEST_ASSERT_TRUE(serial.crcOk);
+  TEST_ASSERT_EQUAL_MEMORY(page, records[0] + 8, sizeof(page));
+  for (uint8_t i = 0; i < batch.size(); ++i) {
+    TEST_ASSERT_TRUE(batch.status(i).ok());
+  }
+  TEST_ASSERT_EQUAL_INT(-1, batch.firstFailedIndex());
+
+  // Invalid operations are rejected before any bus I/O.
+  Batch bad;
+  TEST_ASSERT_TRUE(bad.readEeprom(0x00, records[0], 4).ok());
+  TEST_ASSERT_TRUE(bad.writeEepromPage(0x06, page, sizeof(page)).ok());
+  const uint32_t frames = sim.stats.frames;
+  Status st = dev.runBatch(bad);
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(Err::INVALID_PARAM),
+                          static_cast<uint8_t>(st.code));
+  TEST_ASSERT_EQUAL_INT32(1, st.detail);
+  TEST_ASSERT_EQUAL_UINT32(frames, sim.stats.frames);
+
+  // A failed write skips the rest unless the batch continues on error.
+  Batch stop;
+  sim.writeCycleUs = 500000;
+  TEST_ASSERT_TRUE(stop.writeEepromPage(0x10, page, sizeof(page)).ok());
+  TEST_ASSERT_TRUE(stop.readEeprom(0x10, records[0], 4).ok());
+  st = dev.runBatch(stop);
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(Err::BUSY_TIMEOUT),
+                          static_cast<uint8_t>(st.code));
+  TEST_ASSERT_EQUAL_INT(0, stop.firstFailedIndex());
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(Err::INVALID_STATE),
+                          static_cast<uint8_t>(stop.status(1).code));
+  TEST_ASSERT_EQUAL_UINT8(1u, dev.consecutiveFailures());
+}
+
+struct StreamProbe {
+  uint8_t bytes[32];
+  size_t calls;
+  uint32_t crc;
+};
+
+static void streamProbeByte(uint8_t value, size_t index, void* user) {
+  StreamProbe& probe = *static_cast<StreamProbe*>(user);
+  probe.bytes[index] = value;
+  probe.crc = AT21CS::crc::crc32UpdateByte(probe.crc, value);
+  ++probe.calls;
+}
+
+void test_sim_stream_read_hashes_bytes_in_flight() {
+  at21sim::Device sim;
+  Driver dev;
+  TEST_ASSERT_TRUE(beginSim(dev, sim).ok());
+
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(Err::INVALID_PARAM),
+                          static_cast<uint8_t>(dev.readEepromStream(0, 4, nullptr, nullptr).code));
+
+  lcmap::CalibrationBlockV1 cal{};
+  cal.capacityGrams = 50000;
+  cal.spanRawAtCapacity = 123456;
+  TEST_ASSERT_TRUE(lcmap::writeCalibrationMaster(dev, cal).ok());
+
+  // Same bus traffic as a buffered read; the sink sees every byte in order.
+  const uint32_t bytesOut = sim.stats.bytesOut;
+  StreamProbe probe{{}, 0, AT21CS::crc::CRC32_INIT};
+  TEST_ASSERT_TRUE(dev.readEepromStream(lcmap::CALIBRATION_MASTER_ADDR, 32, streamProbeByte,
+                                        &probe).ok());
+  TEST_ASSERT_EQUAL_UINT32(32u, sim.stats.bytesOut - bytesOut);
+  TEST_ASSERT_EQUAL_UINT32(32u, static_cast<uint32_t>(probe.calls));
+  TEST_ASSERT_EQUAL_MEMORY(&sim.eeprom()[lcmap::CALIBRATION_MASTER_ADDR], probe.bytes, 32);
+  TEST_ASSERT_EQUAL_HEX32(AT21CS::crc::crc32(probe.bytes, 32),
+                          AT21CS::crc::crc32Final(probe.crc));
+
+  lcmap::CalibrationBlockV1 readBack{};
+  bool valid = false;
+  TEST_ASSERT_TRUE(lcmap::readCalibrationMaster(dev, readBack, valid).ok());
+  TEST_ASSERT_TRUE(valid);
+  TEST_ASSERT_EQUAL_UINT32(50000u, readBack.capacityGrams);
+
+  sim.eeprom()[lcmap::CALIBRATION_MASTER_ADDR + 12] ^= 0x01U;
+  TEST_ASSERT_TRUE(lcmap::readCalibrationMaster(dev, readBack, valid).ok());
+  TEST_ASSERT_FALSE(valid);
+}
+
+void test_sim_write_verified_single_activation() {
+  at21sim::Device sim;
+  Driver dev;
+  TEST_ASSERT_TRUE(beginSim(dev, sim).ok());
+
+  uint8_t data[12];
+  for (uint8_t i = 0; i < sizeof(data); ++i) {
+    data[i] = static_cast<uint8_t>(0x30 + i);
+  }
+  const uint32_t resets = sim.stats.resets;
+  const uint32_t success = dev.totalSuccess();
+  TEST_ASSERT_TRUE(dev.writeEepromVerified(0x44, data, sizeof(data)).ok());
+  TEST_ASSERT_EQUAL_UINT32(resets + 1u, sim.stats.resets);
+  TEST_ASSERT_EQUAL_UINT32(2u, sim.stats.writeCycles);
+  TEST_ASSERT_EQUAL_UINT32(success + 1u, dev.totalSuccess());
+  TEST_ASSERT_EQUAL_MEMORY(data, &sim.eeprom()[0x44], sizeof(data));
+
+  // A worn cell reports the first differing offset without a health failure.
+  sim.wornAddress = 0x4A;
+  sim.stuckHighBits = 0x80;
+  Status st = dev.writeEepromVerified(0x44, data, sizeof(data));
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(Err::VERIFY_FAILED), static_cast<uint8_t>(st.code));
+  TEST_ASSERT_EQUAL_INT32(6, st.detail);
+  TEST_ASSERT_EQUAL_UINT32(0u, dev.consecutiveFailures());
+
+  const uint8_t ident[4] = {0xDE, 0xAD, 0xBE, 0xEF};
+  TEST_ASSERT_TRUE(dev.writeSecurityUserVerified(0x16, ident, sizeof(ident)).ok());
+  TEST_ASSERT_EQUAL_MEMORY(ident, &sim.security()[0x16], sizeof(ident));
+  st = dev.writeSecurityUserVerified(0x08, ident, sizeof(ident));
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(Err::INVALID_PARAM), static_cast<uint8_t>(st.code));
+}
+
+void test_sim_identity_cache_skips_bus_until_swap() {
+  at21sim::Device sim;
+  Driver dev;
+  Config cfg;
+  cfg.identityCache = true;
+  TEST_ASSERT_TRUE(beginSim(dev, sim, cfg).ok());
+
+  SerialNumberInfo serial;
+  TEST_ASSERT_TRUE(dev.readSerialNumber(serial).ok());
+  const uint32_t frames = sim.stats.frames;
+  TEST_ASSERT_TRUE(dev.readSerialNumber(serial).ok());
+  TEST_ASSERT_TRUE(serial.crcOk);
+  uint32_t id = 0;
+  TEST_ASSERT_TRUE(dev.readManufacturerId(id).ok());
+  PartType part = PartType::UNKNOWN;
+  TEST_ASSERT_TRUE(dev.detectPart(part).ok());
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(PartType::AT21CS01), static_cast<uint8_t>(part));
+  TEST_ASSERT_EQUAL_UINT32(frames, sim.stats.frames);
+
+  // Unlocked is re-checked every time; locked is one-way and cached.
+  bool locked = true;
+  TEST_ASSERT_TRUE(dev.isSecurityLocked(locked).ok());
+  TEST_ASSERT_FALSE(locked);
+  TEST_ASSERT_TRUE(sim.stats.frames > frames);
+  TEST_ASSERT_TRUE(dev.lockSecurityRegister().ok());
+  const uint32_t lockedFrames = sim.stats.frames;
+  TEST_ASSERT_TRUE(dev.isSecurityLocked(locked).ok());
+  TEST_ASSERT_TRUE(locked);
+  TEST_ASSERT_EQUAL_UINT32(lockedFrames, sim.stats.frames);
+
+  // recover() keeps the cache for the same device and drops it for a new serial.
+  TEST_ASSERT_TRUE(dev.recover().ok());
+  const uint32_t recoveredFrames = sim.stats.frames;
+  TEST_ASSERT_TRUE(dev.readSerialNumber(serial).ok());
+  TEST_ASSERT_EQUAL_UINT32(recoveredFrames, sim.stats.frames);
+
+  sim.security()[3] ^= 0x5AU;
+  sim.security()[7] = at21sim::Device::crc8(sim.security(), 7);
+  TEST_ASSERT_TRUE(dev.recover().ok());
+  TEST_ASSERT_TRUE(dev.readSerialNumber(serial).ok());
+  TEST_ASSERT_EQUAL_HEX8(sim.security()[3], serial.bytes[3]);
+  const uint32_t swappedFrames = sim.stats.frames;
+  TEST_ASSERT_TRUE(dev.isSecurityLocked(locked).ok());
+  TEST_ASSERT_TRUE(sim.stats.frames > swappedFrames);
+}
+
+void test_sim_write_back_cache_merges_page_writes() {
+  at21sim::Device sim;
+  Driver dev;
+  TEST_ASSERT_TRUE(beginSim(dev, sim).ok());
+
+  WriteBackCache cache;
+  WriteBackConfig policy;
+  policy.maxAgeMs = 50;
+  policy.maxDirtyPages = 0;
+  TEST_ASSERT_TRUE(cache.begin(&dev, policy).ok());
+
+  // Many field updates to one page cost one write cycle.
+  for (uint8_t i = 0; i < 20; ++i) {
+    TEST_ASSERT_TRUE(cache.writeEepromByte(0x61, i).ok());
+    TEST_ASSERT_TRUE(cache.writeEepromByte(0x63, static_cast<uint8_t>(i + 1U)).ok());
+  }
+  TEST_ASSERT_EQUAL_UINT16(1u << 12, cache.dirtyMask());
+  uint8_t buf[4] = {};
+  TEST_ASSERT_TRUE(cache.readEeprom(0x60, buf, sizeof(buf)).ok());
+  TEST_ASSERT_EQUAL_HEX8(19, buf[1]);
+  TEST_ASSERT_EQUAL_HEX8(0xFF, buf[2]);
+  TEST_ASSERT_EQUAL_HEX8(20, buf[3]);
+  TEST_ASSERT_EQUAL_UINT32(0u, sim.stats.writeCycles);
+
+  // Age policy starts the page write from tick(); the clean byte between is preserved.
+  cache.tick(at21sim::Device::nowMs(&sim));
+  TEST_ASSERT_FALSE(cache.flushing());
+  sim.advance(60000);
+  cache.tick(at21sim::Device::nowMs(&sim));
+  TEST_ASSERT_TRUE(cache.flushing());
+  for (uint16_t i = 0; i < 1000 && cache.flushing(); ++i) {
+    cache.tick(at21sim::Device::nowMs(&sim));
+  }
+  TEST_ASSERT_EQUAL_UINT16(0u, cache.dirtyMask());
+  TEST_ASSERT_EQUAL_UINT32(1u, sim.stats.writeCycles);
+  TEST_ASSERT_EQUAL_UINT32(1u, cache.stats().pageWrites);
+  TEST_ASSERT_EQUAL_UINT32(1u, cache.stats().fillReads);
+  TEST_ASSERT_EQUAL_HEX8(19, sim.eeprom()[0x61]);
+  TEST_ASSERT_EQUAL_HEX8(0xFF, sim.eeprom()[0x62]);
+  TEST_ASSERT_EQUAL_HEX8(20, sim.eeprom()[0x63]);
+
+  // flush() writes each dirty page once, spanning page boundaries.
+  uint8_t record[12];
+  std::memset(record, 0x5A, sizeof(record));
+  TEST_ASSERT_TRUE(cache.writeEeprom(0x04, record, sizeof(record)).ok());
+  TEST_ASSERT_EQUAL_UINT8(2u, cache.dirtyPages());
+  TEST_ASSERT_TRUE(cache.flush().ok());
+  TEST_ASSERT_EQUAL_UINT32(3u, sim.stats.writeCycles);
+  TEST_ASSERT_EQUAL_MEMORY(record, sim.eeprom() + 0x04, sizeof(record));
+  TEST_ASSERT_TRUE(cache.end().ok());
+}
+
+// Real time passes between calls: every clock read costs one microsecond.
+static uint32_t creepingNowMs(void* user) {
+  at21sim::Device* sim = static_cast<at21sim::Device*>(user);
+  sim->advance(1);
+  return at21sim::Device::nowMs(user);
+}
+
+void test_sim_write_back_drain_waits_out_adaptive_head() {
+  at21sim::Device sim;
+  sim.writeCycleUs = 200000;
+  Driver dev;
+  Config cfg;
+  sim.attach(cfg);
+  cfg.nowMs = creepingNowMs;
+  cfg.adaptiveWritePolling = true;
+  cfg.writeTimeoutMs = 250;
+  TEST_ASSERT_TRUE(dev.begin(cfg).ok());
+  TEST_ASSERT_TRUE(dev.writeEepromByte(0x00, 0x01).ok());
+
+  // tick() skips polls for 150 ms here: far more calls than any fixed tick
+  // budget, yet well inside writeTimeoutMs.
+  WriteBackCache cache;
+  WriteBackConfig policy;
+  policy.maxDirtyPages = 1;
+  TEST_ASSERT_TRUE(cache.begin(&dev, policy).ok());
+  TEST_ASSERT_TRUE(cache.writeEepromByte(0x21, 0xC3).ok());
+  cache.tick(dev.nowMs());
+  TEST_ASSERT_TRUE(cache.flushing());
+  uint8_t value = 0;
+  TEST_ASSERT_TRUE(cache.readEeprom(0x08, &value, 1).ok());
+  TEST_ASSERT_EQUAL_HEX8(0xC3, sim.eeprom()[0x21]);
+  TEST_ASSERT_EQUAL_UINT32(0u, cache.stats().failedFlushes);
+  TEST_ASSERT_TRUE(cache.end().ok());
+}
+
+void test_sim_counter_log_rotates_slots() {
+  at21sim::Device sim;
+  Driver dev;
+  TEST_ASSERT_TRUE(beginSim(dev, sim).ok());
+
+  // Legacy in-place block is read and migrated by the first append.
+  lcmap::CounterBlockV1 counters{};
+  counters.overloadCount = 7;
+  counters.powerCycleCount = 3;
+  lcmap::seal(counters);
+  std::memcpy(sim.eeprom() + lcmap::COUNTERS_ADDR, &counters, sizeof(counters));
+  lcmap::CounterLogState log;
+  bool valid = false;
+  TEST_ASSERT_TRUE(lcmap::readCounters(dev, counters, log, valid).ok());
+  TEST_ASSERT_TRUE(valid);
+  TEST_ASSERT_FALSE(log.hasEntry);
+
+  uint32_t cycles = sim.stats.writeCycles;
+  counters.overloadCount = 8;
+  TEST_ASSERT_TRUE(lcmap::appendCounters(dev, counters, log).ok());
+  TEST_ASSERT_EQUAL_UINT32(cycles + 4u, sim.stats.writeCycles);
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(sim.eeprom() + lcmap::COUNTER_LOG_ADDR,
+                                sim.eeprom() + lcmap::COUNTER_LOG_ADDR + lcmap::SLOT_SIZE,
+                                lcmap::SLOT_SIZE);
+
+  // Later appends alternate slots, two pages each.
+  for (uint32_t i = 0; i < 5; ++i) {
+    cycles = sim.stats.writeCycles;
+    counters.overloadCount = 9 + i;
+    counters.saturationCount = lcmap::COUNTER_LOG_MAX + 5u;
+    TEST_ASSERT_TRUE(lcmap::appendCounters(dev, counters, log).ok());
+    TEST_ASSERT_EQUAL_UINT32(cycles + 2u, sim.stats.writeCycles);
+    TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>((i + 1U) % 2U), log.newestSlot);
+  }
+
+  lcmap::CounterBlockV1 loaded{};
+  lcmap::CounterLogState fresh;
+  TEST_ASSERT_TRUE(lcmap::readCounters(dev, loaded, fresh, valid).ok());
+  TEST_ASSERT_TRUE(valid);
+  TEST_ASSERT_TRUE(lcmap::isValid(loaded));
+  TEST_ASSERT_EQUAL_UINT32(13u, loaded.overloadCount);
+  TEST_ASSERT_EQUAL_UINT32(3u, loaded.powerCycleCount);
+  TEST_ASSERT_EQUAL_UINT32(lcmap::COUNTER_LOG_MAX, loaded.saturationCount);
+  TEST_ASSERT_EQUAL_UINT8(log.seq, fresh.seq);
+
+  // A torn newest slot falls back to the previous entry.
+  sim.eeprom()[lcmap::COUNTER_LOG_ADDR + fresh.newestSlot * lcmap::COUNTER_LOG_ENTRY_SIZE + 5] ^= 0x40;
+  TEST_ASSERT_TRUE(lcmap::readCounters(dev, loaded, valid).ok());
+  TEST_ASSERT_TRUE(valid);
+  TEST_ASSERT_EQUAL_UINT32(12u, loaded.overloadCount);
+
+  // Erased and zeroed zones hold no entry.
+  std::memset(sim.eeprom() + lcmap::COUNTER_LOG_ADDR, 0xFF, lcmap::ZONE_SIZE);
+  TEST_ASSERT_TRUE(lcmap::readCounters(dev, loaded, valid).ok());
+  TEST_ASSERT_FALSE(valid);
+  std::memset(sim.eeprom() + lcmap::COUNTER_LOG_ADDR, 0x00, lcmap::ZONE_SIZE);
+  TEST_ASSERT_TRUE(lcmap::readCounters(dev, loaded, valid).ok());
+  TEST_ASSERT_FALSE(valid);
+}
+
+void test_sim_slot_migration_and_torn_pages() {
+  at21sim::Device sim;
+  Driver dev;
+  TEST_ASSERT_TRUE(beginSim(dev, sim).ok());
+
+  // Stale bytes in slot B that happen to pass the check with a higher seq.
+  uint8_t* zone = sim.eeprom() + lcmap::COUNTER_LOG_ADDR;
+  uint8_t stale[lcmap::SLOT_SIZE] = {};
+  stale[0] = 0x77;
+  stale[lcmap::SLOT_SEQ_OFFSET] = 0x40;
+  lcmap::putLe(&stale[lcmap::SLOT_CHECK_OFFSET], lcmap::slotCheck(stale), 2);
+  std::memcpy(zone + lcmap::SLOT_SIZE, stale, sizeof(stale));
+
+  // Migration writes slot A on its own, then overwrites slot B with a copy.
+  lcmap::CounterBlockV1 counters{};
+  counters.overloadCount = 1;
+  lcmap::CounterLogState log;
+  log.loaded = true;
+  TEST_ASSERT_TRUE(lcmap::appendCounters(dev, counters, log).ok());
+  TEST_ASSERT_EQUAL_UINT8(0u, log.newestSlot);
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(zone, zone + lcmap::SLOT_SIZE, lcmap::SLOT_SIZE);
+  lcmap::CounterBlockV1 loaded{};
+  bool valid = false;
+  TEST_ASSERT_TRUE(lcmap::readCounters(dev, loaded, valid).ok());
+  TEST_ASSERT_TRUE(valid);
+  TEST_ASSERT_EQUAL_UINT32(1u, loaded.overloadCount);
+
+  // Counters use all 26 bits of each field.
+  counters.overloadCount = lcmap::COUNTER_LOG_MAX;
+  counters.overTempCount = 0x02AAAAAAu;
+  counters.powerCycleCount = 0x01555555u;
+  counters.saturationCount = 0x0123456u;
+  TEST_ASSERT_TRUE(lcmap::appendCounters(dev, counters, log).ok());
+
+  // A brown-out after the first page of the next write keeps the old seq and
+  // check over a mixed payload: the slot fails its CRC and the newest entry stays.
+  uint8_t next[lcmap::SLOT_SIZE] = {};
+  lcmap::CounterBlockV1 bumped = counters;
+  bumped.overloadCount = 5;
+  lcmap::encodeCounterLogPayload(bumped, next);
+  const uint8_t target = static_cast<uint8_t>((log.newestSlot + 1U) % lcmap::SLOT_COUNT);
+  std::memcpy(zone + target * lcmap::SLOT_SIZE, next, AT21CS::cmd::PAGE_SIZE);
+  lcmap::CounterLogState fresh;
+  TEST_ASSERT_TRUE(lcmap::readCounters(dev, loaded, fresh, valid).ok());
+  TEST_ASSERT_TRUE(valid);
+  TEST_ASSERT_EQUAL_UINT8(log.newestSlot, fresh.newestSlot);
+  TEST_ASSERT_EQUAL_UINT32(lcmap::COUNTER_LOG_MAX, loaded.overloadCount);
+  TEST_ASSERT_EQUAL_UINT32(0x02AAAAAAu, loaded.overTempCount);
+  TEST_ASSERT_EQUAL_UINT32(0x01555555u, loaded.powerCycleCount);
+  TEST_ASSERT_EQUAL_UINT32(0x0123456u, loaded.saturationCount);
+}
+
+void test_sim_runtime_ab_slots_survive_torn_write() {
+  at21sim::Device sim;
+  Driver dev;
+  TEST_ASSERT_TRUE(beginSim(dev, sim).ok());
+
+  // A legacy block is decoded only while no slot is valid; slot records carry
+  // the 8-bit slot seq instead of the legacy uint32 counter.
+  lcmap::RuntimeBlockV1 runtime{};
+  runtime.seq = 0x12345u;
+  runtime.installTareRaw = -99;
+  lcmap::seal(runtime);
+  std::memcpy(sim.eeprom() + lcmap::RUNTIME_ADDR, &runtime, sizeof(runtime));
+  lcmap::RuntimeSlotState slots;
+  bool valid = false;
+  TEST_ASSERT_TRUE(lcmap::readRuntime(dev, runtime, slots, valid).ok());
+  TEST_ASSERT_TRUE(valid);
+  TEST_ASSERT_FALSE(slots.hasEntry);
+  TEST_ASSERT_EQUAL_UINT32(0x12345u, runtime.seq);
+
+  runtime.installTareRaw = -120;
+  runtime.userSpanTrimPpm = -400;
+  runtime.filterProfile = 2;
+  runtime.diagnosticsMode = 0x21;
+  TEST_ASSERT_TRUE(lcmap::writeRuntimeSlot(dev, runtime, slots).ok());
+  TEST_ASSERT_TRUE(lcmap::readRuntime(dev, runtime, valid).ok());
+  TEST_ASSERT_TRUE(valid);
+  TEST_ASSERT_EQUAL_UINT32(1u, runtime.seq);
+  TEST_ASSERT_EQUAL_UINT8(lcmap::RUNTIME_MODE_MAX, runtime.diagnosticsMode);
+  for (int32_t tare = -119; tare <= -116; ++tare) {
+    runtime.installTareRaw = tare;
+    const uint32_t cycles = sim.stats.writeCycles;
+    TEST_ASSERT_TRUE(lcmap::writeRuntimeSlot(dev, runtime, slots).ok());
+    TEST_ASSERT_EQUAL_UINT32(cycles + 2u, sim.stats.writeCycles);
+  }
+
+  // One sequential read of both slots picks the highest seq.
+  lcmap::RuntimeBlockV1 loaded{};
+  lcmap::RuntimeSlotState fresh;
+  const at21sim::Stats before = sim.stats;
+  TEST_ASSERT_TRUE(lcmap::readRuntime(dev, loaded, fresh, valid).ok());
+  TEST_ASSERT_EQUAL_UINT32(before.resets + 1u, sim.stats.resets);
+  TEST_ASSERT_EQUAL_UINT32(before.bytesOut + 32u, sim.stats.bytesOut);
+  TEST_ASSERT_TRUE(valid);
+  TEST_ASSERT_TRUE(lcmap::isValid(loaded));
+  TEST_ASSERT_EQUAL_INT32(-116, loaded.installTareRaw);
+  TEST_ASSERT_EQUAL_INT32(-400, loaded.userSpanTrimPpm);
+  TEST_ASSERT_EQUAL_UINT8(2u, loaded.filterProfile);
+  TEST_ASSERT_EQUAL_UINT8(slots.newestSlot, fresh.newestSlot);
+  TEST_ASSERT_EQUAL_UINT32(slots.seq, loaded.seq);
+
+  // A brown-out tearing the next write leaves the previous slot selected.
+  const uint8_t inactive = static_cast<uint8_t>((fresh.newestSlot + 1U) % lcmap::SLOT_COUNT);
+  uint8_t* torn = sim.eeprom() + lcmap::RUNTIME_SLOTS_ADDR + inactive * lcmap::SLOT_SIZE;
+  torn[lcmap::SLOT_SEQ_OFFSET] = static_cast<uint8_t>(fresh.seq + 1U);
+  torn[12] ^= 0x01;
+  TEST_ASSERT_TRUE(lcmap::readRuntime(dev, loaded, valid).ok());
+  TEST_ASSERT_TRUE(valid);
+  TEST_ASSERT_EQUAL_INT32(-116, loaded.installTareRaw);
 }
 
 void test_end_without_begin_keeps_uninit() {
@@ -174,6 +1774,10 @@ void test_settings_snapshot_reports_cached_state_without_io() {
   TEST_ASSERT_EQUAL_UINT32(0u, snap.totalSuccess);
   TEST_ASSERT_EQUAL_UINT32(0u, snap.totalFailures);
 
+  TEST_ASSERT_FALSE(snap.sessionActive);
+  TEST_ASSERT_EQUAL_UINT32(0u, snap.writeCycle.samples);
+  TEST_ASSERT_EQUAL_UINT32(0u, snap.writeCycle.p90Us);
+
   const SettingsSnapshot byValue = dev.getSettings();
   TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(snap.state),
                           static_cast<uint8_t>(byValue.state));
@@ -183,6 +1787,8 @@ int main() {
   UNITY_BEGIN();
   RUN_TEST(test_status_ok);
   RUN_TEST(test_status_error);
+  RUN_TEST(test_status_in_progress);
+  RUN_TEST(test_crc_engines_match_check_values);
   RUN_TEST(test_config_defaults);
   RUN_TEST(test_begin_rejects_missing_sio_pin);
   RUN_TEST(test_begin_rejects_same_presence_and_sio_pin);
@@ -193,6 +1799,40 @@ int main() {
   RUN_TEST(test_probe_requires_begin);
   RUN_TEST(test_recover_requires_begin);
   RUN_TEST(test_multi_page_write_helpers_check_initialization_first);
+  RUN_TEST(test_failed_begin_leaves_no_session);
+  RUN_TEST(test_fill_shadow_cache_requires_begin);
+  RUN_TEST(test_start_write_requires_begin);
+  RUN_TEST(test_lane_group_validates_config);
+  RUN_TEST(test_lane_group_reports_absent_lanes);
+  RUN_TEST(test_lane_group_sim_parallel_read_write);
+  RUN_TEST(test_lane_group_sim_per_lane_ack_masks);
+  RUN_TEST(test_write_scheduler_reports_failed_jobs);
+  RUN_TEST(test_write_scheduler_sim_overlaps_separate_lines);
+  RUN_TEST(test_write_scheduler_sim_serializes_shared_line);
+  RUN_TEST(test_begin_rejects_partial_line_backend);
+  RUN_TEST(test_sim_begin_detects_part_and_serial);
+  RUN_TEST(test_sim_eeprom_round_trip_and_busy_nacks);
+  RUN_TEST(test_sim_sequential_reads_use_current_address);
+  RUN_TEST(test_sim_write_if_changed_skips_matching_pages);
+  RUN_TEST(test_sim_adaptive_polling_skips_early_polls);
+  RUN_TEST(test_sim_rom_zone_lock_and_freeze);
+  RUN_TEST(test_sim_rom_zone_guard_rejects_before_bus);
+  RUN_TEST(test_sim_timing_scan_suggests_faster_profile);
+  RUN_TEST(test_sim_basic_driver_both_speeds);
+  RUN_TEST(test_sim_waveform_matches_bit_primitives);
+  RUN_TEST(test_sim_timer_phy_runs_standard_speed_from_alarms);
+  RUN_TEST(test_sim_standard_speed_and_session);
+  RUN_TEST(test_sim_shadow_and_async_write);
+  RUN_TEST(test_sim_critical_section_granularity);
+  RUN_TEST(test_sim_batch_runs_under_one_activation);
+  RUN_TEST(test_sim_stream_read_hashes_bytes_in_flight);
+  RUN_TEST(test_sim_write_verified_single_activation);
+  RUN_TEST(test_sim_identity_cache_skips_bus_until_swap);
+  RUN_TEST(test_sim_write_back_cache_merges_page_writes);
+  RUN_TEST(test_sim_write_back_drain_waits_out_adaptive_head);
+  RUN_TEST(test_sim_counter_log_rotates_slots);
+  RUN_TEST(test_sim_slot_migration_and_torn_pages);
+  RUN_TEST(test_sim_runtime_ab_slots_survive_torn_write);
   RUN_TEST(test_end_without_begin_keeps_uninit);
   RUN_TEST(test_settings_snapshot_reports_cached_state_without_io);
   return UNITY_END();